@@ -0,0 +1,105 @@
+#!/usr/bin/env bash
+# Compares clean and incremental build times of many small translation units
+# that use the library as plain headers, through a precompiled header, and
+# through the C++20 module (when the compiler can build and import it).
+#
+#   benchmarks/build_time.sh [translation-units]
+#
+# CXX selects the compiler (GCC syntax for PCH and -fmodules-ts) and CXXFLAGS
+# adds flags.
+set -euo pipefail
+
+UNITS=${1:-32}
+CXX=${CXX:-c++}
+CXXFLAGS=${CXXFLAGS:--O1}
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+HEADERS=(columnar.h csv_reader.h query.h statistics.h snapshot.h)
+
+# The same analysis body for every unit; only the way the library is reached differs.
+body() {
+    local u=$1
+    cat <<BODY
+size_t analysis_$u(const char* path) {
+    auto df = columnar::Columnar<int, double, double, double, double>::try_read_from_csv(path);
+    if (!df) {
+        return 0;
+    }
+    std::vector<columnar::Comparison> where{{"px", columnar::CompareOp::Greater, double($u)}};
+    auto selection = columnar::select_rows(*df, where);
+    auto stats = columnar::compute_statistics(*df);
+    return selection->count() + stats.columns.size();
+}
+BODY
+}
+
+mkdir -p "$WORK/headers" "$WORK/pch" "$WORK/module"
+{
+    for header in "${HEADERS[@]}"; do echo "#include \"columnar/$header\""; done
+} > "$WORK/pch/columnar_pch.h"
+
+for ((u = 0; u < UNITS; ++u)); do
+    {
+        for header in "${HEADERS[@]}"; do echo "#include \"columnar/$header\""; done
+        body "$u"
+    } > "$WORK/headers/unit_$u.cpp"
+    cp "$WORK/headers/unit_$u.cpp" "$WORK/pch/unit_$u.cpp"
+    {
+        echo '#include <cstddef>'
+        echo '#include <vector>'
+        echo 'import columnar;'
+        body "$u"
+    } > "$WORK/module/unit_$u.cpp"
+done
+
+seconds() {
+    local start end
+    start=$(date +%s.%N)
+    "$@" || return 1
+    end=$(date +%s.%N)
+    awk -v a="$start" -v b="$end" 'BEGIN { printf "%.2f", b - a }'
+}
+
+compile_units() {
+    local dir=$1
+    shift
+    for ((u = 0; u < UNITS; ++u)); do
+        "$CXX" -std=c++20 $CXXFLAGS -I"$ROOT/include" "$@" -c "$dir/unit_$u.cpp" -o "$dir/unit_$u.o"
+    done
+}
+
+report() {
+    printf '%-8s clean %8s s   one unit %6s s\n' "$1" "$2" "$3"
+}
+
+echo "$UNITS translation units, $CXX $CXXFLAGS"
+
+clean=$(seconds compile_units "$WORK/headers")
+single=$(seconds "$CXX" -std=c++20 $CXXFLAGS -I"$ROOT/include" -c "$WORK/headers/unit_0.cpp" -o "$WORK/headers/unit_0.o")
+report headers "$clean" "$single"
+
+build_pch() {
+    "$CXX" -std=c++20 $CXXFLAGS -I"$ROOT/include" -x c++-header "$WORK/pch/columnar_pch.h" -o "$WORK/pch/columnar_pch.h.gch"
+    compile_units "$WORK/pch" -include "$WORK/pch/columnar_pch.h"
+}
+clean=$(seconds build_pch)
+single=$(seconds "$CXX" -std=c++20 $CXXFLAGS -I"$ROOT/include" -include "$WORK/pch/columnar_pch.h" \
+    -c "$WORK/pch/unit_0.cpp" -o "$WORK/pch/unit_0.o")
+report pch "$clean" "$single"
+
+build_module() {
+    (cd "$WORK/module" &&
+        "$CXX" -std=c++20 $CXXFLAGS -fmodules-ts -I"$ROOT/include" -x c++ -c "$ROOT/modules/columnar.cppm" \
+            -o columnar.o &&
+        for ((u = 0; u < UNITS; ++u)); do
+            "$CXX" -std=c++20 $CXXFLAGS -fmodules-ts -c "unit_$u.cpp" -o "unit_$u.o"
+        done)
+}
+if clean=$(seconds build_module 2> "$WORK/module/errors.txt"); then
+    single=$(seconds sh -c "cd '$WORK/module' && '$CXX' -std=c++20 $CXXFLAGS -fmodules-ts -c unit_0.cpp -o unit_0.o")
+    report module "$clean" "$single"
+else
+    echo "module   not supported by $CXX: $(grep -m1 error "$WORK/module/errors.txt" || true)"
+fi
@@ -0,0 +1,89 @@
+#!/usr/bin/env bash
+# Measures compile time and binary size of a program that uses many table
+# schemas, with implicit instantiation in every translation unit and with
+# explicit instantiation (COLUMNAR_EXTERN_SCHEMA / COLUMNAR_INSTANTIATE_SCHEMA).
+#
+#   benchmarks/compile_bloat.sh [schemas] [translation-units]
+#
+# CXX selects the compiler, CXXFLAGS adds flags and COLUMNAR_INCLUDE points at
+# another include/ directory, e.g. an older checkout to compare against.
+set -euo pipefail
+
+SCHEMAS=${1:-40}
+UNITS=${2:-8}
+CXX=${CXX:-c++}
+CXXFLAGS=${CXXFLAGS:--O2}
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+INCLUDE=${COLUMNAR_INCLUDE:-$ROOT/include}
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+TYPES=(int int64_t double float std::string uint32_t int16_t)
+
+# Schema i: the first three column types spell i in base 7, so schemas are
+# distinct for i < 343; up to four more columns vary the width.
+schema() {
+    local i=$1 n=$((3 + $1 % 5)) list="" t=${#TYPES[@]}
+    for ((c = 0; c < n; ++c)); do
+        local digit=$(((i / (c < 3 ? t ** c : 1) + c) % t))
+        list+="${list:+, }${TYPES[$digit]}"
+    done
+    echo "$list"
+}
+
+{
+    echo '#pragma once'
+    echo '#include "columnar/columnar.h"'
+    echo '#include <cstdint>'
+    echo '#ifdef BLOAT_EXTERN'
+    for ((i = 0; i < SCHEMAS; ++i)); do echo "COLUMNAR_EXTERN_SCHEMA($(schema "$i"));"; done
+    echo '#endif'
+} > "$WORK/schemas.h"
+
+# Every unit reads, filters and slices every schema.
+for ((u = 0; u < UNITS; ++u)); do
+    {
+        echo '#include "schemas.h"'
+        echo "size_t unit_$u(const char* path) {"
+        echo '    size_t rows = 0;'
+        for ((i = 0; i < SCHEMAS; ++i)); do
+            echo "    if (auto t = columnar::Columnar<$(schema "$i")>::try_read_from_csv(path)) {"
+            echo "        rows += t->slice(0, 10)->num_rows() + t->take(std::vector<size_t>{0})->num_rows();"
+            echo '    }'
+        done
+        echo '    return rows;'
+        echo '}'
+    } > "$WORK/unit_$u.cpp"
+done
+
+{
+    echo '#include "schemas.h"'
+    for ((i = 0; i < SCHEMAS; ++i)); do echo "COLUMNAR_INSTANTIATE_SCHEMA($(schema "$i"));"; done
+} > "$WORK/instantiate.cpp"
+
+{
+    echo '#include <cstddef>'
+    for ((u = 0; u < UNITS; ++u)); do echo "size_t unit_$u(const char*);"; done
+    echo 'int main(int argc, char** argv) {'
+    echo '    size_t rows = 0;'
+    for ((u = 0; u < UNITS; ++u)); do echo "    rows += unit_$u(argc > 1 ? argv[1] : \"\");"; done
+    echo '    return static_cast<int>(rows % 2);'
+    echo '}'
+} > "$WORK/main.cpp"
+
+build() {
+    local name=$1 defines=$2 extra=$3
+    local start end
+    start=$(date +%s.%N)
+    for source in "$WORK"/unit_*.cpp "$WORK/main.cpp" $extra; do
+        "$CXX" -std=c++20 $CXXFLAGS $defines -I"$INCLUDE" -I"$WORK" -c "$source" -o "$source.$name.o"
+    done
+    "$CXX" "$WORK"/*."$name".o -o "$WORK/$name" -pthread
+    end=$(date +%s.%N)
+    printf '%-10s %8.2f s wall   %10s bytes text\n' "$name" "$(awk -v a="$start" -v b="$end" 'BEGIN { print b - a }')" \
+        "$(size "$WORK/$name" | awk 'NR == 2 { print $1 }')"
+}
+
+echo "$SCHEMAS schemas x $UNITS translation units, $CXX $CXXFLAGS"
+build implicit "" ""
+build explicit "-DBLOAT_EXTERN" "$WORK/instantiate.cpp"
@@ -0,0 +1,110 @@
+#include "columnar/distributed.h"
+
+#include <csignal>
+#include <iostream>
+#include <thread>
+
+#include <sys/wait.h>
+
+namespace {
+    using ParticleTable = columnar::Columnar<int, double, double, double, double>;
+
+    constexpr size_t kWorkerCount = 3;
+
+    // Runs a worker server until the coordinator terminates it.
+    [[noreturn]] void run_worker(const std::filesystem::path& socket_path) {
+        columnar::QueryServer server;
+        server.accept_tables<int, double, double, double, double>();
+        if (!server.listen(socket_path)) {
+            std::_Exit(1);
+        }
+        server.serve();
+        std::_Exit(0);
+    }
+
+    bool wait_for_socket(const std::filesystem::path& socket_path) {
+        for (int attempt = 0; attempt < 100; ++attempt) {
+            if (std::filesystem::exists(socket_path)) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return false;
+    }
+
+    int run_coordinator(const std::vector<std::filesystem::path>& sockets, const ParticleTable& table) {
+        auto coordinator = columnar::Coordinator::try_connect(sockets);
+        if (!coordinator) {
+            std::cerr << "Error: Failed to connect to the workers\n";
+            return 1;
+        }
+        auto rows = coordinator->distribute("particles", table);
+        if (!rows) {
+            std::cerr << "Error: Failed to distribute the table\n";
+            return 1;
+        }
+        std::cout << "Distributed " << *rows << " rows across " << sockets.size() << " worker processes\n";
+
+        columnar::QueryRequest request{"particles",
+                                       {{"energy", columnar::CompareOp::Greater, 10.0}},
+                                       {"particle_id"},
+                                       {{columnar::AggregateOp::Count, ""},
+                                        {columnar::AggregateOp::Mean, "energy"},
+                                        {columnar::AggregateOp::Max, "px"}}};
+        auto result = coordinator->execute(request);
+        if (!result) {
+            std::cerr << "Error: Query failed\n";
+            return 1;
+        }
+        std::cout << "energy > 10: " << result->matched_rows << " rows\n"
+                  << "  mean energy: " << result->aggregates[1] << "\n"
+                  << "  max px:      " << result->aggregates[2] << "\n"
+                  << "  particle ids:";
+        for (int64_t id : std::get<std::vector<int64_t>>(result->columns[0].values)) {
+            std::cout << ' ' << id;
+        }
+        std::cout << "\n";
+        return 0;
+    }
+}
+
+int main() {
+    std::cout << "=== Columnar Library - Distributed Query Example ===\n\n";
+
+    auto table = ParticleTable::try_read_from_csv("../tests/data/particles.csv");
+    if (!table) {
+        std::cerr << "Error: Failed to read CSV file\n";
+        return 1;
+    }
+
+    std::vector<std::filesystem::path> sockets;
+    std::vector<pid_t> workers;
+    for (size_t i = 0; i < kWorkerCount; ++i) {
+        sockets.push_back(std::filesystem::temp_directory_path() /
+                          ("columnar_example_worker_" + std::to_string(::getpid()) + "_" + std::to_string(i) + ".sock"));
+        const pid_t pid = ::fork();
+        if (pid == 0) {
+            run_worker(sockets.back());
+        }
+        workers.push_back(pid);
+    }
+
+    int status = 0;
+    for (const auto& socket_path : sockets) {
+        if (!wait_for_socket(socket_path)) {
+            std::cerr << "Error: Worker did not start\n";
+            status = 1;
+        }
+    }
+
+    if (status == 0) {
+        status = run_coordinator(sockets, *table);
+    }
+
+    for (size_t i = 0; i < workers.size(); ++i) {
+        ::kill(workers[i], SIGTERM);
+        ::waitpid(workers[i], nullptr, 0);
+        std::filesystem::remove(sockets[i]);
+    }
+    return status;
+}
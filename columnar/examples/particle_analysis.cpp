@@ -1,4 +1,5 @@
 #include "columnar/columnar.h"
+#include "columnar/math_kernels.h"
 #include <iostream>
 #include <iomanip>
 #include <cmath>
@@ -92,8 +93,10 @@ int main() {
               << std::setw(14) << "|p| (total)" << "\n";
     std::cout << std::string(kTableWidth, kHorizontalLine) << "\n";
 
+    // |p| for every row at once, with the SIMD hypot kernel
+    auto total_momentum = columnar::total_momentum(px, py, pz);
+
     for (size_t i = 0; i < df->num_rows(); ++i) {
-        double total_momentum = std::sqrt(px[i]*px[i] + py[i]*py[i] + pz[i]*pz[i]);
         auto row_result = df->get_row(i);
         if (!row_result) continue;
         auto [id, px_val, py_val, pz_val, e] = *row_result;
@@ -102,7 +105,7 @@ int main() {
                   << std::setw(12) << px_val
                   << std::setw(12) << py_val
                   << std::setw(12) << pz_val
-                  << std::setw(14) << total_momentum << "\n";
+                  << std::setw(14) << total_momentum[i] << "\n";
     }
     std::cout << "\n";
 
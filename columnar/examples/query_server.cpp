@@ -0,0 +1,60 @@
+#include "columnar/server.h"
+
+#include <csignal>
+#include <pthread.h>
+#include <iostream>
+#include <thread>
+
+namespace {
+    using ParticleTable = columnar::Columnar<int, double, double, double, double>;
+
+    constexpr const char* kDefaultSocketPath = "/tmp/columnar_particles.sock";
+
+}
+
+int main(int argc, char** argv) {
+    const std::filesystem::path socket_path = argc > 1 ? argv[1] : kDefaultSocketPath;
+
+    std::cout << "Loading ../tests/data/particles.csv...\n";
+    auto loaded = ParticleTable::try_read_from_csv("../tests/data/particles.csv");
+    if (!loaded) {
+        std::cerr << "Error: Failed to read CSV file\n";
+        return 1;
+    }
+    auto table = std::make_shared<const ParticleTable>(std::move(*loaded));
+
+    columnar::QueryServer server;
+    server.add_table("particles", table);
+    if (!server.listen(socket_path)) {
+        std::cerr << "Error: Failed to listen on " << socket_path << "\n";
+        return 1;
+    }
+
+    // Answer one query in-process so the example shows the request format.
+    columnar::QueryRequest request{"particles",
+                                   {{"energy", columnar::CompareOp::Greater, 15.0}},
+                                   {"particle_id", "energy"},
+                                   {{columnar::AggregateOp::Mean, "energy"}}};
+    if (auto result = server.execute(request)) {
+        std::cout << "energy > 15: " << result->matched_rows << " rows, mean energy "
+                  << result->aggregates[0] << "\n";
+    }
+
+    // Block the shutdown signals before any thread starts so that only
+    // sigwait() below receives them.
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    std::cout << "Serving " << table->num_rows() << " rows on " << socket_path << " (Ctrl+C to stop)\n";
+    std::thread serving([&] { server.serve(); });
+
+    int received = 0;
+    sigwait(&signals, &received);
+    server.stop();
+    serving.join();
+    std::cout << "Stopped\n";
+    return 0;
+}
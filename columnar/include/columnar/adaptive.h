@@ -0,0 +1,285 @@
+#ifndef COLUMNAR_ADAPTIVE_H
+#define COLUMNAR_ADAPTIVE_H
+
+#include "columnar/query.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <vector>
+
+namespace columnar {
+
+struct AdaptiveFilterOptions {
+    // Rows per morsel; rounded up to a multiple of 64.
+    size_t morsel_rows = 16384;
+    // Predicates are re-ranked after each of the first `warmup_morsels`
+    // morsels, then every `reorder_interval` morsels.
+    size_t warmup_morsels = 4;
+    size_t reorder_interval = 16;
+    // Below this fraction of surviving rows a morsel switches from the bitmap
+    // to a selection vector for its remaining predicates.
+    double selection_vector_threshold = 1.0 / 32.0;
+};
+
+// What a predicate has cost so far: rows it was evaluated on, rows that
+// passed and CPU time spent (wall time where thread CPU time is not
+// available).
+struct PredicateProfile {
+    uint64_t rows_in = 0;
+    uint64_t rows_out = 0;
+    uint64_t nanoseconds = 0;
+
+    [[nodiscard]] double pass_rate() const noexcept {
+        return rows_in == 0 ? 1.0 : static_cast<double>(rows_out) / static_cast<double>(rows_in);
+    }
+
+    [[nodiscard]] double cost_per_row() const noexcept {
+        return rows_in == 0 ? 0.0 : static_cast<double>(nanoseconds) / static_cast<double>(rows_in);
+    }
+};
+
+namespace detail {
+
+// CPU time of the calling thread, so that time spent descheduled is not
+// charged to whichever predicate was running. Falls back to the steady clock.
+inline uint64_t thread_cpu_nanoseconds() noexcept {
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+    timespec now{};
+    if (::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now) == 0) {
+        return static_cast<uint64_t>(now.tv_sec) * 1000000000u + static_cast<uint64_t>(now.tv_nsec);
+    }
+#endif
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+
+// Keeps the rows in `rows` (offsets from `column`) that satisfy `comparison`.
+template <typename T>
+bool filter_rows(std::span<const T> column, const Comparison& comparison, std::vector<uint32_t>& rows) {
+    return with_comparison_value<T>(comparison, [&](const auto& value) {
+        auto keep = [&](auto compare) {
+            size_t kept = 0;
+            for (uint32_t row : rows) {
+                rows[kept] = row;
+                kept += compare(column[row], value);
+            }
+            rows.resize(kept);
+        };
+        switch (comparison.op) {
+            case CompareOp::Equal:
+                keep([](const auto& a, const auto& b) { return a == b; });
+                break;
+            case CompareOp::NotEqual:
+                keep([](const auto& a, const auto& b) { return a != b; });
+                break;
+            case CompareOp::Less:
+                keep([](const auto& a, const auto& b) { return a < b; });
+                break;
+            case CompareOp::LessEqual:
+                keep([](const auto& a, const auto& b) { return a <= b; });
+                break;
+            case CompareOp::Greater:
+                keep([](const auto& a, const auto& b) { return a > b; });
+                break;
+            case CompareOp::GreaterEqual:
+                keep([](const auto& a, const auto& b) { return a >= b; });
+                break;
+            case CompareOp::StartsWith:
+            case CompareOp::EndsWith:
+            case CompareOp::Contains:
+            case CompareOp::Like:
+                if constexpr (std::is_same_v<std::decay_t<decltype(value)>, std::string>) {
+                    const StringMatcher matcher(string_match_kind(comparison.op), value);
+                    keep([&](const auto& a, const auto&) { return matcher.matches(a); });
+                }
+                break;
+        }
+    });
+}
+
+inline size_t count_bits(std::span<const uint64_t> words) noexcept {
+    size_t total = 0;
+    for (uint64_t word : words) {
+        total += static_cast<size_t>(std::popcount(word));
+    }
+    return total;
+}
+
+}
+
+// Evaluates a conjunction morsel by morsel, measuring each predicate's pass
+// rate and cost and moving the predicates that remove the most rows per
+// nanosecond to the front. Morsels whose survivors become sparse finish on a
+// selection vector instead of the bitmap. The profile persists across
+// select() calls, so repeated scans keep the learned order.
+class AdaptiveFilter {
+public:
+    explicit AdaptiveFilter(std::vector<Comparison> where, AdaptiveFilterOptions options = {})
+        : where_(std::move(where)), options_(options), order_(where_.size()), profiles_(where_.size()) {
+        std::iota(order_.begin(), order_.end(), size_t{0});
+        options_.morsel_rows = std::max<size_t>((options_.morsel_rows + 63) / 64 * 64, 64);
+    }
+
+    template <typename Table>
+    [[nodiscard]] Expected<SelectionBitmap, CsvError> select(const Table& table);
+
+    // The predicates in their current evaluation order.
+    [[nodiscard]] std::vector<Comparison> current_order() const {
+        std::vector<Comparison> ordered;
+        ordered.reserve(order_.size());
+        for (size_t index : order_) {
+            ordered.push_back(where_[index]);
+        }
+        return ordered;
+    }
+
+    // Profile of `where[index]`, in the order the predicates were given.
+    [[nodiscard]] const PredicateProfile& profile(size_t index) const { return profiles_[index]; }
+
+    [[nodiscard]] size_t bitmap_morsels() const noexcept { return bitmap_morsels_; }
+    [[nodiscard]] size_t selection_vector_morsels() const noexcept { return selection_vector_morsels_; }
+
+private:
+    template <typename Table>
+    [[nodiscard]] std::optional<CsvError> validate(const Table& table) const;
+
+    template <typename Table>
+    void filter_morsel(const Table& table, size_t begin, size_t end, uint64_t* words);
+
+    void reorder();
+
+    std::vector<Comparison> where_;
+    AdaptiveFilterOptions options_;
+    std::vector<size_t> order_;
+    std::vector<PredicateProfile> profiles_;
+    size_t morsels_{0};
+    size_t bitmap_morsels_{0};
+    size_t selection_vector_morsels_{0};
+    std::vector<uint32_t> rows_;
+};
+
+template <typename Table>
+std::optional<CsvError> AdaptiveFilter::validate(const Table& table) const {
+    for (const auto& comparison : where_) {
+        bool type_matches = true;
+        const bool found = table.visit_column(comparison.column, [&](auto column) {
+            using T = typename decltype(column)::value_type;
+            type_matches = detail::with_comparison_value<T>(comparison, [](const auto&) {});
+        });
+        if (!found) {
+            return CsvError::ColumnNotFound;
+        }
+        if (!type_matches) {
+            return CsvError::ParseError;
+        }
+    }
+    return std::nullopt;
+}
+
+template <typename Table>
+Expected<SelectionBitmap, CsvError> AdaptiveFilter::select(const Table& table) {
+    using Result = Expected<SelectionBitmap, CsvError>;
+
+    if (auto error = validate(table)) {
+        return Result(*error);
+    }
+
+    SelectionBitmap selection(table.num_rows(), true);
+    uint64_t* words = selection.words().data();
+    for (size_t begin = 0; begin < table.num_rows(); begin += options_.morsel_rows) {
+        const size_t end = std::min(begin + options_.morsel_rows, table.num_rows());
+        filter_morsel(table, begin, end, words + begin / 64);
+
+        ++morsels_;
+        if (morsels_ <= options_.warmup_morsels || morsels_ % options_.reorder_interval == 0) {
+            reorder();
+        }
+    }
+    return Result(std::move(selection));
+}
+
+template <typename Table>
+void AdaptiveFilter::filter_morsel(const Table& table, size_t begin, size_t end, uint64_t* words) {
+    const std::span<uint64_t> morsel_words(words, (end - begin + 63) / 64);
+    size_t survivors = end - begin;
+    bool sparse = false;
+
+    for (size_t index : order_) {
+        if (survivors == 0) {
+            break;
+        }
+        const Comparison& comparison = where_[index];
+        PredicateProfile& profile = profiles_[index];
+
+        if (!sparse && static_cast<double>(survivors) <
+                           options_.selection_vector_threshold * static_cast<double>(end - begin)) {
+            rows_.clear();
+            for (size_t w = 0; w < morsel_words.size(); ++w) {
+                for (uint64_t word = morsel_words[w]; word != 0; word &= word - 1) {
+                    rows_.push_back(static_cast<uint32_t>(w * 64 + static_cast<size_t>(std::countr_zero(word))));
+                }
+            }
+            sparse = true;
+        }
+
+        const uint64_t start = detail::thread_cpu_nanoseconds();
+        table.visit_column(comparison.column, [&](auto column) {
+            const auto morsel = column.subspan(begin, end - begin);
+            if (sparse) {
+                detail::filter_rows(morsel, comparison, rows_);
+            } else {
+                detail::apply_comparison(morsel, comparison, morsel_words.data());
+            }
+        });
+        const size_t passed = sparse ? rows_.size() : detail::count_bits(morsel_words);
+        const uint64_t elapsed = detail::thread_cpu_nanoseconds() - start;
+
+        profile.rows_in += survivors;
+        profile.rows_out += passed;
+        profile.nanoseconds += elapsed;
+        survivors = passed;
+    }
+
+    if (sparse) {
+        std::fill(morsel_words.begin(), morsel_words.end(), uint64_t{0});
+        for (uint32_t row : rows_) {
+            morsel_words[row / 64] |= uint64_t{1} << (row % 64);
+        }
+        ++selection_vector_morsels_;
+    } else {
+        ++bitmap_morsels_;
+    }
+}
+
+// Ascending cost / (1 - pass rate): the cheapest way to discard rows first.
+// Predicates never evaluated yet keep their place relative to each other.
+inline void AdaptiveFilter::reorder() {
+    auto rank = [&](size_t index) {
+        const auto& profile = profiles_[index];
+        if (profile.rows_in == 0) {
+            return 0.0;
+        }
+        const double removed = 1.0 - profile.pass_rate();
+        return removed > 0.0 ? (profile.cost_per_row() + 1.0) / removed : std::numeric_limits<double>::infinity();
+    };
+    std::stable_sort(order_.begin(), order_.end(), [&](size_t a, size_t b) { return rank(a) < rank(b); });
+}
+
+// Convenience wrapper for a single adaptive scan.
+template <typename Table>
+[[nodiscard]] Expected<SelectionBitmap, CsvError>
+select_rows_adaptive(const Table& table, std::span<const Comparison> where, AdaptiveFilterOptions options = {}) {
+    AdaptiveFilter filter(std::vector<Comparison>(where.begin(), where.end()), options);
+    return filter.select(table);
+}
+
+}
+
+#endif
@@ -0,0 +1,164 @@
+#ifndef COLUMNAR_ASYNC_H
+#define COLUMNAR_ASYNC_H
+
+#include "columnar/csv_reader.h"
+#include "columnar/thread_pool.h"
+
+#include <coroutine>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+namespace columnar {
+
+// Decides where a coroutine suspended on a load is resumed. The default resumes
+// it inline on the pool thread that finished the batch; event loops pass a
+// function that posts the handle to their own queue instead.
+using CoroutineResumer = std::function<void(std::coroutine_handle<>)>;
+
+// Awaitable stream of Columnar batches. Reading and parsing run on a
+// ThreadPool; while the consumer processes one batch the next one is already
+// being loaded, so awaiting `next()` never blocks the awaiting thread.
+//
+//     auto stream = AsyncCsvStream<int, double>::open("data.csv", pool, 65536);
+//     while (!stream.done()) {
+//         auto batch = co_await stream.next();
+//         if (!batch) break;
+//         ...
+//     }
+template <ColumnType... ColumnTypes>
+class AsyncCsvStream {
+    using Batch = Expected<Columnar<ColumnTypes...>, CsvError>;
+
+    struct State {
+        State(ThreadPool& pool_ref, size_t rows, CoroutineResumer resumer)
+            : pool(pool_ref), batch_rows(rows), resume(std::move(resumer)) {}
+
+        ThreadPool& pool;
+        size_t batch_rows;
+        CoroutineResumer resume;
+
+        std::optional<CsvBatchReader<ColumnTypes...>> reader;
+        std::filesystem::path path;
+
+        std::mutex mutex;
+        std::optional<Batch> ready;
+        std::coroutine_handle<> waiter;
+        bool in_flight{false};
+        bool exhausted{false};
+    };
+
+public:
+    class NextAwaiter {
+    public:
+        [[nodiscard]] bool await_ready() const {
+            std::lock_guard lock(state_->mutex);
+            return state_->ready.has_value();
+        }
+
+        bool await_suspend(std::coroutine_handle<> handle) {
+            std::lock_guard lock(state_->mutex);
+            if (state_->ready) {
+                return false;
+            }
+            state_->waiter = handle;
+            if (!state_->in_flight) {
+                start_load(state_);
+            }
+            return true;
+        }
+
+        Batch await_resume() {
+            std::lock_guard lock(state_->mutex);
+            Batch batch = std::move(*state_->ready);
+            state_->ready.reset();
+            if (!state_->exhausted) {
+                start_load(state_);
+            }
+            return batch;
+        }
+
+    private:
+        friend class AsyncCsvStream;
+
+        explicit NextAwaiter(std::shared_ptr<State> state) : state_(std::move(state)) {}
+
+        std::shared_ptr<State> state_;
+    };
+
+    [[nodiscard]] static AsyncCsvStream open(const std::filesystem::path& filepath, ThreadPool& pool,
+                                             size_t batch_rows, CoroutineResumer resumer = {});
+
+    [[nodiscard]] NextAwaiter next() { return NextAwaiter(state_); }
+
+    [[nodiscard]] bool done() const {
+        std::lock_guard lock(state_->mutex);
+        return state_->exhausted && !state_->ready && !state_->in_flight;
+    }
+
+private:
+    explicit AsyncCsvStream(std::shared_ptr<State> state) : state_(std::move(state)) {}
+
+    static void start_load(const std::shared_ptr<State>& state);
+
+    static Batch load_batch(State& state);
+
+    std::shared_ptr<State> state_;
+};
+
+template <ColumnType... ColumnTypes>
+[[nodiscard]] AsyncCsvStream<ColumnTypes...>
+AsyncCsvStream<ColumnTypes...>::open(const std::filesystem::path& filepath, ThreadPool& pool,
+                                     size_t batch_rows, CoroutineResumer resumer) {
+    if (!resumer) {
+        resumer = [](std::coroutine_handle<> handle) { handle.resume(); };
+    }
+
+    auto state = std::make_shared<State>(pool, std::max<size_t>(batch_rows, 1), std::move(resumer));
+    state->path = filepath;
+
+    std::lock_guard lock(state->mutex);
+    start_load(state);
+    return AsyncCsvStream(std::move(state));
+}
+
+template <ColumnType... ColumnTypes>
+void AsyncCsvStream<ColumnTypes...>::start_load(const std::shared_ptr<State>& state) {
+    state->in_flight = true;
+    state->pool.submit([state] {
+        Batch batch = load_batch(*state);
+
+        std::coroutine_handle<> waiter;
+        {
+            std::lock_guard lock(state->mutex);
+            if (!batch || !state->reader || state->reader->done()) {
+                state->exhausted = true;
+            }
+            state->ready.emplace(std::move(batch));
+            state->in_flight = false;
+            waiter = std::exchange(state->waiter, nullptr);
+        }
+
+        if (waiter) {
+            state->resume(waiter);
+        }
+    });
+}
+
+template <ColumnType... ColumnTypes>
+typename AsyncCsvStream<ColumnTypes...>::Batch AsyncCsvStream<ColumnTypes...>::load_batch(State& state) {
+    if (!state.reader) {
+        auto reader = CsvBatchReader<ColumnTypes...>::try_open(state.path);
+        if (!reader) {
+            return Batch(reader.error());
+        }
+        state.reader.emplace(std::move(*reader));
+    }
+    return state.reader->next_batch(state.batch_rows);
+}
+
+}
+
+#endif
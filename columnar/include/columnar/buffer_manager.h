@@ -0,0 +1,411 @@
+#ifndef COLUMNAR_BUFFER_MANAGER_H
+#define COLUMNAR_BUFFER_MANAGER_H
+
+#include "columnar/external.h"
+#include "columnar/snapshot.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace columnar {
+
+namespace detail {
+
+// A unit of memory the BufferManager can drop and bring back.
+class ManagedChunk {
+public:
+    virtual ~ManagedChunk() = default;
+
+    // Memory used while resident.
+    [[nodiscard]] virtual size_t bytes() const noexcept = 0;
+
+    // Makes the data resident again from its backing file.
+    [[nodiscard]] virtual bool load() = 0;
+
+    // Drops the data, first writing it to a spill file if it has no backing
+    // file yet.
+    [[nodiscard]] virtual bool release(const std::filesystem::path& spill_dir) = 0;
+};
+
+}
+
+// Keeps the chunks of managed tables within a memory budget. Unpinned chunks
+// are evicted with CLOCK (second chance) replacement: chunks read from a
+// snapshot are simply dropped, others are spilled to a snapshot file once and
+// dropped afterwards. Pinned chunks are never evicted, so the budget can be
+// exceeded while more chunks are pinned than it holds.
+//
+// Loads and evictions run under one mutex; concurrent scans are safe but do
+// not overlap their I/O.
+class BufferManager {
+public:
+    explicit BufferManager(size_t memory_budget_bytes,
+                           std::filesystem::path spill_dir = std::filesystem::temp_directory_path())
+        : budget_(memory_budget_bytes), spill_dir_(std::move(spill_dir)) {}
+
+    BufferManager(const BufferManager&) = delete;
+    BufferManager& operator=(const BufferManager&) = delete;
+
+    [[nodiscard]] size_t memory_budget() const noexcept { return budget_; }
+    [[nodiscard]] size_t resident_bytes() const;
+    [[nodiscard]] size_t evictions() const;
+    [[nodiscard]] size_t loads() const;
+
+    // Registers `chunk`, which is resident when `resident` is set, and returns
+    // its id. Registering resident data may evict other chunks.
+    size_t attach(detail::ManagedChunk* chunk, bool resident);
+    void detach(size_t id);
+
+    // A pinned chunk is resident until the matching unpin(). Returns false if
+    // the chunk could not be loaded.
+    [[nodiscard]] bool pin(size_t id);
+    void unpin(size_t id);
+
+    [[nodiscard]] bool resident(size_t id) const;
+
+private:
+    struct Frame {
+        detail::ManagedChunk* chunk{nullptr};
+        uint32_t pins{0};
+        bool referenced{false};
+        bool resident{false};
+    };
+
+    void evict_for(size_t incoming_bytes);
+
+    size_t budget_;
+    std::filesystem::path spill_dir_;
+    std::vector<Frame> frames_;
+    std::vector<size_t> free_ids_;
+    size_t hand_{0};
+    size_t resident_bytes_{0};
+    size_t evictions_{0};
+    size_t loads_{0};
+    mutable std::mutex mutex_;
+};
+
+inline size_t BufferManager::resident_bytes() const {
+    std::lock_guard lock(mutex_);
+    return resident_bytes_;
+}
+
+inline size_t BufferManager::evictions() const {
+    std::lock_guard lock(mutex_);
+    return evictions_;
+}
+
+inline size_t BufferManager::loads() const {
+    std::lock_guard lock(mutex_);
+    return loads_;
+}
+
+inline size_t BufferManager::attach(detail::ManagedChunk* chunk, bool resident) {
+    std::lock_guard lock(mutex_);
+    size_t id = frames_.size();
+    if (!free_ids_.empty()) {
+        id = free_ids_.back();
+        free_ids_.pop_back();
+    } else {
+        frames_.emplace_back();
+    }
+    frames_[id] = Frame{chunk, 0, false, resident};
+    if (resident) {
+        resident_bytes_ += chunk->bytes();
+        evict_for(0);
+    }
+    return id;
+}
+
+inline void BufferManager::detach(size_t id) {
+    std::lock_guard lock(mutex_);
+    if (frames_[id].resident) {
+        resident_bytes_ -= frames_[id].chunk->bytes();
+    }
+    frames_[id] = Frame{};
+    free_ids_.push_back(id);
+}
+
+inline bool BufferManager::pin(size_t id) {
+    std::lock_guard lock(mutex_);
+    Frame& frame = frames_[id];
+    ++frame.pins;
+    frame.referenced = true;
+    if (frame.resident) {
+        return true;
+    }
+
+    evict_for(frame.chunk->bytes());
+    if (!frame.chunk->load()) {
+        --frame.pins;
+        return false;
+    }
+    frame.resident = true;
+    resident_bytes_ += frame.chunk->bytes();
+    ++loads_;
+    return true;
+}
+
+inline void BufferManager::unpin(size_t id) {
+    std::lock_guard lock(mutex_);
+    --frames_[id].pins;
+}
+
+inline bool BufferManager::resident(size_t id) const {
+    std::lock_guard lock(mutex_);
+    return frames_[id].resident;
+}
+
+// Sweeps the clock hand, clearing reference bits, until enough unpinned
+// chunks are released or two full sweeps find nothing left to evict.
+inline void BufferManager::evict_for(size_t incoming_bytes) {
+    size_t idle_steps = 0;
+    while (resident_bytes_ + incoming_bytes > budget_ && !frames_.empty() && idle_steps < 2 * frames_.size()) {
+        Frame& frame = frames_[hand_];
+        hand_ = (hand_ + 1) % frames_.size();
+        ++idle_steps;
+
+        if (frame.chunk == nullptr || !frame.resident || frame.pins != 0) {
+            continue;
+        }
+        if (frame.referenced) {
+            frame.referenced = false;
+            continue;
+        }
+        if (!frame.chunk->release(spill_dir_)) {
+            continue;
+        }
+        frame.resident = false;
+        resident_bytes_ -= frame.chunk->bytes();
+        ++evictions_;
+        idle_steps = 0;
+    }
+}
+
+namespace detail {
+
+template <ColumnType... ColumnTypes>
+class TableChunk final : public ManagedChunk {
+public:
+    // A resident chunk whose data has not been written anywhere yet.
+    explicit TableChunk(Columnar<ColumnTypes...> data)
+        : bytes_(estimated_bytes(data)), data_(std::move(data)) {}
+
+    // A chunk that is read from `snapshot` on first use.
+    TableChunk(std::filesystem::path snapshot, size_t bytes) : bytes_(bytes), backing_(std::move(snapshot)) {}
+
+    [[nodiscard]] size_t bytes() const noexcept override { return bytes_; }
+
+    [[nodiscard]] bool load() override {
+        auto data = try_read_snapshot<ColumnTypes...>(backing_);
+        if (!data) {
+            return false;
+        }
+        data_ = std::move(*data);
+        return true;
+    }
+
+    [[nodiscard]] bool release(const std::filesystem::path& spill_dir) override {
+        if (backing_.empty()) {
+            SpillFile spill(spill_dir);
+            if (!write_snapshot(*data_, spill.path())) {
+                return false;
+            }
+            backing_ = spill.path();
+            spill_ = std::move(spill);
+        }
+        data_.reset();
+        return true;
+    }
+
+    [[nodiscard]] const Columnar<ColumnTypes...>& data() const noexcept { return *data_; }
+
+private:
+    size_t bytes_;
+    std::optional<Columnar<ColumnTypes...>> data_;
+    std::filesystem::path backing_;
+    std::optional<SpillFile> spill_;
+};
+
+}
+
+template <ColumnType... ColumnTypes>
+class ManagedTable;
+
+// Keeps a chunk resident for as long as it is alive.
+template <ColumnType... ColumnTypes>
+class PinnedChunk {
+public:
+    PinnedChunk(const PinnedChunk&) = delete;
+    PinnedChunk& operator=(const PinnedChunk&) = delete;
+    PinnedChunk(PinnedChunk&& other) noexcept
+        : manager_(std::exchange(other.manager_, nullptr)), id_(other.id_), table_(other.table_) {}
+    PinnedChunk& operator=(PinnedChunk&& other) noexcept {
+        if (this != &other) {
+            release();
+            manager_ = std::exchange(other.manager_, nullptr);
+            id_ = other.id_;
+            table_ = other.table_;
+        }
+        return *this;
+    }
+    ~PinnedChunk() { release(); }
+
+    [[nodiscard]] const Columnar<ColumnTypes...>& operator*() const noexcept { return *table_; }
+    [[nodiscard]] const Columnar<ColumnTypes...>* operator->() const noexcept { return table_; }
+
+private:
+    template <ColumnType...>
+    friend class ManagedTable;
+
+    PinnedChunk(BufferManager* manager, size_t id, const Columnar<ColumnTypes...>* table)
+        : manager_(manager), id_(id), table_(table) {}
+
+    void release() noexcept {
+        if (manager_ != nullptr) {
+            manager_->unpin(id_);
+            manager_ = nullptr;
+        }
+    }
+
+    BufferManager* manager_;
+    size_t id_;
+    const Columnar<ColumnTypes...>* table_;
+};
+
+// A table stored as row chunks whose residency is decided by a BufferManager.
+// Chunks are accessed through pins; the manager must outlive the table.
+template <ColumnType... ColumnTypes>
+class ManagedTable {
+public:
+    using Table = Columnar<ColumnTypes...>;
+
+    // Splits `table` into chunks of `chunk_rows` rows. Chunks beyond the
+    // budget are spilled as they are created.
+    [[nodiscard]] static ManagedTable from_table(BufferManager& manager, const Table& table, size_t chunk_rows);
+
+    // One chunk per snapshot file, loaded on first use and dropped on eviction.
+    [[nodiscard]] static Expected<ManagedTable, CsvError>
+    try_from_snapshots(BufferManager& manager, std::span<const std::filesystem::path> snapshots);
+
+    ManagedTable(const ManagedTable&) = delete;
+    ManagedTable& operator=(const ManagedTable&) = delete;
+    ManagedTable(ManagedTable&&) noexcept = default;
+    ManagedTable& operator=(ManagedTable&& other) noexcept {
+        if (this != &other) {
+            detach_all();
+            manager_ = other.manager_;
+            chunks_ = std::move(other.chunks_);
+            ids_ = std::move(other.ids_);
+            first_rows_ = std::move(other.first_rows_);
+        }
+        return *this;
+    }
+    ~ManagedTable() { detach_all(); }
+
+    [[nodiscard]] size_t chunk_count() const noexcept { return chunks_.size(); }
+    [[nodiscard]] size_t num_rows() const noexcept { return first_rows_.empty() ? 0 : first_rows_.back(); }
+    [[nodiscard]] size_t first_row(size_t chunk) const noexcept { return first_rows_[chunk]; }
+    [[nodiscard]] bool resident(size_t chunk) const { return manager_->resident(ids_[chunk]); }
+
+    [[nodiscard]] Expected<PinnedChunk<ColumnTypes...>, CsvError> pin(size_t chunk);
+
+    // Calls `fn(chunk_table, first_row)` for every chunk in order, pinning one
+    // chunk at a time. Returns the number of rows visited.
+    template <typename F>
+    [[nodiscard]] Expected<uint64_t, CsvError> scan(F&& fn);
+
+private:
+    explicit ManagedTable(BufferManager& manager) : manager_(&manager), first_rows_{0} {}
+
+    void add_chunk(std::unique_ptr<detail::TableChunk<ColumnTypes...>> chunk, size_t rows, bool resident) {
+        ids_.push_back(manager_->attach(chunk.get(), resident));
+        chunks_.push_back(std::move(chunk));
+        first_rows_.push_back(first_rows_.back() + rows);
+    }
+
+    void detach_all() noexcept {
+        for (size_t id : ids_) {
+            manager_->detach(id);
+        }
+        ids_.clear();
+        chunks_.clear();
+    }
+
+    BufferManager* manager_;
+    std::vector<std::unique_ptr<detail::TableChunk<ColumnTypes...>>> chunks_;
+    std::vector<size_t> ids_;
+    // first_rows_[i] is the first row of chunk i; the last entry is the row count.
+    std::vector<size_t> first_rows_;
+};
+
+template <ColumnType... ColumnTypes>
+ManagedTable<ColumnTypes...> ManagedTable<ColumnTypes...>::from_table(BufferManager& manager, const Table& table,
+                                                                      size_t chunk_rows) {
+    chunk_rows = std::max<size_t>(chunk_rows, 1);
+    ManagedTable managed(manager);
+    for (size_t offset = 0; offset < table.num_rows(); offset += chunk_rows) {
+        auto chunk = table.slice(offset, chunk_rows)->to_columnar();
+        const size_t rows = chunk.num_rows();
+        managed.add_chunk(std::make_unique<detail::TableChunk<ColumnTypes...>>(std::move(chunk)), rows, true);
+    }
+    return managed;
+}
+
+template <ColumnType... ColumnTypes>
+Expected<ManagedTable<ColumnTypes...>, CsvError>
+ManagedTable<ColumnTypes...>::try_from_snapshots(BufferManager& manager,
+                                                 std::span<const std::filesystem::path> snapshots) {
+    using Result = Expected<ManagedTable, CsvError>;
+
+    ManagedTable managed(manager);
+    for (const auto& path : snapshots) {
+        // Only the header and section sizes are read here; the data itself is
+        // left to the manager.
+        auto info = try_read_snapshot_info<ColumnTypes...>(path);
+        if (!info) {
+            return Result(info.error());
+        }
+        managed.add_chunk(std::make_unique<detail::TableChunk<ColumnTypes...>>(path, info->memory_bytes),
+                          info->rows, false);
+    }
+    return Result(std::move(managed));
+}
+
+template <ColumnType... ColumnTypes>
+Expected<PinnedChunk<ColumnTypes...>, CsvError> ManagedTable<ColumnTypes...>::pin(size_t chunk) {
+    using Result = Expected<PinnedChunk<ColumnTypes...>, CsvError>;
+
+    if (chunk >= chunks_.size()) {
+        return Result(CsvError::RowIndexOutOfBounds);
+    }
+    if (!manager_->pin(ids_[chunk])) {
+        return Result(CsvError::IoError);
+    }
+    return Result(PinnedChunk<ColumnTypes...>(manager_, ids_[chunk], &chunks_[chunk]->data()));
+}
+
+template <ColumnType... ColumnTypes>
+template <typename F>
+Expected<uint64_t, CsvError> ManagedTable<ColumnTypes...>::scan(F&& fn) {
+    using Result = Expected<uint64_t, CsvError>;
+
+    uint64_t rows = 0;
+    for (size_t chunk = 0; chunk < chunks_.size(); ++chunk) {
+        auto pinned = pin(chunk);
+        if (!pinned) {
+            return Result(pinned.error());
+        }
+        fn(**pinned, first_rows_[chunk]);
+        rows += (*pinned)->num_rows();
+    }
+    return Result(rows);
+}
+
+}
+
+#endif
@@ -3,12 +3,13 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <charconv>
 #include <concepts>
 #include <filesystem>
 #include <fstream>
 #include <functional>
-#include <sstream>
+#include <optional>
 #include <span>
 #include <string>
 #include <string_view>
@@ -17,6 +18,10 @@
 #include <vector>
 #include <cstdlib>
 #include <cerrno>
+#include <cctype>
+#include <cstdint>
+
+#include "columnar/gather.h"
 
 namespace columnar {
 
@@ -25,7 +30,8 @@ enum class CsvError {
     ParseError,
     InvalidFormat,
     ColumnNotFound,
-    RowIndexOutOfBounds
+    RowIndexOutOfBounds,
+    IoError
 };
 
 template <typename T, typename E>
@@ -56,9 +62,269 @@ public:
     E& error() & { return std::get<E>(data_); }
 };
 
+namespace detail {
+
+// Identifies the contents of a table for result caching. Copies share the
+// value; a mutation or a move-from only clears it, and a fresh value is drawn
+// from a global counter the next time it is read, so hot append paths never
+// touch shared state.
+class TableGeneration {
+public:
+    TableGeneration() noexcept = default;
+    TableGeneration(const TableGeneration& other) noexcept : value_(other.value_.load(std::memory_order_relaxed)) {}
+    TableGeneration(TableGeneration&& other) noexcept : value_(other.value_.exchange(0, std::memory_order_relaxed)) {}
+
+    TableGeneration& operator=(const TableGeneration& other) noexcept {
+        value_.store(other.value_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        return *this;
+    }
+    TableGeneration& operator=(TableGeneration&& other) noexcept {
+        value_.store(other.value_.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+        return *this;
+    }
+
+    void invalidate() noexcept { value_.store(0, std::memory_order_relaxed); }
+
+    [[nodiscard]] uint64_t value() const noexcept {
+        uint64_t current = value_.load(std::memory_order_relaxed);
+        if (current == 0) {
+            static std::atomic<uint64_t> counter{0};
+            const uint64_t fresh = counter.fetch_add(1, std::memory_order_relaxed) + 1;
+            if (value_.compare_exchange_strong(current, fresh, std::memory_order_relaxed)) {
+                current = fresh;
+            }
+        }
+        return current;
+    }
+
+private:
+    mutable std::atomic<uint64_t> value_{0};
+};
+
+// Element-type kernels. Columnar<ColumnTypes...> only dispatches to these, so
+// each is instantiated once per element type instead of once per schema.
+
+template <typename T>
+requires(std::integral<T>)
+Expected<T, CsvError> parse_field(std::string_view str) noexcept {
+    T value{};
+    auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+
+    if (ec != std::errc{} || ptr != str.data() + str.size()) {
+        return Expected<T, CsvError>(CsvError::ParseError);
+    }
+    return Expected<T, CsvError>(value);
+}
+
+template <typename T>
+requires(std::floating_point<T>)
+Expected<T, CsvError> parse_field(std::string_view str) noexcept {
+    T value{};
+    std::string str_copy(str);
+    char* end = nullptr;
+
+    errno = 0;
+
+    if constexpr (std::is_same_v<T, double>) {
+        value = std::strtod(str_copy.c_str(), &end);
+    } else if constexpr (std::is_same_v<T, float>) {
+        value = std::strtof(str_copy.c_str(), &end);
+    } else {
+        value = std::strtold(str_copy.c_str(), &end);
+    }
+
+    if (end == str_copy.c_str() || *end != '\0') {
+        return Expected<T, CsvError>(CsvError::ParseError);
+    }
+    if (errno == ERANGE) {
+        return Expected<T, CsvError>(CsvError::ParseError);
+    }
+
+    return Expected<T, CsvError>(value);
+}
+
+template <typename T>
+requires(std::same_as<T, std::string>)
+Expected<T, CsvError> parse_field(std::string_view str) noexcept {
+    return Expected<T, CsvError>(std::string(str));
+}
+
+// Parses the field of `line` that starts at `pos` onto `column` and moves
+// `pos` past the following delimiter. On a missing or malformed field
+// returns false and leaves `column` unchanged.
+template <typename T>
+bool append_csv_field(std::vector<T>& column, std::string_view line, size_t& pos, char delimiter) {
+    if (pos >= line.size()) {
+        return false;
+    }
+
+    size_t end = line.find(delimiter, pos);
+    if (end == std::string_view::npos) {
+        end = line.size();
+    }
+
+    auto parsed = parse_field<T>(line.substr(pos, end - pos));
+    pos = end + 1;
+    if (!parsed) {
+        return false;
+    }
+
+    column.push_back(std::move(*parsed));
+    return true;
+}
+
+// Like append_csv_field, but parses into `value`. Strings reuse the
+// capacity of `value`, so a row buffer parsed line after line stops
+// allocating once it has seen the longest field.
+template <typename T>
+bool assign_csv_field(T& value, std::string_view line, size_t& pos, char delimiter) {
+    if (pos >= line.size()) {
+        return false;
+    }
+
+    size_t end = line.find(delimiter, pos);
+    if (end == std::string_view::npos) {
+        end = line.size();
+    }
+
+    const auto field = line.substr(pos, end - pos);
+    pos = end + 1;
+    if constexpr (std::is_same_v<T, std::string>) {
+        value.assign(field);
+    } else {
+        auto parsed = parse_field<T>(field);
+        if (!parsed) {
+            return false;
+        }
+        value = *parsed;
+    }
+    return true;
+}
+
+inline bool has_trailing_data(std::string_view line, size_t pos) noexcept {
+    if (pos >= line.size()) {
+        return false;
+    }
+    auto rest = line.substr(pos);
+    return std::any_of(rest.begin(), rest.end(), [](unsigned char c) { return !std::isspace(c); });
+}
+
+// Splits a header line into exactly `names.size()` column names.
+inline bool parse_csv_header(std::string_view line, std::span<std::string> names, char delimiter) {
+    size_t col_idx = 0;
+    size_t pos = 0;
+
+    while (pos < line.size()) {
+        if (col_idx >= names.size()) {
+            return false;
+        }
+        size_t end = line.find(delimiter, pos);
+        if (end == std::string_view::npos) {
+            end = line.size();
+        }
+        names[col_idx++] = std::string(line.substr(pos, end - pos));
+        pos = end + 1;
+    }
+    return col_idx == names.size();
+}
+
+// Feeds the header and then every non-empty line of a CSV file to the
+// callbacks, stopping at the first failure.
+inline std::optional<CsvError> read_csv_lines(const std::filesystem::path& filepath,
+                                              const std::function<bool(std::string_view)>& on_header,
+                                              const std::function<bool(std::string_view)>& on_row) {
+    std::ifstream file(filepath);
+    if (!file.is_open()) {
+        return CsvError::FileNotFound;
+    }
+
+    std::string line;
+    if (!std::getline(file, line) || line.empty() || !on_header(line)) {
+        return CsvError::InvalidFormat;
+    }
+
+    while (std::getline(file, line)) {
+        if (line.empty()) continue;
+
+        if (!on_row(line)) {
+            return CsvError::ParseError;
+        }
+    }
+    return std::nullopt;
+}
+
+// Index of `name` in `names`, or names.size() if absent.
+inline size_t find_column(std::span<const std::string> names, std::string_view name) noexcept {
+    return static_cast<size_t>(std::find(names.begin(), names.end(), name) - names.begin());
+}
+
+template <typename T>
+std::vector<size_t> select_indices(std::span<const T> column, const std::function<bool(T)>& predicate) {
+    std::vector<size_t> indices;
+    indices.reserve(column.size());
+    for (size_t i = 0; i < column.size(); ++i) {
+        if (predicate(column[i])) {
+            indices.push_back(i);
+        }
+    }
+    return indices;
+}
+
+}
+
 template <typename T>
 concept ColumnType = std::integral<T> || std::floating_point<T> || std::same_as<T, std::string>;
 
+template <ColumnType... ColumnTypes>
+class Columnar;
+
+template <ColumnType... ColumnTypes>
+class ColumnarView {
+    static constexpr size_t kColumnCount = sizeof...(ColumnTypes);
+
+    std::tuple<std::span<const ColumnTypes>...> columns_;
+    const std::array<std::string, kColumnCount>* names_{nullptr};
+    size_t row_count_{0};
+
+    friend class Columnar<ColumnTypes...>;
+
+    ColumnarView(std::tuple<std::span<const ColumnTypes>...> columns,
+                 const std::array<std::string, kColumnCount>* names, size_t row_count)
+        : columns_(std::move(columns)), names_(names), row_count_(row_count) {}
+
+public:
+    template <size_t I>
+    [[nodiscard]] auto get_column_view() const
+        -> std::span<const std::tuple_element_t<I, std::tuple<ColumnTypes...>>>;
+
+    template <typename T>
+    [[nodiscard]] Expected<std::span<const T>, CsvError>
+    get_column_view(const std::string& name) const;
+
+    [[nodiscard]] Expected<std::tuple<ColumnTypes...>, CsvError>
+    get_row(size_t index) const;
+
+    [[nodiscard]] Expected<ColumnarView<ColumnTypes...>, CsvError>
+    slice(size_t offset, size_t length) const;
+
+    [[nodiscard]] Expected<Columnar<ColumnTypes...>, CsvError>
+    take(std::span<const size_t> indices) const;
+
+    [[nodiscard]] Columnar<ColumnTypes...> to_columnar() const;
+
+    // Calls fn(std::span<const T>) with the column named `name`. Returns false
+    // when there is no such column.
+    template <typename F>
+    bool visit_column(std::string_view name, F&& fn) const;
+
+    [[nodiscard]] size_t num_rows() const noexcept { return row_count_; }
+
+    [[nodiscard]] constexpr size_t num_cols() const noexcept { return kColumnCount; }
+
+    [[nodiscard]] std::span<const std::string, kColumnCount>
+    column_names() const noexcept { return std::span{*names_}; }
+};
+
 template <ColumnType... ColumnTypes>
 class Columnar {
     static constexpr size_t kColumnCount = sizeof...(ColumnTypes);
@@ -67,11 +333,25 @@ class Columnar {
     std::tuple<std::vector<ColumnTypes>...> columns_;
     std::array<std::string, kColumnCount> names_;
     size_t row_count_{0};
+    detail::TableGeneration generation_;
+
+    friend class ColumnarView<ColumnTypes...>;
 
 public:
+    Columnar() = default;
+    explicit Columnar(std::array<std::string, kColumnCount> names) : names_(std::move(names)) {}
+
     [[nodiscard]] static Expected<Columnar<ColumnTypes...>, CsvError>
     try_read_from_csv(const std::filesystem::path& filepath) noexcept;
 
+    [[nodiscard]] static Expected<std::array<std::string, kColumnCount>, CsvError>
+    try_parse_csv_header(std::string_view line);
+
+    [[nodiscard]] static Expected<Columnar<ColumnTypes...>, CsvError>
+    from_columns(std::array<std::string, kColumnCount> names, std::vector<ColumnTypes>... columns);
+
+    [[nodiscard]] bool try_append_csv_row(std::string_view line);
+
     template <size_t I>
     [[nodiscard]] auto get_column_view() const
         -> std::span<const std::tuple_element_t<I, std::tuple<ColumnTypes...>>>;
@@ -87,132 +367,98 @@ public:
     [[nodiscard]] Expected<Columnar<ColumnTypes...>, CsvError>
     filter(const std::string& column_name, std::function<bool(T)> predicate) const;
 
-    [[nodiscard]] size_t num_rows() const noexcept { return row_count_; }
+    [[nodiscard]] ColumnarView<ColumnTypes...> view() const noexcept;
 
-    [[nodiscard]] constexpr size_t num_cols() const noexcept { return kColumnCount; }
+    [[nodiscard]] Expected<ColumnarView<ColumnTypes...>, CsvError>
+    slice(size_t offset, size_t length) const;
 
-    [[nodiscard]] std::span<const std::string, kColumnCount>
-    column_names() const noexcept;
+    [[nodiscard]] Expected<Columnar<ColumnTypes...>, CsvError>
+    take(std::span<const size_t> indices) const;
 
-private:
-    template <typename T>
-    requires(std::integral<T>)
-    static Expected<T, CsvError> parse_value(std::string_view str) noexcept {
-        T value{};
-        auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+    void append_row(ColumnTypes... values);
 
-        if (ec != std::errc{} || ptr != str.data() + str.size()) {
-            return Expected<T, CsvError>(CsvError::ParseError);
-        }
-        return Expected<T, CsvError>(value);
-    }
+    void append(const Columnar<ColumnTypes...>& other);
 
-    template <typename T>
-    requires(std::floating_point<T>)
-    static Expected<T, CsvError> parse_value(std::string_view str) noexcept {
-        T value{};
-        std::string str_copy(str);
-        char* end = nullptr;
-
-        errno = 0;
-
-        if constexpr (std::is_same_v<T, double>) {
-            value = std::strtod(str_copy.c_str(), &end);
-        } else if constexpr (std::is_same_v<T, float>) {
-            value = std::strtof(str_copy.c_str(), &end);
-        } else {
-            value = std::strtold(str_copy.c_str(), &end);
-        }
+    void reserve(size_t rows);
 
-        if (end == str_copy.c_str() || *end != '\0') {
-            return Expected<T, CsvError>(CsvError::ParseError);
-        }
-        if (errno == ERANGE) {
-            return Expected<T, CsvError>(CsvError::ParseError);
-        }
+    void clear() noexcept;
 
-        return Expected<T, CsvError>(value);
-    }
+    template <typename F>
+    bool visit_column(std::string_view name, F&& fn) const;
 
-    template <typename T>
-    requires(std::same_as<T, std::string>)
-    static Expected<T, CsvError> parse_value(std::string_view str) noexcept {
-        return Expected<T, CsvError>(std::string(str));
-    }
+    [[nodiscard]] uint64_t generation() const noexcept { return generation_.value(); }
+
+    [[nodiscard]] size_t num_rows() const noexcept { return row_count_; }
+
+    [[nodiscard]] constexpr size_t num_cols() const noexcept { return kColumnCount; }
+
+    [[nodiscard]] std::span<const std::string, kColumnCount>
+    column_names() const noexcept;
 };
 
 template <ColumnType... ColumnTypes>
 [[nodiscard]] Expected<Columnar<ColumnTypes...>, CsvError>
 Columnar<ColumnTypes...>::try_read_from_csv(const std::filesystem::path& filepath) noexcept {
-    std::ifstream file(filepath);
-    if (!file.is_open()) {
-        return Expected<Columnar<ColumnTypes...>, CsvError>(CsvError::FileNotFound);
+    Columnar<ColumnTypes...> result;
+    auto error = detail::read_csv_lines(
+        filepath,
+        [&](std::string_view header) { return detail::parse_csv_header(header, result.names_, kCsvDelimiter); },
+        [&](std::string_view line) { return result.try_append_csv_row(line); });
+    if (error) {
+        return Expected<Columnar<ColumnTypes...>, CsvError>(*error);
     }
 
-    Columnar<ColumnTypes...> result;
-    std::string line;
+    return Expected<Columnar<ColumnTypes...>, CsvError>(std::move(result));
+}
 
-    if (!std::getline(file, line) || line.empty()) {
+template <ColumnType... ColumnTypes>
+[[nodiscard]] Expected<Columnar<ColumnTypes...>, CsvError>
+Columnar<ColumnTypes...>::from_columns(std::array<std::string, kColumnCount> names,
+                                       std::vector<ColumnTypes>... columns) {
+    const std::array<size_t, kColumnCount> sizes{columns.size()...};
+    const size_t rows = kColumnCount == 0 ? 0 : sizes[0];
+    if (std::any_of(sizes.begin(), sizes.end(), [rows](size_t size) { return size != rows; })) {
         return Expected<Columnar<ColumnTypes...>, CsvError>(CsvError::InvalidFormat);
     }
 
-    {
-        std::istringstream header_stream(line);
-        std::string name;
-        size_t col_idx = 0;
+    Columnar<ColumnTypes...> result(std::move(names));
+    result.columns_ = std::make_tuple(std::move(columns)...);
+    result.row_count_ = rows;
+    return Expected<Columnar<ColumnTypes...>, CsvError>(std::move(result));
+}
 
-        while (std::getline(header_stream, name, kCsvDelimiter)) {
-            if (col_idx >= kColumnCount) {
-                return Expected<Columnar<ColumnTypes...>, CsvError>(CsvError::InvalidFormat);
-            }
-            result.names_[col_idx++] = std::move(name);
-        }
+template <ColumnType... ColumnTypes>
+[[nodiscard]] Expected<std::array<std::string, Columnar<ColumnTypes...>::kColumnCount>, CsvError>
+Columnar<ColumnTypes...>::try_parse_csv_header(std::string_view line) {
+    using Result = Expected<std::array<std::string, kColumnCount>, CsvError>;
 
-        if (col_idx != kColumnCount) {
-            return Expected<Columnar<ColumnTypes...>, CsvError>(CsvError::InvalidFormat);
-        }
+    std::array<std::string, kColumnCount> names;
+    if (!detail::parse_csv_header(line, names, kCsvDelimiter)) {
+        return Result(CsvError::InvalidFormat);
     }
+    return Result(std::move(names));
+}
 
-    while (std::getline(file, line)) {
-        if(line.empty()) continue;
-
-        std::istringstream row_stream(line);
-        std::string value_str;
-
-        bool parse_success = [&]<size_t... Is>(std::index_sequence<Is...>) -> bool {
-            bool success = true;
-
-            ((success = success && [&]() -> bool {
-                using T = std::tuple_element_t<Is, std::tuple<ColumnTypes...>>;
-
-                if (!std::getline(row_stream, value_str, kCsvDelimiter)) {
-                    return false;
-                }
-
-                auto parsed = parse_value<T>(value_str);
-                if (!parsed) {
-                    return false;
-                }
-
-                std::get<Is>(result.columns_).push_back(std::move(*parsed));
-                return true;
-            }()), ...);
+template <ColumnType... ColumnTypes>
+[[nodiscard]] bool Columnar<ColumnTypes...>::try_append_csv_row(std::string_view line) {
+    size_t pos = 0;
+    size_t parsed_columns = 0;
 
-            if (row_stream >> value_str) {
-                 return false;
-            }
+    bool parse_success = [&]<size_t... Is>(std::index_sequence<Is...>) {
+        return ((detail::append_csv_field(std::get<Is>(columns_), line, pos, kCsvDelimiter) && ++parsed_columns) &&
+                ...);
+    }(std::make_index_sequence<kColumnCount>{});
 
-            return success;
+    if (!parse_success || detail::has_trailing_data(line, pos)) {
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+            ((Is < parsed_columns ? std::get<Is>(columns_).pop_back() : void()), ...);
         }(std::make_index_sequence<kColumnCount>{});
-
-        if (!parse_success) {
-            return Expected<Columnar<ColumnTypes...>, CsvError>(CsvError::ParseError);
-        }
-
-        ++result.row_count_;
+        return false;
     }
 
-    return Expected<Columnar<ColumnTypes...>, CsvError>(result);
+    ++row_count_;
+    generation_.invalidate();
+    return true;
 }
 
 template <ColumnType... ColumnTypes>
@@ -228,14 +474,12 @@ template <ColumnType... ColumnTypes>
 template <typename T>
 [[nodiscard]] Expected<std::span<const T>, CsvError>
 Columnar<ColumnTypes...>::get_column_view(const std::string& name) const {
-    auto it = std::find(names_.begin(), names_.end(), name);
+    const size_t index = detail::find_column(names_, name);
 
-    if (it == names_.end()) {
+    if (index == kColumnCount) {
         return Expected<std::span<const T>, CsvError>(CsvError::ColumnNotFound);
     }
 
-    size_t index = std::distance(names_.begin(), it);
-
     Expected<std::span<const T>, CsvError> result(CsvError::ColumnNotFound);
 
     [&]<size_t... Is>(std::index_sequence<Is...>) {
@@ -277,16 +521,7 @@ Columnar<ColumnTypes...>::filter(const std::string& column_name,
     if (!column_view_result) {
         return Expected<Columnar<ColumnTypes...>, CsvError>(column_view_result.error());
     }
-    auto column_to_filter = *column_view_result;
-
-    std::vector<size_t> indices_to_keep;
-    indices_to_keep.reserve(row_count_);
-
-    for (size_t i = 0; i < row_count_; ++i) {
-        if (predicate(column_to_filter[i])) {
-            indices_to_keep.push_back(i);
-        }
-    }
+    const auto indices_to_keep = detail::select_indices(*column_view_result, predicate);
 
     Columnar<ColumnTypes...> result;
     result.names_ = names_;
@@ -294,17 +529,176 @@ Columnar<ColumnTypes...>::filter(const std::string& column_name,
 
     [&]<size_t... Is>(std::index_sequence<Is...>) {
         (([&] {
-            auto& src_column = std::get<Is>(columns_);
-            auto& dst_column = std::get<Is>(result.columns_);
-            dst_column.reserve(indices_to_keep.size());
+            gather_into(std::span{std::get<Is>(columns_)}, std::span<const size_t>{indices_to_keep},
+                        std::get<Is>(result.columns_));
+        }()), ...);
+    }(std::make_index_sequence<kColumnCount>{});
+
+    return Expected<Columnar<ColumnTypes...>, CsvError>(std::move(result));
+}
+
+template <ColumnType... ColumnTypes>
+[[nodiscard]] ColumnarView<ColumnTypes...> Columnar<ColumnTypes...>::view() const noexcept {
+    auto spans = std::apply([](const auto&... columns) { return std::make_tuple(std::span{columns}...); }, columns_);
+    return ColumnarView<ColumnTypes...>(spans, &names_, row_count_);
+}
+
+template <ColumnType... ColumnTypes>
+[[nodiscard]] Expected<ColumnarView<ColumnTypes...>, CsvError>
+Columnar<ColumnTypes...>::slice(size_t offset, size_t length) const {
+    return view().slice(offset, length);
+}
+
+template <ColumnType... ColumnTypes>
+[[nodiscard]] Expected<Columnar<ColumnTypes...>, CsvError>
+Columnar<ColumnTypes...>::take(std::span<const size_t> indices) const {
+    return view().take(indices);
+}
 
-            for (size_t idx : indices_to_keep) {
-                dst_column.push_back(src_column[idx]);
+template <ColumnType... ColumnTypes>
+template <size_t I>
+[[nodiscard]] auto ColumnarView<ColumnTypes...>::get_column_view() const
+    -> std::span<const std::tuple_element_t<I, std::tuple<ColumnTypes...>>> {
+    static_assert(I < kColumnCount, "Column index out of bounds");
+    return std::get<I>(columns_);
+}
+
+template <ColumnType... ColumnTypes>
+template <typename T>
+[[nodiscard]] Expected<std::span<const T>, CsvError>
+ColumnarView<ColumnTypes...>::get_column_view(const std::string& name) const {
+    const size_t index = detail::find_column(*names_, name);
+
+    if (index == kColumnCount) {
+        return Expected<std::span<const T>, CsvError>(CsvError::ColumnNotFound);
+    }
+
+    Expected<std::span<const T>, CsvError> result(CsvError::ParseError);
+
+    [&]<size_t... Is>(std::index_sequence<Is...>) {
+        (void)((Is == index ? [&] {
+            using ColumnT = std::tuple_element_t<Is, std::tuple<ColumnTypes...>>;
+            if constexpr (std::is_same_v<T, ColumnT>) {
+                result = Expected<std::span<const T>, CsvError>(get_column_view<Is>());
             }
+        }(), true : false) || ...);
+    }(std::make_index_sequence<kColumnCount>{});
+
+    return result;
+}
+
+template <ColumnType... ColumnTypes>
+[[nodiscard]] Expected<std::tuple<ColumnTypes...>, CsvError>
+ColumnarView<ColumnTypes...>::get_row(size_t index) const {
+    if (index >= row_count_) {
+        return Expected<std::tuple<ColumnTypes...>, CsvError>(CsvError::RowIndexOutOfBounds);
+    }
+
+    auto row_tuple = std::apply([index](const auto&... columns) {
+        return std::make_tuple(columns[index]...);
+    }, columns_);
+
+    return Expected<std::tuple<ColumnTypes...>, CsvError>(row_tuple);
+}
+
+template <ColumnType... ColumnTypes>
+[[nodiscard]] Expected<ColumnarView<ColumnTypes...>, CsvError>
+ColumnarView<ColumnTypes...>::slice(size_t offset, size_t length) const {
+    if (offset > row_count_) {
+        return Expected<ColumnarView<ColumnTypes...>, CsvError>(CsvError::RowIndexOutOfBounds);
+    }
+    length = std::min(length, row_count_ - offset);
+
+    auto spans = std::apply([offset, length](const auto&... columns) {
+        return std::make_tuple(columns.subspan(offset, length)...);
+    }, columns_);
+
+    return Expected<ColumnarView<ColumnTypes...>, CsvError>(ColumnarView(spans, names_, length));
+}
+
+template <ColumnType... ColumnTypes>
+[[nodiscard]] Expected<Columnar<ColumnTypes...>, CsvError>
+ColumnarView<ColumnTypes...>::take(std::span<const size_t> indices) const {
+    for (size_t index : indices) {
+        if (index >= row_count_) {
+            return Expected<Columnar<ColumnTypes...>, CsvError>(CsvError::RowIndexOutOfBounds);
+        }
+    }
+
+    Columnar<ColumnTypes...> result(*names_);
+    result.row_count_ = indices.size();
+
+    [&]<size_t... Is>(std::index_sequence<Is...>) {
+        (gather_into(std::get<Is>(columns_), indices, std::get<Is>(result.columns_)), ...);
+    }(std::make_index_sequence<kColumnCount>{});
+
+    return Expected<Columnar<ColumnTypes...>, CsvError>(std::move(result));
+}
+
+template <ColumnType... ColumnTypes>
+[[nodiscard]] Columnar<ColumnTypes...> ColumnarView<ColumnTypes...>::to_columnar() const {
+    Columnar<ColumnTypes...> result(*names_);
+    result.row_count_ = row_count_;
+
+    [&]<size_t... Is>(std::index_sequence<Is...>) {
+        (std::get<Is>(result.columns_).assign(std::get<Is>(columns_).begin(), std::get<Is>(columns_).end()), ...);
+    }(std::make_index_sequence<kColumnCount>{});
+
+    return result;
+}
+
+template <ColumnType... ColumnTypes>
+template <typename F>
+bool ColumnarView<ColumnTypes...>::visit_column(std::string_view name, F&& fn) const {
+    const size_t index = detail::find_column(*names_, name);
+    if (index == kColumnCount) {
+        return false;
+    }
+
+    [&]<size_t... Is>(std::index_sequence<Is...>) {
+        (void)((Is == index ? (fn(std::get<Is>(columns_)), true) : false) || ...);
+    }(std::make_index_sequence<kColumnCount>{});
+    return true;
+}
+
+template <ColumnType... ColumnTypes>
+template <typename F>
+bool Columnar<ColumnTypes...>::visit_column(std::string_view name, F&& fn) const {
+    return view().visit_column(name, std::forward<F>(fn));
+}
+
+template <ColumnType... ColumnTypes>
+void Columnar<ColumnTypes...>::append_row(ColumnTypes... values) {
+    [&]<size_t... Is>(std::index_sequence<Is...>) {
+        (std::get<Is>(columns_).push_back(std::move(values)), ...);
+    }(std::make_index_sequence<kColumnCount>{});
+    ++row_count_;
+    generation_.invalidate();
+}
+
+template <ColumnType... ColumnTypes>
+void Columnar<ColumnTypes...>::append(const Columnar<ColumnTypes...>& other) {
+    [&]<size_t... Is>(std::index_sequence<Is...>) {
+        (([&] {
+            auto& dst_column = std::get<Is>(columns_);
+            const auto& src_column = std::get<Is>(other.columns_);
+            dst_column.insert(dst_column.end(), src_column.begin(), src_column.end());
         }()), ...);
     }(std::make_index_sequence<kColumnCount>{});
+    row_count_ += other.row_count_;
+    generation_.invalidate();
+}
+
+template <ColumnType... ColumnTypes>
+void Columnar<ColumnTypes...>::reserve(size_t rows) {
+    std::apply([rows](auto&... columns) { (columns.reserve(rows), ...); }, columns_);
+}
 
-    return Expected<Columnar<ColumnTypes...>, CsvError>(result);
+template <ColumnType... ColumnTypes>
+void Columnar<ColumnTypes...>::clear() noexcept {
+    std::apply([](auto&... columns) { (columns.clear(), ...); }, columns_);
+    row_count_ = 0;
+    generation_.invalidate();
 }
 
 template <ColumnType... ColumnTypes>
@@ -315,4 +709,17 @@ Columnar<ColumnTypes...>::column_names() const noexcept {
 
 }
 
+// Explicit instantiation of a schema. Declare it with
+// COLUMNAR_EXTERN_SCHEMA(int, double, ...) in a shared header and define it
+// with COLUMNAR_INSTANTIATE_SCHEMA(int, double, ...) in exactly one source
+// file; other translation units then link against that one copy of the
+// table's members instead of compiling their own. Use at global scope.
+#define COLUMNAR_EXTERN_SCHEMA(...)                                   \
+    extern template class columnar::Columnar<__VA_ARGS__>;           \
+    extern template class columnar::ColumnarView<__VA_ARGS__>
+
+#define COLUMNAR_INSTANTIATE_SCHEMA(...)                              \
+    template class columnar::Columnar<__VA_ARGS__>;                  \
+    template class columnar::ColumnarView<__VA_ARGS__>
+
 #endif
\ No newline at end of file
@@ -0,0 +1,338 @@
+#ifndef COLUMNAR_CORRELATION_H
+#define COLUMNAR_CORRELATION_H
+
+#include "columnar/cpu.h"
+#include "columnar/query.h"
+#include "columnar/thread_pool.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace columnar {
+
+namespace detail {
+
+inline double dot_scalar(const double* a, const double* b, size_t count) noexcept {
+    double sums[4] = {0.0, 0.0, 0.0, 0.0};
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        for (size_t lane = 0; lane < 4; ++lane) {
+            sums[lane] += a[i + lane] * b[i + lane];
+        }
+    }
+    for (; i < count; ++i) {
+        sums[0] += a[i] * b[i];
+    }
+    return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+}
+
+#if COLUMNAR_HAS_AVX512_KERNELS
+COLUMNAR_TARGET_AVX512 inline double dot_avx512(const double* a, const double* b, size_t count) noexcept {
+    __m512d sum = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        sum = _mm512_add_pd(sum, _mm512_mul_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+    }
+    return _mm512_reduce_add_pd(sum) + dot_scalar(a + i, b + i, count - i);
+}
+#endif
+
+#if COLUMNAR_HAS_AVX2_KERNELS
+COLUMNAR_TARGET_AVX2 inline double dot_avx2(const double* a, const double* b, size_t count) noexcept {
+    __m256d sum = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        sum = _mm256_add_pd(sum, _mm256_mul_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+    }
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, sum);
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) + dot_scalar(a + i, b + i, count - i);
+}
+#endif
+
+// Sum of a[i] * b[i] at the level simd_level() selects. Levels add in a
+// different order, so results agree only up to rounding.
+inline double dot(const double* a, const double* b, size_t count) noexcept {
+    switch (simd_level()) {
+#if COLUMNAR_HAS_AVX512_KERNELS
+        case SimdLevel::Avx512:
+            return dot_avx512(a, b, count);
+#endif
+#if COLUMNAR_HAS_AVX2_KERNELS
+        case SimdLevel::Avx2:
+            return dot_avx2(a, b, count);
+#endif
+        default:
+            return dot_scalar(a, b, count);
+    }
+}
+
+// Copies the rows of one numeric column in [begin, end) that `selection`
+// keeps (all of them without one) to `out` as doubles and returns how many
+// it wrote. `begin` must be a multiple of 64.
+using BlockLoader = std::function<size_t(size_t begin, size_t end, const SelectionBitmap* selection, double* out)>;
+
+template <typename Table>
+Expected<std::vector<BlockLoader>, CsvError> make_block_loaders(const Table& table,
+                                                                std::span<const std::string> columns) {
+    using Result = Expected<std::vector<BlockLoader>, CsvError>;
+
+    std::vector<BlockLoader> loaders;
+    for (const auto& name : columns) {
+        bool numeric = false;
+        const bool found = table.visit_column(name, [&](auto column) {
+            using T = typename decltype(column)::value_type;
+            if constexpr (!std::is_same_v<T, std::string>) {
+                numeric = true;
+                loaders.emplace_back([column](size_t begin, size_t end, const SelectionBitmap* selection, double* out) {
+                    if (selection == nullptr) {
+                        for (size_t row = begin; row < end; ++row) {
+                            *out++ = static_cast<double>(column[row]);
+                        }
+                        return end - begin;
+                    }
+                    size_t written = 0;
+                    const auto words = selection->words();
+                    for (size_t w = begin / 64; w * 64 < end; ++w) {
+                        uint64_t word = words[w];
+                        if (end - w * 64 < 64) {
+                            word &= (uint64_t{1} << (end - w * 64)) - 1;
+                        }
+                        for (; word != 0; word &= word - 1) {
+                            out[written++] = static_cast<double>(column[w * 64 + static_cast<size_t>(std::countr_zero(word))]);
+                        }
+                    }
+                    return written;
+                });
+            }
+        });
+        if (!found) {
+            return Result(CsvError::ColumnNotFound);
+        }
+        if (!numeric) {
+            return Result(CsvError::ParseError);
+        }
+    }
+    return Result(std::move(loaders));
+}
+
+// Feeds the selected rows of `columns` to copies of `init` in blocks of
+// kBlockRows, one copy per contiguous part of the table (pool.size() parts
+// with a pool, one without), and merges the copies in row order. State
+// needs add_block(values, stride, rows), which receives the block column by
+// column (column c at values + c * stride) and may overwrite it, and
+// merge(const State&).
+template <typename State, typename Table>
+Expected<State, CsvError> accumulate_column_blocks(const Table& table, std::span<const std::string> columns,
+                                                   const SelectionBitmap* selection, ThreadPool* pool, State init) {
+    using Result = Expected<State, CsvError>;
+    constexpr size_t kBlockRows = 1024;
+
+    auto loaders = make_block_loaders(table, columns);
+    if (!loaders) {
+        return Result(loaders.error());
+    }
+    if (selection != nullptr && selection->size() != table.num_rows()) {
+        return Result(CsvError::InvalidFormat);
+    }
+
+    const size_t rows = table.num_rows();
+    const size_t parts = pool != nullptr ? std::max<size_t>(std::min(pool->size(), rows / kBlockRows), 1) : 1;
+    std::vector<State> states(parts, init);
+    auto run_part = [&](size_t part) {
+        const size_t begin = rows * part / parts / 64 * 64;
+        const size_t end = part + 1 == parts ? rows : rows * (part + 1) / parts / 64 * 64;
+        std::vector<double> block(kBlockRows * loaders->size());
+        for (size_t first = begin; first < end; first += kBlockRows) {
+            const size_t last = std::min(first + kBlockRows, end);
+            size_t count = 0;
+            for (size_t c = 0; c < loaders->size(); ++c) {
+                count = (*loaders)[c](first, last, selection, block.data() + c * kBlockRows);
+            }
+            if (count != 0) {
+                states[part].add_block(block.data(), kBlockRows, count);
+            }
+        }
+    };
+    if (pool != nullptr && parts > 1) {
+        pool->parallel_for(parts, run_part);
+    } else {
+        for (size_t part = 0; part < parts; ++part) {
+            run_part(part);
+        }
+    }
+
+    for (const State& state : states) {
+        init.merge(state);
+    }
+    return Result(std::move(init));
+}
+
+}
+
+// Running means and co-moments sum((x_i - mean_i) * (x_j - mean_j)) of k
+// variables. Each block is centred on its own means and folded in with the
+// pairwise update of Chan et al., which stays accurate where the textbook
+// sum-of-products formula cancels; states over disjoint rows merge the same
+// way.
+class CovarianceAccumulator {
+public:
+    explicit CovarianceAccumulator(size_t variables)
+        : variables_(variables), means_(variables, 0.0), comoments_(variables * variables, 0.0) {}
+
+    // Adds `rows` observations given column by column: variable c at
+    // values + c * stride. Overwrites `values`.
+    void add_block(double* values, size_t stride, size_t rows);
+
+    void merge(const CovarianceAccumulator& other);
+
+    [[nodiscard]] size_t variables() const noexcept { return variables_; }
+    [[nodiscard]] uint64_t count() const noexcept { return count_; }
+    [[nodiscard]] std::span<const double> means() const noexcept { return means_; }
+
+    [[nodiscard]] double comoment(size_t i, size_t j) const noexcept {
+        return i <= j ? comoments_[i * variables_ + j] : comoments_[j * variables_ + i];
+    }
+
+    // Sample covariance (divided by count - 1), row-major k x k. NaN with
+    // fewer than two rows.
+    [[nodiscard]] std::vector<double> covariance() const;
+
+    // Pearson correlation, row-major k x k. NaN where a variable is constant.
+    [[nodiscard]] std::vector<double> correlation() const;
+
+private:
+    void merge_moments(uint64_t count, std::span<const double> means, std::span<const double> comoments);
+
+    size_t variables_;
+    uint64_t count_{0};
+    std::vector<double> means_;
+    // Upper triangle of the co-moment matrix, row-major.
+    std::vector<double> comoments_;
+};
+
+inline void CovarianceAccumulator::add_block(double* values, size_t stride, size_t rows) {
+    if (rows == 0) {
+        return;
+    }
+    std::vector<double> block_means(variables_);
+    std::vector<double> block_comoments(variables_ * variables_, 0.0);
+    for (size_t c = 0; c < variables_; ++c) {
+        double* column = values + c * stride;
+        double sum = 0.0;
+        for (size_t r = 0; r < rows; ++r) {
+            sum += column[r];
+        }
+        block_means[c] = sum / static_cast<double>(rows);
+        for (size_t r = 0; r < rows; ++r) {
+            column[r] -= block_means[c];
+        }
+    }
+    for (size_t i = 0; i < variables_; ++i) {
+        for (size_t j = i; j < variables_; ++j) {
+            block_comoments[i * variables_ + j] = detail::dot(values + i * stride, values + j * stride, rows);
+        }
+    }
+    merge_moments(rows, block_means, block_comoments);
+}
+
+inline void CovarianceAccumulator::merge(const CovarianceAccumulator& other) {
+    if (other.count_ != 0) {
+        merge_moments(other.count_, other.means_, other.comoments_);
+    }
+}
+
+inline void CovarianceAccumulator::merge_moments(uint64_t count, std::span<const double> means,
+                                                 std::span<const double> comoments) {
+    const uint64_t total = count_ + count;
+    const double weight = static_cast<double>(count_) * static_cast<double>(count) / static_cast<double>(total);
+    std::vector<double> delta(variables_);
+    for (size_t c = 0; c < variables_; ++c) {
+        delta[c] = means[c] - means_[c];
+    }
+    for (size_t i = 0; i < variables_; ++i) {
+        for (size_t j = i; j < variables_; ++j) {
+            comoments_[i * variables_ + j] += comoments[i * variables_ + j] + delta[i] * delta[j] * weight;
+        }
+    }
+    for (size_t c = 0; c < variables_; ++c) {
+        means_[c] += delta[c] * static_cast<double>(count) / static_cast<double>(total);
+    }
+    count_ = total;
+}
+
+inline std::vector<double> CovarianceAccumulator::covariance() const {
+    std::vector<double> result(variables_ * variables_, std::numeric_limits<double>::quiet_NaN());
+    if (count_ < 2) {
+        return result;
+    }
+    for (size_t i = 0; i < variables_; ++i) {
+        for (size_t j = 0; j < variables_; ++j) {
+            result[i * variables_ + j] = comoment(i, j) / static_cast<double>(count_ - 1);
+        }
+    }
+    return result;
+}
+
+inline std::vector<double> CovarianceAccumulator::correlation() const {
+    std::vector<double> result(variables_ * variables_, std::numeric_limits<double>::quiet_NaN());
+    for (size_t i = 0; i < variables_; ++i) {
+        for (size_t j = 0; j < variables_; ++j) {
+            const double scale = std::sqrt(comoment(i, i) * comoment(j, j));
+            if (scale > 0.0) {
+                result[i * variables_ + j] = i == j ? 1.0 : std::clamp(comoment(i, j) / scale, -1.0, 1.0);
+            }
+        }
+    }
+    return result;
+}
+
+// Covariance and correlation of several numeric columns, from one scan.
+// Matrices are row-major with one row and column per requested column.
+struct CovarianceMatrix {
+    std::vector<std::string> columns;
+    uint64_t count = 0;
+    std::vector<double> means;
+    std::vector<double> covariance;
+    std::vector<double> correlation;
+
+    [[nodiscard]] double covariance_at(size_t i, size_t j) const { return covariance[i * columns.size() + j]; }
+    [[nodiscard]] double correlation_at(size_t i, size_t j) const { return correlation[i * columns.size() + j]; }
+};
+
+// Computes the matrices over the rows `selection` keeps (all rows without
+// one), in parallel on `pool` if given. Fails with ColumnNotFound,
+// ParseError for a string column, or InvalidFormat if the selection does
+// not match the table.
+template <typename Table>
+[[nodiscard]] Expected<CovarianceMatrix, CsvError>
+covariance_matrix(const Table& table, std::span<const std::string> columns, ThreadPool* pool = nullptr,
+                  const SelectionBitmap* selection = nullptr) {
+    using Result = Expected<CovarianceMatrix, CsvError>;
+
+    auto state = detail::accumulate_column_blocks(table, columns, selection, pool,
+                                                  CovarianceAccumulator(columns.size()));
+    if (!state) {
+        return Result(state.error());
+    }
+
+    CovarianceMatrix result;
+    result.columns.assign(columns.begin(), columns.end());
+    result.count = state->count();
+    result.means.assign(state->means().begin(), state->means().end());
+    result.covariance = state->covariance();
+    result.correlation = state->correlation();
+    return Result(std::move(result));
+}
+
+}
+
+#endif
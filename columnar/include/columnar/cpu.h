@@ -0,0 +1,136 @@
+#ifndef COLUMNAR_CPU_H
+#define COLUMNAR_CPU_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <initializer_list>
+#include <optional>
+#include <string_view>
+
+// Kernels compiled for several instruction sets in one binary need GCC or
+// Clang target attributes on x86. Other compilers get the kernels the build
+// flags enable (e.g. MSVC /arch:AVX2) and no runtime detection.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define COLUMNAR_X86_DISPATCH 1
+#define COLUMNAR_HAS_AVX2_KERNELS 1
+#define COLUMNAR_HAS_AVX512_KERNELS 1
+#define COLUMNAR_TARGET_AVX2 __attribute__((target("avx2,bmi,bmi2,popcnt")))
+#define COLUMNAR_TARGET_AVX512 __attribute__((target("avx2,bmi,bmi2,popcnt,avx512f,avx512bw,avx512vl")))
+#else
+#define COLUMNAR_X86_DISPATCH 0
+#if defined(__AVX2__)
+#define COLUMNAR_HAS_AVX2_KERNELS 1
+#else
+#define COLUMNAR_HAS_AVX2_KERNELS 0
+#endif
+#if defined(__AVX512F__) && defined(__AVX512BW__) && defined(__AVX512VL__)
+#define COLUMNAR_HAS_AVX512_KERNELS 1
+#else
+#define COLUMNAR_HAS_AVX512_KERNELS 0
+#endif
+#define COLUMNAR_TARGET_AVX2
+#define COLUMNAR_TARGET_AVX512
+#endif
+
+#if COLUMNAR_X86_DISPATCH || defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace columnar {
+
+// Instruction sets a kernel may be dispatched to, in increasing order.
+// Scalar is whatever the build targets anyway (SSE2 on x86-64); Avx512 means
+// AVX-512 F, BW and VL.
+enum class SimdLevel : int {
+    Scalar = 0,
+    Avx2 = 1,
+    Avx512 = 2
+};
+
+[[nodiscard]] constexpr std::string_view simd_level_name(SimdLevel level) noexcept {
+    switch (level) {
+        case SimdLevel::Scalar:
+            return "scalar";
+        case SimdLevel::Avx2:
+            return "avx2";
+        case SimdLevel::Avx512:
+            return "avx512";
+    }
+    return "scalar";
+}
+
+[[nodiscard]] constexpr std::optional<SimdLevel> parse_simd_level(std::string_view name) noexcept {
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::Avx2, SimdLevel::Avx512}) {
+        if (name == simd_level_name(level)) {
+            return level;
+        }
+    }
+    return std::nullopt;
+}
+
+namespace detail {
+
+// Highest level the CPU and the operating system support, from cpuid.
+inline SimdLevel detect_simd_level() noexcept {
+#if COLUMNAR_X86_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+        __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("avx2")) {
+        return SimdLevel::Avx512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi2") && __builtin_cpu_supports("popcnt")) {
+        return SimdLevel::Avx2;
+    }
+    return SimdLevel::Scalar;
+#elif COLUMNAR_HAS_AVX512_KERNELS
+    return SimdLevel::Avx512;
+#elif COLUMNAR_HAS_AVX2_KERNELS
+    return SimdLevel::Avx2;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+// The level to run at: `requested` (the value of COLUMNAR_SIMD_LEVEL, if
+// set and valid) capped at what the CPU supports.
+[[nodiscard]] constexpr SimdLevel resolve_simd_level(SimdLevel supported, const char* requested) noexcept {
+    if (requested == nullptr) {
+        return supported;
+    }
+    const auto level = parse_simd_level(requested);
+    return level ? std::min(*level, supported) : supported;
+}
+
+inline std::atomic<SimdLevel>& active_simd_level() noexcept {
+    static std::atomic<SimdLevel> level{resolve_simd_level(detect_simd_level(), std::getenv("COLUMNAR_SIMD_LEVEL"))};
+    return level;
+}
+
+}
+
+[[nodiscard]] inline SimdLevel supported_simd_level() noexcept {
+    static const SimdLevel supported = detail::detect_simd_level();
+    return supported;
+}
+
+// Level the dispatched kernels currently use. Detected once on first use;
+// COLUMNAR_SIMD_LEVEL=scalar|avx2|avx512 lowers it, e.g. to test every path
+// on one machine.
+[[nodiscard]] inline SimdLevel simd_level() noexcept {
+    return detail::active_simd_level().load(std::memory_order_relaxed);
+}
+
+// Switches the dispatched kernels to `level`, capped at what the CPU
+// supports, and returns the level now in use.
+inline SimdLevel set_simd_level(SimdLevel level) noexcept {
+    const SimdLevel effective = std::min(level, supported_simd_level());
+    detail::active_simd_level().store(effective, std::memory_order_relaxed);
+    return effective;
+}
+
+}
+
+#endif
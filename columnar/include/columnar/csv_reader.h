@@ -0,0 +1,231 @@
+#ifndef COLUMNAR_CSV_READER_H
+#define COLUMNAR_CSV_READER_H
+
+#include "columnar/columnar.h"
+#include "columnar/thread_pool.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace columnar {
+
+// Incremental CSV reader that yields the file as a sequence of Columnar batches
+// of at most `batch_rows` rows each. The header is validated on open.
+template <ColumnType... ColumnTypes>
+class CsvBatchReader {
+public:
+    [[nodiscard]] static Expected<CsvBatchReader<ColumnTypes...>, CsvError>
+    try_open(const std::filesystem::path& filepath);
+
+    [[nodiscard]] Expected<Columnar<ColumnTypes...>, CsvError> next_batch(size_t batch_rows);
+
+    [[nodiscard]] bool done() const noexcept { return done_; }
+
+    [[nodiscard]] const auto& column_names() const noexcept { return names_; }
+
+private:
+    using Names = std::array<std::string, sizeof...(ColumnTypes)>;
+
+    CsvBatchReader(std::ifstream file, Names names) : file_(std::move(file)), names_(std::move(names)) {}
+
+    std::ifstream file_;
+    Names names_;
+    bool done_{false};
+};
+
+template <ColumnType... ColumnTypes>
+[[nodiscard]] Expected<CsvBatchReader<ColumnTypes...>, CsvError>
+CsvBatchReader<ColumnTypes...>::try_open(const std::filesystem::path& filepath) {
+    using Result = Expected<CsvBatchReader<ColumnTypes...>, CsvError>;
+
+    std::ifstream file(filepath);
+    if (!file.is_open()) {
+        return Result(CsvError::FileNotFound);
+    }
+
+    std::string line;
+    if (!std::getline(file, line) || line.empty()) {
+        return Result(CsvError::InvalidFormat);
+    }
+
+    auto names = Columnar<ColumnTypes...>::try_parse_csv_header(line);
+    if (!names) {
+        return Result(names.error());
+    }
+
+    return Result(CsvBatchReader(std::move(file), std::move(*names)));
+}
+
+template <ColumnType... ColumnTypes>
+[[nodiscard]] Expected<Columnar<ColumnTypes...>, CsvError>
+CsvBatchReader<ColumnTypes...>::next_batch(size_t batch_rows) {
+    using Result = Expected<Columnar<ColumnTypes...>, CsvError>;
+
+    Columnar<ColumnTypes...> batch(names_);
+    batch.reserve(batch_rows);
+
+    std::string line;
+    while (batch.num_rows() < batch_rows) {
+        if (!std::getline(file_, line)) {
+            done_ = true;
+            break;
+        }
+        if (line.empty()) continue;
+
+        if (!batch.try_append_csv_row(line)) {
+            done_ = true;
+            return Result(CsvError::ParseError);
+        }
+    }
+
+    if (!done_ && file_.peek() == std::char_traits<char>::eof()) {
+        done_ = true;
+    }
+
+    return Result(std::move(batch));
+}
+
+// Byte range of a CSV body. A range owns every line whose first byte lies in
+// [begin, end), so ranges can be parsed independently.
+struct CsvByteRange {
+    std::uintmax_t begin;
+    std::uintmax_t end;
+};
+
+struct CsvLayout {
+    std::string header;
+    std::vector<CsvByteRange> ranges;
+};
+
+[[nodiscard]] inline Expected<CsvLayout, CsvError>
+try_split_csv(const std::filesystem::path& filepath, size_t parts) {
+    using Result = Expected<CsvLayout, CsvError>;
+
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file.is_open()) {
+        return Result(CsvError::FileNotFound);
+    }
+
+    CsvLayout layout;
+    if (!std::getline(file, layout.header) || layout.header.empty()) {
+        return Result(CsvError::InvalidFormat);
+    }
+
+    std::error_code ec;
+    const std::uintmax_t file_size = std::filesystem::file_size(filepath, ec);
+    if (ec) {
+        return Result(CsvError::FileNotFound);
+    }
+
+    const std::uintmax_t body_begin = std::min<std::uintmax_t>(layout.header.size() + 1, file_size);
+    const std::uintmax_t body_size = file_size - body_begin;
+    parts = std::max<size_t>(parts, 1);
+
+    for (size_t i = 0; i < parts; ++i) {
+        layout.ranges.push_back({body_begin + body_size * i / parts, body_begin + body_size * (i + 1) / parts});
+    }
+    return Result(std::move(layout));
+}
+
+namespace detail {
+
+// Feeds every non-empty line owned by `range` to `on_row`, stopping at the
+// first failure.
+template <typename OnRow>
+std::optional<CsvError> read_csv_range_lines(const std::filesystem::path& filepath, CsvByteRange range,
+                                             OnRow&& on_row) {
+    if (range.begin >= range.end) {
+        return std::nullopt;
+    }
+
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file.is_open()) {
+        return CsvError::FileNotFound;
+    }
+
+    std::string line;
+    std::uintmax_t pos = range.begin;
+    if (pos > 0) {
+        file.seekg(static_cast<std::streamoff>(pos - 1));
+        if (!std::getline(file, line)) {
+            return std::nullopt;
+        }
+        pos += line.size();
+    } else {
+        file.seekg(0);
+    }
+
+    while (pos < range.end && std::getline(file, line)) {
+        pos += line.size() + 1;
+        if (line.empty()) continue;
+
+        if (!on_row(std::string_view(line))) {
+            return CsvError::ParseError;
+        }
+    }
+    return std::nullopt;
+}
+
+}
+
+template <ColumnType... ColumnTypes>
+[[nodiscard]] Expected<Columnar<ColumnTypes...>, CsvError>
+try_read_csv_range(const std::filesystem::path& filepath,
+                   const std::array<std::string, sizeof...(ColumnTypes)>& names, CsvByteRange range) {
+    using Result = Expected<Columnar<ColumnTypes...>, CsvError>;
+
+    Columnar<ColumnTypes...> result(names);
+    auto error = detail::read_csv_range_lines(filepath, range,
+                                              [&](std::string_view line) { return result.try_append_csv_row(line); });
+    if (error) {
+        return Result(*error);
+    }
+    return Result(std::move(result));
+}
+
+// Parses the file as `parts` independent byte ranges on the pool and
+// concatenates them in file order.
+template <ColumnType... ColumnTypes>
+[[nodiscard]] Expected<Columnar<ColumnTypes...>, CsvError>
+try_read_from_csv_parallel(const std::filesystem::path& filepath, ThreadPool& pool, size_t parts = 0) {
+    using Result = Expected<Columnar<ColumnTypes...>, CsvError>;
+
+    auto layout = try_split_csv(filepath, parts == 0 ? pool.size() : parts);
+    if (!layout) {
+        return Result(layout.error());
+    }
+
+    auto names = Columnar<ColumnTypes...>::try_parse_csv_header(layout->header);
+    if (!names) {
+        return Result(names.error());
+    }
+
+    std::vector<std::optional<Result>> pieces(layout->ranges.size());
+    pool.parallel_for(pieces.size(), [&](size_t i) {
+        pieces[i].emplace(try_read_csv_range<ColumnTypes...>(filepath, *names, layout->ranges[i]));
+    });
+
+    size_t rows = 0;
+    for (const auto& piece : pieces) {
+        if (!*piece) {
+            return Result((*piece).error());
+        }
+        rows += (**piece).num_rows();
+    }
+
+    Columnar<ColumnTypes...> result(*names);
+    result.reserve(rows);
+    for (const auto& piece : pieces) {
+        result.append(**piece);
+    }
+    return Result(std::move(result));
+}
+
+}
+
+#endif
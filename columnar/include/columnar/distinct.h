@@ -0,0 +1,603 @@
+#ifndef COLUMNAR_DISTINCT_H
+#define COLUMNAR_DISTINCT_H
+
+#include "columnar/cpu.h"
+#include "columnar/hash.h"
+#include "columnar/query.h"
+#include "columnar/thread_pool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace columnar {
+
+namespace detail {
+
+// Equality used for distinct values: like ==, except that all NaNs are one
+// value.
+template <typename T>
+[[nodiscard]] bool same_value(const T& a, const T& b) noexcept {
+    if constexpr (std::floating_point<T>) {
+        return a == b || (a != a && b != b);
+    } else {
+        return a == b;
+    }
+}
+
+// Bits of a numeric value with -0.0 folded into 0.0 and every NaN into one
+// quiet NaN, so that same_value() implies equal bits.
+template <typename T>
+[[nodiscard]] uint64_t normalized_bits(T value) noexcept {
+    if constexpr (std::floating_point<T>) {
+        value = value != value ? std::numeric_limits<T>::quiet_NaN() : value == T{} ? T{} : value;
+    }
+    if constexpr (sizeof(T) == 8) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, 8);
+        return bits;
+    } else if constexpr (sizeof(T) == 4) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, 4);
+        return bits;
+    } else {
+        uint64_t bits = 0;
+        std::memcpy(&bits, &value, std::min(sizeof(T), sizeof(bits)));
+        return bits;
+    }
+}
+
+// Folds the hash of one more key column into a running row hash.
+[[nodiscard]] constexpr uint64_t combine_hash(uint64_t hash, uint64_t value_hash) noexcept {
+    return hash * 0x9e3779b97f4a7c15ull + value_hash;
+}
+
+template <bool Combine, typename T>
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((always_inline))
+#endif
+inline void hash_numeric_body(const T* values, size_t count, uint64_t seed, uint64_t* hashes) noexcept {
+    for (size_t i = 0; i < count; ++i) {
+        const uint64_t hash = mix64(normalized_bits(values[i]) ^ seed);
+        hashes[i] = Combine ? combine_hash(hashes[i], hash) : hash;
+    }
+}
+
+#if COLUMNAR_HAS_AVX512_KERNELS
+template <bool Combine, typename T>
+COLUMNAR_TARGET_AVX512 void hash_numeric_avx512(const T* values, size_t count, uint64_t seed, uint64_t* hashes) noexcept {
+    hash_numeric_body<Combine>(values, count, seed, hashes);
+}
+#endif
+
+#if COLUMNAR_HAS_AVX2_KERNELS
+template <bool Combine, typename T>
+COLUMNAR_TARGET_AVX2 void hash_numeric_avx2(const T* values, size_t count, uint64_t seed, uint64_t* hashes) noexcept {
+    hash_numeric_body<Combine>(values, count, seed, hashes);
+}
+#endif
+
+template <bool Combine, typename T>
+void hash_column_into(std::span<const T> column, uint64_t* hashes, uint64_t seed) noexcept {
+    if constexpr (std::is_same_v<T, std::string>) {
+        for (size_t i = 0; i < column.size(); ++i) {
+            const uint64_t hash = hash_bytes(column[i], seed);
+            hashes[i] = Combine ? combine_hash(hashes[i], hash) : hash;
+        }
+    } else {
+        switch (simd_level()) {
+#if COLUMNAR_HAS_AVX512_KERNELS
+            case SimdLevel::Avx512:
+                hash_numeric_avx512<Combine>(column.data(), column.size(), seed, hashes);
+                return;
+#endif
+#if COLUMNAR_HAS_AVX2_KERNELS
+            case SimdLevel::Avx2:
+                hash_numeric_avx2<Combine>(column.data(), column.size(), seed, hashes);
+                return;
+#endif
+            default:
+                hash_numeric_body<Combine>(column.data(), column.size(), seed, hashes);
+                return;
+        }
+    }
+}
+
+}
+
+// hashes[i] = hash of column[i] for every row. Values that are the same for
+// unique() hash equally. Numeric columns are hashed by a branch-free loop
+// compiled for each SIMD level; strings use hash_bytes. Not the same
+// function as hash_value, and not meant to be stored.
+template <typename T>
+void hash_column(std::span<const T> column, uint64_t* hashes, uint64_t seed = 0) noexcept {
+    detail::hash_column_into<false>(column, hashes, seed);
+}
+
+// Folds the hash of column[i] into hashes[i]. hash_column on the first key
+// column followed by combine_column_hash on the others gives composite key
+// hashes column by column, without building a tuple per row.
+template <typename T>
+void combine_column_hash(std::span<const T> column, uint64_t* hashes, uint64_t seed = 0) noexcept {
+    detail::hash_column_into<true>(column, hashes, seed);
+}
+
+// Distinct values of a column with their counts, kept as the row of each
+// value's first appearance. Open addressing with linear probing over
+// (hash, id) slots; rows are hashed a block at a time before probing.
+// Counters over disjoint row ranges of the same column merge.
+template <typename T>
+class DistinctCounter {
+public:
+    explicit DistinctCounter(std::span<const T> column) : column_(column) {}
+
+    // Counts rows [begin, end). With `ids`, also stores the id of each row's
+    // value (its index in first_rows()) in ids[0, end - begin).
+    void add_rows(size_t begin, size_t end, uint32_t* ids = nullptr);
+
+    // Folds in a counter over later rows of the same column.
+    void merge(const DistinctCounter& other);
+
+    [[nodiscard]] size_t size() const noexcept { return rows_.size(); }
+
+    // Row of the first appearance of each value, in order of appearance.
+    [[nodiscard]] std::span<const size_t> first_rows() const noexcept { return rows_; }
+
+    [[nodiscard]] std::span<const uint64_t> counts() const noexcept { return counts_; }
+
+private:
+    static constexpr uint32_t kEmpty = ~uint32_t{0};
+    static constexpr size_t kHashBlock = 1024;
+
+    struct Slot {
+        uint64_t hash;
+        uint32_t id;
+    };
+
+    uint32_t insert(size_t row, uint64_t hash, uint64_t count);
+    void grow();
+
+    std::span<const T> column_;
+    // Capacity is a power of two kept at least twice the number of values.
+    std::vector<Slot> slots_;
+    std::vector<size_t> rows_;
+    std::vector<uint64_t> hashes_;
+    std::vector<uint64_t> counts_;
+};
+
+template <typename T>
+void DistinctCounter<T>::grow() {
+    std::vector<Slot> old = std::move(slots_);
+    slots_.assign(std::max<size_t>(old.size() * 2, 64), Slot{0, kEmpty});
+    const size_t mask = slots_.size() - 1;
+    for (const Slot& slot : old) {
+        if (slot.id == kEmpty) {
+            continue;
+        }
+        size_t index = static_cast<size_t>(slot.hash) & mask;
+        while (slots_[index].id != kEmpty) {
+            index = (index + 1) & mask;
+        }
+        slots_[index] = slot;
+    }
+}
+
+template <typename T>
+uint32_t DistinctCounter<T>::insert(size_t row, uint64_t hash, uint64_t count) {
+    if ((rows_.size() + 1) * 2 > slots_.size()) {
+        grow();
+    }
+    const size_t mask = slots_.size() - 1;
+    for (size_t index = static_cast<size_t>(hash) & mask;; index = (index + 1) & mask) {
+        Slot& slot = slots_[index];
+        if (slot.id == kEmpty) {
+            slot = {hash, static_cast<uint32_t>(rows_.size())};
+            rows_.push_back(row);
+            hashes_.push_back(hash);
+            counts_.push_back(count);
+            return slot.id;
+        }
+        if (slot.hash == hash && detail::same_value(column_[rows_[slot.id]], column_[row])) {
+            counts_[slot.id] += count;
+            return slot.id;
+        }
+    }
+}
+
+template <typename T>
+void DistinctCounter<T>::add_rows(size_t begin, size_t end, uint32_t* ids) {
+    uint64_t hashes[kHashBlock];
+    for (size_t first = begin; first < end; first += kHashBlock) {
+        const size_t count = std::min(kHashBlock, end - first);
+        hash_column(column_.subspan(first, count), hashes);
+        for (size_t i = 0; i < count; ++i) {
+            const uint32_t id = insert(first + i, hashes[i], 1);
+            if (ids != nullptr) {
+                ids[first - begin + i] = id;
+            }
+        }
+    }
+}
+
+template <typename T>
+void DistinctCounter<T>::merge(const DistinctCounter& other) {
+    for (size_t id = 0; id < other.rows_.size(); ++id) {
+        insert(other.rows_[id], other.hashes_[id], other.counts_[id]);
+    }
+}
+
+namespace detail {
+
+// Whether `column` is in ascending order with any NaNs last, so that equal
+// values form runs.
+template <typename T>
+[[nodiscard]] bool is_sorted_column(std::span<const T> column) {
+    return std::is_sorted(column.begin(), column.end(), [](const T& a, const T& b) {
+        if constexpr (std::floating_point<T>) {
+            return a < b || (a == a && b != b);
+        } else {
+            return a < b;
+        }
+    });
+}
+
+// Counts the distinct values of `column`. A column already in ascending
+// order is run-length scanned instead of hashed; otherwise each of up to
+// pool->size() row ranges is counted on the pool and the counters are
+// merged in row order. Either way values come out in order of first
+// appearance.
+template <typename T>
+void count_distinct(std::span<const T> column, ThreadPool* pool, std::vector<size_t>& first_rows,
+                    std::vector<uint64_t>& counts) {
+    constexpr size_t kMinPartRows = 65536;
+
+    if (is_sorted_column(column)) {
+        for (size_t row = 0; row < column.size(); ++row) {
+            if (row == 0 || !same_value(column[row], column[row - 1])) {
+                first_rows.push_back(row);
+                counts.push_back(0);
+            }
+            ++counts.back();
+        }
+        return;
+    }
+
+    const size_t parts =
+        pool != nullptr ? std::max<size_t>(std::min(pool->size(), column.size() / kMinPartRows), 1) : 1;
+    std::vector<DistinctCounter<T>> counters(parts, DistinctCounter<T>(column));
+    auto count_part = [&](size_t part) {
+        counters[part].add_rows(column.size() * part / parts, column.size() * (part + 1) / parts);
+    };
+    if (parts > 1) {
+        pool->parallel_for(parts, count_part);
+    } else {
+        count_part(0);
+    }
+    for (size_t part = 1; part < parts; ++part) {
+        counters[0].merge(counters[part]);
+    }
+    first_rows.assign(counters[0].first_rows().begin(), counters[0].first_rows().end());
+    counts.assign(counters[0].counts().begin(), counters[0].counts().end());
+}
+
+// Stores in ids[row] the dense id of each row's value, numbered in order
+// of first appearance, and returns the first row of each id. Sorted
+// columns are numbered by runs without hashing.
+template <typename T>
+std::vector<size_t> dense_ids(std::span<const T> column, uint32_t* ids) {
+    if (is_sorted_column(column)) {
+        std::vector<size_t> first_rows;
+        for (size_t row = 0; row < column.size(); ++row) {
+            if (row == 0 || !same_value(column[row], column[row - 1])) {
+                first_rows.push_back(row);
+            }
+            ids[row] = static_cast<uint32_t>(first_rows.size() - 1);
+        }
+        return first_rows;
+    }
+    DistinctCounter<T> counter(column);
+    counter.add_rows(0, column.size(), ids);
+    return std::vector<size_t>(counter.first_rows().begin(), counter.first_rows().end());
+}
+
+}
+
+// Distinct values of `column` in order of first appearance.
+template <typename T>
+[[nodiscard]] std::vector<T> unique(std::span<const T> column, ThreadPool* pool = nullptr) {
+    std::vector<size_t> first_rows;
+    std::vector<uint64_t> counts;
+    detail::count_distinct(column, pool, first_rows, counts);
+
+    std::vector<T> values;
+    values.reserve(first_rows.size());
+    for (size_t row : first_rows) {
+        values.push_back(column[row]);
+    }
+    return values;
+}
+
+template <typename T>
+struct ValueCounts {
+    std::vector<T> values;
+    std::vector<uint64_t> counts;
+};
+
+// Distinct values of `column` with the number of rows holding each, most
+// frequent first; ties keep the order of first appearance.
+template <typename T>
+[[nodiscard]] ValueCounts<T> value_counts(std::span<const T> column, ThreadPool* pool = nullptr) {
+    std::vector<size_t> first_rows;
+    std::vector<uint64_t> counts;
+    detail::count_distinct(column, pool, first_rows, counts);
+
+    std::vector<size_t> order(first_rows.size());
+    std::iota(order.begin(), order.end(), size_t{0});
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return counts[a] > counts[b]; });
+
+    ValueCounts<T> result;
+    result.values.reserve(order.size());
+    result.counts.reserve(order.size());
+    for (size_t id : order) {
+        result.values.push_back(column[first_rows[id]]);
+        result.counts.push_back(counts[id]);
+    }
+    return result;
+}
+
+// unique() of the column `name`, widened like query results. Fails with
+// ColumnNotFound.
+template <typename Table>
+[[nodiscard]] Expected<ResultColumn, CsvError> unique(const Table& table, std::string_view name,
+                                                      ThreadPool* pool = nullptr) {
+    using Result = Expected<ResultColumn, CsvError>;
+
+    std::optional<ResultColumn> result;
+    table.visit_column(name, [&](auto column) {
+        using Wide = detail::result_value_t<typename decltype(column)::value_type>;
+        const auto values = unique(column, pool);
+        result.emplace(ResultColumn{std::string(name), std::vector<Wide>(values.begin(), values.end())});
+    });
+    if (!result) {
+        return Result(CsvError::ColumnNotFound);
+    }
+    return Result(std::move(*result));
+}
+
+// value_counts() of the column `name` as two result columns: the values,
+// widened like query results, and "count". Fails with ColumnNotFound.
+template <typename Table>
+[[nodiscard]] Expected<std::vector<ResultColumn>, CsvError> value_counts(const Table& table, std::string_view name,
+                                                                         ThreadPool* pool = nullptr) {
+    using Result = Expected<std::vector<ResultColumn>, CsvError>;
+
+    std::optional<std::vector<ResultColumn>> result;
+    table.visit_column(name, [&](auto column) {
+        using Wide = detail::result_value_t<typename decltype(column)::value_type>;
+        const auto counted = value_counts(column, pool);
+        result.emplace();
+        result->push_back({std::string(name), std::vector<Wide>(counted.values.begin(), counted.values.end())});
+        result->push_back({"count", std::vector<int64_t>(counted.counts.begin(), counted.counts.end())});
+    });
+    if (!result) {
+        return Result(CsvError::ColumnNotFound);
+    }
+    return Result(std::move(*result));
+}
+
+// Which row of each set of duplicates drop_duplicates keeps.
+enum class DuplicateKeep {
+    First,
+    Last
+};
+
+namespace detail {
+
+// Hashing and row comparison of one key column, resolved once by name.
+struct KeyColumn {
+    // Folds the hashes of rows [begin, end) into hashes[0, end - begin).
+    std::function<void(size_t begin, size_t end, uint64_t* hashes)> combine_hashes;
+    std::function<bool(size_t a, size_t b)> equal;
+};
+
+template <typename Table>
+Expected<std::vector<KeyColumn>, CsvError> make_key_columns(const Table& table, std::span<const std::string> names) {
+    using Result = Expected<std::vector<KeyColumn>, CsvError>;
+
+    std::vector<KeyColumn> keys;
+    for (const auto& name : names) {
+        const bool found = table.visit_column(name, [&](auto column) {
+            keys.push_back({[column](size_t begin, size_t end, uint64_t* hashes) {
+                                combine_column_hash(column.subspan(begin, end - begin), hashes);
+                            },
+                            [column](size_t a, size_t b) { return same_value(column[a], column[b]); }});
+        });
+        if (!found) {
+            return Result(CsvError::ColumnNotFound);
+        }
+    }
+    return Result(std::move(keys));
+}
+
+// Rows of one hash partition, first or last of each key. Open addressing
+// over (hash, row) slots.
+class KeyRowSet {
+public:
+    explicit KeyRowSet(std::span<const KeyColumn> keys) : keys_(keys) {}
+
+    void add(size_t row, uint64_t hash, DuplicateKeep keep) {
+        if ((size_ + 1) * 2 > slots_.size()) {
+            grow();
+        }
+        const size_t mask = slots_.size() - 1;
+        for (size_t index = static_cast<size_t>(hash) & mask;; index = (index + 1) & mask) {
+            Slot& slot = slots_[index];
+            if (slot.row == kEmpty) {
+                slot = {hash, row};
+                ++size_;
+                return;
+            }
+            if (slot.hash == hash && same_key(slot.row, row)) {
+                if (keep == DuplicateKeep::Last) {
+                    slot.row = row;
+                }
+                return;
+            }
+        }
+    }
+
+    template <typename F>
+    void for_each_row(F&& fn) const {
+        for (const Slot& slot : slots_) {
+            if (slot.row != kEmpty) {
+                fn(slot.row);
+            }
+        }
+    }
+
+private:
+    static constexpr size_t kEmpty = ~size_t{0};
+
+    struct Slot {
+        uint64_t hash;
+        size_t row;
+    };
+
+    [[nodiscard]] bool same_key(size_t a, size_t b) const {
+        return std::all_of(keys_.begin(), keys_.end(), [&](const KeyColumn& key) { return key.equal(a, b); });
+    }
+
+    void grow() {
+        std::vector<Slot> old = std::move(slots_);
+        slots_.assign(std::max<size_t>(old.size() * 2, 64), Slot{0, kEmpty});
+        const size_t mask = slots_.size() - 1;
+        for (const Slot& slot : old) {
+            if (slot.row == kEmpty) {
+                continue;
+            }
+            size_t index = static_cast<size_t>(slot.hash) & mask;
+            while (slots_[index].row != kEmpty) {
+                index = (index + 1) & mask;
+            }
+            slots_[index] = slot;
+        }
+    }
+
+    std::span<const KeyColumn> keys_;
+    std::vector<Slot> slots_;
+    size_t size_{0};
+};
+
+}
+
+// Rows to keep so that no two kept rows agree on every column of `keys`
+// (all columns when `keys` is empty): the first or last row of each set of
+// duplicates. Composite key hashes are built column by column in blocks;
+// with a pool, rows are hashed in parallel and scattered by hash into
+// partitions, and each thread then deduplicates one partition. Fails with
+// ColumnNotFound.
+template <typename Table>
+[[nodiscard]] Expected<SelectionBitmap, CsvError>
+select_unique_rows(const Table& table, std::span<const std::string> keys, DuplicateKeep keep = DuplicateKeep::First,
+                   ThreadPool* pool = nullptr) {
+    using Result = Expected<SelectionBitmap, CsvError>;
+    constexpr size_t kMinPartRows = 65536;
+    constexpr size_t kHashBlock = 4096;
+
+    const auto all_columns = table.column_names();
+    const std::vector<std::string> names = keys.empty() ? std::vector<std::string>(all_columns.begin(), all_columns.end())
+                                                        : std::vector<std::string>(keys.begin(), keys.end());
+    auto key_columns = detail::make_key_columns(table, names);
+    if (!key_columns) {
+        return Result(key_columns.error());
+    }
+
+    const size_t rows = table.num_rows();
+    const size_t parts = pool != nullptr ? std::max<size_t>(std::min(pool->size(), rows / kMinPartRows), 1) : 1;
+    auto run = [&](auto&& fn) {
+        if (parts > 1) {
+            pool->parallel_for(parts, fn);
+        } else {
+            fn(0);
+        }
+    };
+
+    // scattered[source][target]: rows of hashing part `source` whose hash
+    // falls in partition `target`, in row order. High bits pick the
+    // partition; the sets probe with the low bits.
+    std::vector<uint64_t> hashes(rows, 0);
+    std::vector<std::vector<std::vector<size_t>>> scattered(parts > 1 ? parts : 0);
+    run([&](size_t part) {
+        const size_t begin = rows * part / parts;
+        const size_t end = rows * (part + 1) / parts;
+        if (parts > 1) {
+            scattered[part].resize(parts);
+            for (auto& target : scattered[part]) {
+                target.reserve((end - begin) / parts);
+            }
+        }
+        for (size_t first = begin; first < end; first += kHashBlock) {
+            const size_t last = std::min(first + kHashBlock, end);
+            for (const auto& key : *key_columns) {
+                key.combine_hashes(first, last, hashes.data() + first);
+            }
+            if (parts > 1) {
+                for (size_t row = first; row < last; ++row) {
+                    scattered[part][static_cast<size_t>(hashes[row] >> 40) % parts].push_back(row);
+                }
+            }
+        }
+    });
+
+    std::vector<detail::KeyRowSet> sets(parts, detail::KeyRowSet(*key_columns));
+    run([&](size_t part) {
+        if (parts == 1) {
+            for (size_t row = 0; row < rows; ++row) {
+                sets[part].add(row, hashes[row], keep);
+            }
+            return;
+        }
+        // Sources cover consecutive row ranges, so rows arrive in order.
+        for (const auto& source : scattered) {
+            for (const size_t row : source[part]) {
+                sets[part].add(row, hashes[row], keep);
+            }
+        }
+    });
+
+    SelectionBitmap selection(rows);
+    for (const auto& set : sets) {
+        set.for_each_row([&](size_t row) { selection.set(row); });
+    }
+    return Result(std::move(selection));
+}
+
+// The rows select_unique_rows keeps, copied into a new table in their
+// original order.
+template <typename Table>
+[[nodiscard]] auto drop_duplicates(const Table& table, std::span<const std::string> keys,
+                                   DuplicateKeep keep = DuplicateKeep::First, ThreadPool* pool = nullptr)
+    -> decltype(table.take(std::span<const size_t>())) {
+    using Result = decltype(table.take(std::span<const size_t>()));
+
+    auto selection = select_unique_rows(table, keys, keep, pool);
+    if (!selection) {
+        return Result(selection.error());
+    }
+    const auto indices = selection->to_indices();
+    return table.take(indices);
+}
+
+}
+
+#endif
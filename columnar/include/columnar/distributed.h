@@ -0,0 +1,209 @@
+#ifndef COLUMNAR_DISTRIBUTED_H
+#define COLUMNAR_DISTRIBUTED_H
+
+#include "columnar/server.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <algorithm>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace columnar {
+
+// How Coordinator::distribute splits a table across workers. Range keeps
+// contiguous row ranges together, so projected rows come back in table order;
+// Hash sends all rows with equal key values to the same worker.
+enum class Partitioning {
+    Range,
+    Hash
+};
+
+// Row indices of `table` for each of `parts` partitions, assigned by the hash
+// of `key_column`.
+template <ColumnType... ColumnTypes>
+[[nodiscard]] Expected<std::vector<std::vector<size_t>>, CsvError>
+hash_partition(const Columnar<ColumnTypes...>& table, std::string_view key_column, size_t parts) {
+    using Result = Expected<std::vector<std::vector<size_t>>, CsvError>;
+
+    std::vector<std::vector<size_t>> partitions(std::max<size_t>(parts, 1));
+    const bool found = table.visit_column(key_column, [&](auto column) {
+        for (size_t row = 0; row < column.size(); ++row) {
+            partitions[hash_value(column[row]) % partitions.size()].push_back(row);
+        }
+    });
+    if (!found) {
+        return Result(CsvError::ColumnNotFound);
+    }
+    return Result(std::move(partitions));
+}
+
+// Runs queries over a table partitioned across worker QueryServers. Each
+// worker filters, projects and partially aggregates its own partition; the
+// coordinator merges the partial results. Workers must accept the table's
+// schema (QueryServer::accept_tables).
+class Coordinator {
+public:
+    [[nodiscard]] static Expected<Coordinator, CsvError> try_connect(std::span<const std::filesystem::path> workers);
+
+    [[nodiscard]] size_t worker_count() const noexcept { return workers_.size(); }
+
+    // Splits `table` across the workers and stores each part under `name`.
+    // Hash partitioning requires `key_column`. Returns the rows distributed.
+    template <ColumnType... ColumnTypes>
+    [[nodiscard]] Expected<uint64_t, CsvError> distribute(const std::string& name,
+                                                          const Columnar<ColumnTypes...>& table,
+                                                          Partitioning partitioning = Partitioning::Range,
+                                                          std::string_view key_column = {});
+
+    // Projected rows are concatenated in worker order up to `request.limit`;
+    // aggregates are merged from the workers' partial aggregates.
+    [[nodiscard]] Expected<QueryResult, CsvError> execute(const QueryRequest& request);
+
+private:
+    explicit Coordinator(std::vector<QueryClient> workers) : workers_(std::move(workers)) {}
+
+    // Sends one frame per worker, then collects every reply. Returns the
+    // first error, after all replies have been read so connections stay in
+    // sync.
+    Expected<std::vector<QueryResult>, CsvError> round_trip(std::span<const std::string> frames);
+
+    std::vector<QueryClient> workers_;
+};
+
+inline Expected<Coordinator, CsvError> Coordinator::try_connect(std::span<const std::filesystem::path> workers) {
+    using Result = Expected<Coordinator, CsvError>;
+
+    if (workers.empty()) {
+        return Result(CsvError::InvalidFormat);
+    }
+    std::vector<QueryClient> clients;
+    clients.reserve(workers.size());
+    for (const auto& path : workers) {
+        auto client = QueryClient::try_connect(path);
+        if (!client) {
+            return Result(client.error());
+        }
+        clients.push_back(std::move(*client));
+    }
+    return Result(Coordinator(std::move(clients)));
+}
+
+template <ColumnType... ColumnTypes>
+Expected<uint64_t, CsvError> Coordinator::distribute(const std::string& name, const Columnar<ColumnTypes...>& table,
+                                                     Partitioning partitioning, std::string_view key_column) {
+    using Result = Expected<uint64_t, CsvError>;
+
+    const size_t parts = workers_.size();
+    std::vector<std::string> frames(parts);
+    if (partitioning == Partitioning::Hash) {
+        auto partitions = hash_partition(table, key_column, parts);
+        if (!partitions) {
+            return Result(partitions.error());
+        }
+        for (size_t i = 0; i < parts; ++i) {
+            encode_load(name, *table.take((*partitions)[i]), frames[i]);
+        }
+    } else {
+        const size_t rows_per_part = (table.num_rows() + parts - 1) / parts;
+        for (size_t i = 0; i < parts; ++i) {
+            const size_t offset = std::min(i * rows_per_part, table.num_rows());
+            encode_load(name, table.view().slice(offset, rows_per_part)->to_columnar(), frames[i]);
+        }
+    }
+
+    auto replies = round_trip(frames);
+    if (!replies) {
+        return Result(replies.error());
+    }
+    uint64_t rows = 0;
+    for (const auto& reply : *replies) {
+        rows += reply.matched_rows;
+    }
+    return Result(rows);
+}
+
+inline Expected<QueryResult, CsvError> Coordinator::execute(const QueryRequest& request) {
+    using Result = Expected<QueryResult, CsvError>;
+
+    std::string frame;
+    encode(request, frame);
+    std::vector<std::string> frames(workers_.size(), frame);
+
+    auto replies = round_trip(frames);
+    if (!replies) {
+        return Result(replies.error());
+    }
+
+    QueryResult merged;
+    merged.partials.resize(request.aggregates.size());
+    for (auto& reply : *replies) {
+        merged.matched_rows += reply.matched_rows;
+        for (size_t i = 0; i < merged.partials.size() && i < reply.partials.size(); ++i) {
+            merged.partials[i].merge(reply.partials[i]);
+        }
+
+        if (merged.columns.empty()) {
+            merged.columns = std::move(reply.columns);
+            continue;
+        }
+        for (size_t c = 0; c < merged.columns.size() && c < reply.columns.size(); ++c) {
+            std::visit([&](auto& values) {
+                using Values = std::decay_t<decltype(values)>;
+                if (auto* more = std::get_if<Values>(&reply.columns[c].values)) {
+                    values.insert(values.end(), std::make_move_iterator(more->begin()),
+                                  std::make_move_iterator(more->end()));
+                }
+            }, merged.columns[c].values);
+        }
+    }
+
+    for (auto& column : merged.columns) {
+        std::visit([&](auto& values) {
+            if (values.size() > request.limit) {
+                values.resize(static_cast<size_t>(request.limit));
+            }
+        }, column.values);
+    }
+    for (size_t i = 0; i < request.aggregates.size(); ++i) {
+        merged.aggregates.push_back(merged.partials[i].finish(request.aggregates[i].op));
+    }
+    return Result(std::move(merged));
+}
+
+inline Expected<std::vector<QueryResult>, CsvError> Coordinator::round_trip(std::span<const std::string> frames) {
+    using Result = Expected<std::vector<QueryResult>, CsvError>;
+
+    std::vector<bool> sent(workers_.size());
+    for (size_t i = 0; i < workers_.size(); ++i) {
+        sent[i] = workers_[i].send(frames[i]);
+    }
+
+    std::vector<QueryResult> replies;
+    std::optional<CsvError> error;
+    for (size_t i = 0; i < workers_.size(); ++i) {
+        if (!sent[i]) {
+            error = error.value_or(CsvError::IoError);
+            continue;
+        }
+        auto reply = workers_[i].receive();
+        if (!reply) {
+            error = error.value_or(reply.error());
+            continue;
+        }
+        replies.push_back(std::move(*reply));
+    }
+
+    if (error) {
+        return Result(*error);
+    }
+    return Result(std::move(replies));
+}
+
+}
+
+#endif
+
+#endif
@@ -0,0 +1,843 @@
+#ifndef COLUMNAR_EXTERNAL_H
+#define COLUMNAR_EXTERNAL_H
+
+#include "columnar/hash.h"
+#include "columnar/interning.h"
+#include "columnar/query.h"
+#include "columnar/snapshot.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+namespace columnar {
+
+enum class SortOrder {
+    Ascending,
+    Descending
+};
+
+struct SpillOptions {
+    // Upper bound on the rows or groups buffered in memory before spilling.
+    size_t memory_budget_bytes = size_t{256} << 20;
+    std::filesystem::path spill_dir = std::filesystem::temp_directory_path();
+    // Rows per spilled block and per batch handed to the sink.
+    size_t block_rows = 16384;
+};
+
+namespace detail {
+
+template <typename T>
+size_t column_bytes(std::span<const T> column) {
+    if constexpr (std::is_same_v<T, std::string>) {
+        size_t bytes = column.size() * sizeof(std::string);
+        for (const auto& value : column) {
+            bytes += value.size();
+        }
+        return bytes;
+    } else {
+        return column.size() * sizeof(T);
+    }
+}
+
+template <ColumnType... ColumnTypes>
+size_t estimated_bytes(const Columnar<ColumnTypes...>& table) {
+    return [&]<size_t... Is>(std::index_sequence<Is...>) {
+        return (column_bytes(table.template get_column_view<Is>()) + ... + size_t{0});
+    }(std::make_index_sequence<sizeof...(ColumnTypes)>{});
+}
+
+// Strict weak order on column values with NaN above every number, so columns
+// containing NaN can still be sorted.
+template <typename T>
+bool key_less(const T& a, const T& b) noexcept {
+    if constexpr (std::floating_point<T>) {
+        if (std::isnan(a)) {
+            return false;
+        }
+        if (std::isnan(b)) {
+            return true;
+        }
+    }
+    return a < b;
+}
+
+template <typename T>
+bool key_before(const T& a, const T& b, SortOrder order) noexcept {
+    return order == SortOrder::Ascending ? key_less(a, b) : key_less(b, a);
+}
+
+// Stable order of the rows of `table` by `key`.
+template <ColumnType... ColumnTypes>
+std::vector<size_t> sorted_order(const Columnar<ColumnTypes...>& table, std::string_view key, SortOrder order) {
+    std::vector<size_t> rows(table.num_rows());
+    std::iota(rows.begin(), rows.end(), size_t{0});
+    table.visit_column(key, [&](auto column) {
+        std::stable_sort(rows.begin(), rows.end(),
+                         [&](size_t a, size_t b) { return key_before(column[a], column[b], order); });
+    });
+    return rows;
+}
+
+template <ColumnType... ColumnTypes>
+void append_row_from(Columnar<ColumnTypes...>& dst, const Columnar<ColumnTypes...>& src, size_t row) {
+    [&]<size_t... Is>(std::index_sequence<Is...>) {
+        dst.append_row(src.template get_column_view<Is>()[row]...);
+    }(std::make_index_sequence<sizeof...(ColumnTypes)>{});
+}
+
+// A file in the spill directory that is deleted when it goes out of scope.
+class SpillFile {
+public:
+    explicit SpillFile(const std::filesystem::path& dir) {
+        static std::atomic<uint64_t> counter{0};
+        const auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+        path_ = dir / ("columnar_spill_" + std::to_string(stamp) + "_" + std::to_string(counter.fetch_add(1)) +
+                       ".blocks");
+    }
+
+    SpillFile(const SpillFile&) = delete;
+    SpillFile& operator=(const SpillFile&) = delete;
+    SpillFile(SpillFile&& other) noexcept : path_(std::exchange(other.path_, {})) {}
+    SpillFile& operator=(SpillFile&& other) noexcept {
+        if (this != &other) {
+            remove();
+            path_ = std::exchange(other.path_, {});
+        }
+        return *this;
+    }
+    ~SpillFile() { remove(); }
+
+    [[nodiscard]] const std::filesystem::path& path() const noexcept { return path_; }
+
+private:
+    void remove() noexcept {
+        if (!path_.empty()) {
+            std::error_code ec;
+            std::filesystem::remove(path_, ec);
+        }
+    }
+
+    std::filesystem::path path_;
+};
+
+// Spill files are a sequence of blocks, each a u64 size followed by that
+// many bytes, written and read strictly sequentially.
+class BlockWriter {
+public:
+    explicit BlockWriter(const std::filesystem::path& path) : file_(path, std::ios::binary | std::ios::trunc) {}
+
+    bool write(const std::string& block) {
+        const auto size = static_cast<uint64_t>(block.size());
+        file_.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        file_.write(block.data(), static_cast<std::streamsize>(block.size()));
+        return file_.good();
+    }
+
+    bool close() {
+        file_.close();
+        return !file_.fail();
+    }
+
+private:
+    std::ofstream file_;
+};
+
+class BlockReader {
+public:
+    explicit BlockReader(const std::filesystem::path& path) : file_(path, std::ios::binary), failed_(!file_) {}
+
+    // Reads the next block; false at the end of the file or on a short read.
+    bool next(std::string& block) {
+        uint64_t size = 0;
+        if (failed_ || !file_.read(reinterpret_cast<char*>(&size), sizeof(size))) {
+            failed_ = failed_ || file_.gcount() != 0;
+            return false;
+        }
+        block.resize(static_cast<size_t>(size));
+        if (!file_.read(block.data(), static_cast<std::streamsize>(size))) {
+            failed_ = true;
+            return false;
+        }
+        return true;
+    }
+
+    [[nodiscard]] bool failed() const noexcept { return failed_; }
+
+private:
+    std::ifstream file_;
+    bool failed_;
+};
+
+}
+
+// Sorts a stream of batches larger than memory. Batches are buffered until
+// the budget is reached, then sorted and written as a run of snapshot-encoded
+// blocks; finish() k-way merges the runs. The sort is stable: rows with equal
+// keys keep the order in which they were added.
+template <ColumnType... ColumnTypes>
+class ExternalSorter {
+public:
+    using Table = Columnar<ColumnTypes...>;
+
+    explicit ExternalSorter(std::string key_column, SortOrder order = SortOrder::Ascending,
+                            SpillOptions options = {})
+        : key_(std::move(key_column)), order_(order), options_(std::move(options)) {
+        options_.block_rows = std::max<size_t>(options_.block_rows, 1);
+    }
+
+    // Returns the number of rows added so far.
+    [[nodiscard]] Expected<uint64_t, CsvError> add(const Table& batch);
+
+    // Passes every row in key order to `sink(const Table&)` in batches of at
+    // most `block_rows` rows and returns the row count. Leaves the sorter
+    // empty.
+    template <typename Sink>
+    [[nodiscard]] Expected<uint64_t, CsvError> finish(Sink&& sink);
+
+    [[nodiscard]] size_t run_count() const noexcept { return runs_.size(); }
+
+private:
+    [[nodiscard]] bool spill();
+
+    template <typename Key, typename Sink>
+    [[nodiscard]] Expected<uint64_t, CsvError> merge_runs(Sink& sink);
+
+    std::string key_;
+    SortOrder order_;
+    SpillOptions options_;
+    Table buffer_;
+    size_t buffered_bytes_{0};
+    uint64_t rows_{0};
+    std::vector<detail::SpillFile> runs_;
+};
+
+template <ColumnType... ColumnTypes>
+Expected<uint64_t, CsvError> ExternalSorter<ColumnTypes...>::add(const Table& batch) {
+    using Result = Expected<uint64_t, CsvError>;
+
+    if (!batch.visit_column(key_, [](auto) {})) {
+        return Result(CsvError::ColumnNotFound);
+    }
+    if (rows_ == 0 && buffer_.num_rows() == 0) {
+        std::array<std::string, sizeof...(ColumnTypes)> names;
+        std::copy(batch.column_names().begin(), batch.column_names().end(), names.begin());
+        buffer_ = Table(std::move(names));
+    }
+
+    buffer_.append(batch);
+    buffered_bytes_ += detail::estimated_bytes(batch);
+    rows_ += batch.num_rows();
+    if (buffered_bytes_ > options_.memory_budget_bytes && !spill()) {
+        return Result(CsvError::IoError);
+    }
+    return Result(rows_);
+}
+
+template <ColumnType... ColumnTypes>
+bool ExternalSorter<ColumnTypes...>::spill() {
+    if (buffer_.num_rows() == 0) {
+        return true;
+    }
+
+    const auto order = detail::sorted_order(buffer_, key_, order_);
+    detail::SpillFile run(options_.spill_dir);
+    detail::BlockWriter writer(run.path());
+    std::string block;
+    for (size_t offset = 0; offset < order.size(); offset += options_.block_rows) {
+        const size_t rows = std::min(options_.block_rows, order.size() - offset);
+        block.clear();
+        serialize(*buffer_.take(std::span(order).subspan(offset, rows)), block);
+        if (!writer.write(block)) {
+            return false;
+        }
+    }
+    if (!writer.close()) {
+        return false;
+    }
+
+    runs_.push_back(std::move(run));
+    buffer_.clear();
+    buffered_bytes_ = 0;
+    return true;
+}
+
+template <ColumnType... ColumnTypes>
+template <typename Sink>
+Expected<uint64_t, CsvError> ExternalSorter<ColumnTypes...>::finish(Sink&& sink) {
+    using Result = Expected<uint64_t, CsvError>;
+
+    std::optional<Result> result;
+    if (runs_.empty()) {
+        // Everything fit in memory: sort in place without touching disk.
+        const auto order = detail::sorted_order(buffer_, key_, order_);
+        for (size_t offset = 0; offset < order.size(); offset += options_.block_rows) {
+            const size_t rows = std::min(options_.block_rows, order.size() - offset);
+            sink(*buffer_.take(std::span(order).subspan(offset, rows)));
+        }
+        result.emplace(static_cast<uint64_t>(order.size()));
+    } else if (!spill()) {
+        result.emplace(CsvError::IoError);
+    } else {
+        buffer_.visit_column(key_, [&](auto column) {
+            result.emplace(merge_runs<typename decltype(column)::value_type>(sink));
+        });
+    }
+
+    buffer_.clear();
+    buffered_bytes_ = 0;
+    rows_ = 0;
+    runs_.clear();
+    return result ? std::move(*result) : Result(uint64_t{0});
+}
+
+template <ColumnType... ColumnTypes>
+template <typename Key, typename Sink>
+Expected<uint64_t, CsvError> ExternalSorter<ColumnTypes...>::merge_runs(Sink& sink) {
+    using Result = Expected<uint64_t, CsvError>;
+
+    struct Cursor {
+        detail::BlockReader reader;
+        Table block;
+        std::span<const Key> keys;
+        size_t row{0};
+    };
+
+    std::string bytes;
+    auto load_block = [&](Cursor& cursor) -> std::optional<bool> {
+        if (!cursor.reader.next(bytes)) {
+            return cursor.reader.failed() ? std::nullopt : std::optional<bool>(false);
+        }
+        auto block = try_deserialize<ColumnTypes...>(bytes);
+        if (!block) {
+            return std::nullopt;
+        }
+        cursor.block = std::move(*block);
+        cursor.keys = *cursor.block.template get_column_view<Key>(key_);
+        cursor.row = 0;
+        return cursor.block.num_rows() != 0;
+    };
+
+    std::vector<Cursor> cursors;
+    cursors.reserve(runs_.size());
+    for (const auto& run : runs_) {
+        cursors.push_back({detail::BlockReader(run.path()), Table(), {}, 0});
+    }
+
+    // Ties go to the earlier run, which keeps the merge stable.
+    auto after = [&](size_t a, size_t b) {
+        const Key& key_a = cursors[a].keys[cursors[a].row];
+        const Key& key_b = cursors[b].keys[cursors[b].row];
+        if (detail::key_before(key_b, key_a, order_)) {
+            return true;
+        }
+        return !detail::key_before(key_a, key_b, order_) && a > b;
+    };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(after)> heap(after);
+
+    for (size_t i = 0; i < cursors.size(); ++i) {
+        auto loaded = load_block(cursors[i]);
+        if (!loaded) {
+            return Result(CsvError::IoError);
+        }
+        if (*loaded) {
+            heap.push(i);
+        }
+    }
+
+    std::array<std::string, sizeof...(ColumnTypes)> names;
+    std::copy(buffer_.column_names().begin(), buffer_.column_names().end(), names.begin());
+    Table out(names);
+    out.reserve(options_.block_rows);
+    uint64_t emitted = 0;
+
+    while (!heap.empty()) {
+        const size_t next = heap.top();
+        heap.pop();
+        Cursor& cursor = cursors[next];
+        detail::append_row_from(out, cursor.block, cursor.row);
+        if (out.num_rows() == options_.block_rows) {
+            emitted += out.num_rows();
+            sink(static_cast<const Table&>(out));
+            out.clear();
+        }
+
+        if (++cursor.row == cursor.block.num_rows()) {
+            auto loaded = load_block(cursor);
+            if (!loaded) {
+                return Result(CsvError::IoError);
+            }
+            if (!*loaded) {
+                continue;
+            }
+        }
+        heap.push(next);
+    }
+
+    if (out.num_rows() != 0) {
+        emitted += out.num_rows();
+        sink(static_cast<const Table&>(out));
+    }
+    return Result(emitted);
+}
+
+namespace detail {
+
+// Hash aggregation state for one widened key type. Groups are kept in memory
+// until they exceed the budget, then written out as PartialAggregate states
+// into hash partitions that finish() merges one at a time.
+template <typename Key>
+class GroupSpill {
+public:
+    static constexpr size_t kPartitions = 16;
+    static constexpr int kMaxLevels = 4;
+
+    GroupSpill(size_t aggregate_count, const SpillOptions& options)
+        : aggregate_count_(aggregate_count), options_(options) {}
+
+    // Slot of the group for `key`, created if new. Slots stay valid until
+    // the next spill; their states move as groups are added.
+    size_t slot(const Key& key) {
+        auto [it, inserted] = groups_.slots.try_emplace(key, groups_.keys.size());
+        if (inserted) {
+            groups_.add(key, aggregate_count_);
+        }
+        return it->second;
+    }
+
+    PartialAggregate& state(size_t slot, size_t aggregate) noexcept {
+        return groups_.states[slot * aggregate_count_ + aggregate];
+    }
+
+    [[nodiscard]] bool over_budget() const noexcept { return groups_.bytes > options_.memory_budget_bytes; }
+
+    [[nodiscard]] bool spill() { return spill_into(groups_, partitions_, 0); }
+
+    [[nodiscard]] size_t spill_count() const noexcept { return spills_; }
+
+    // Passes every group to `emit(keys, states)` in batches and returns the
+    // number of groups.
+    template <typename Emit>
+    [[nodiscard]] Expected<uint64_t, CsvError> finish(Emit& emit);
+
+private:
+    struct Groups {
+        std::unordered_map<Key, size_t> slots;
+        std::vector<Key> keys;
+        std::vector<PartialAggregate> states;
+        size_t bytes{0};
+
+        void add(const Key& key, size_t aggregate_count) {
+            keys.push_back(key);
+            states.resize(states.size() + aggregate_count);
+            bytes += sizeof(Key) + aggregate_count * sizeof(PartialAggregate) + kGroupOverhead;
+            if constexpr (std::is_same_v<Key, std::string>) {
+                bytes += 2 * key.size();
+            }
+        }
+
+        void clear() {
+            slots.clear();
+            keys.clear();
+            states.clear();
+            bytes = 0;
+        }
+    };
+
+    struct Partitions {
+        std::vector<SpillFile> files;
+        std::vector<BlockWriter> writers;
+    };
+
+    static constexpr size_t kGroupOverhead = 64;
+
+    [[nodiscard]] bool spill_into(Groups& groups, Partitions& partitions, int level);
+    [[nodiscard]] bool read_block(const std::string& bytes, std::vector<Key>& keys,
+                                  std::vector<PartialAggregate>& states) const;
+    template <typename Emit>
+    [[nodiscard]] Expected<uint64_t, CsvError> merge_partition(const SpillFile& file, int level, Emit& emit);
+    template <typename Emit>
+    uint64_t emit_groups(const Groups& groups, Emit& emit) const;
+
+    size_t aggregate_count_;
+    const SpillOptions& options_;
+    Groups groups_;
+    Partitions partitions_;
+    size_t spills_{0};
+};
+
+template <typename Key>
+bool GroupSpill<Key>::spill_into(Groups& groups, Partitions& partitions, int level) {
+    if (partitions.files.empty()) {
+        for (size_t p = 0; p < kPartitions; ++p) {
+            partitions.files.emplace_back(options_.spill_dir);
+            partitions.writers.emplace_back(partitions.files.back().path());
+        }
+    }
+
+    std::array<std::vector<size_t>, kPartitions> members;
+    for (size_t i = 0; i < groups.keys.size(); ++i) {
+        members[hash_value(groups.keys[i], static_cast<uint64_t>(level)) % kPartitions].push_back(i);
+    }
+
+    // Block layout: u64 groups | key column | per aggregate: count, sum, min
+    // and max columns, all in the snapshot column encoding.
+    std::string block;
+    for (size_t p = 0; p < kPartitions; ++p) {
+        if (members[p].empty()) {
+            continue;
+        }
+        block.clear();
+        SnapshotWriter writer(block);
+        writer.pod(static_cast<uint64_t>(members[p].size()));
+        write_column(writer, std::span<const Key>(gather(std::span<const Key>(groups.keys), members[p])));
+
+        std::vector<uint64_t> counts(members[p].size());
+        std::vector<double> sums(members[p].size());
+        std::vector<double> mins(members[p].size());
+        std::vector<double> maxs(members[p].size());
+        for (size_t a = 0; a < aggregate_count_; ++a) {
+            for (size_t m = 0; m < members[p].size(); ++m) {
+                const auto& state = groups.states[members[p][m] * aggregate_count_ + a];
+                counts[m] = state.count;
+                sums[m] = state.sum;
+                mins[m] = state.min;
+                maxs[m] = state.max;
+            }
+            write_column(writer, std::span<const uint64_t>(counts));
+            write_column(writer, std::span<const double>(sums));
+            write_column(writer, std::span<const double>(mins));
+            write_column(writer, std::span<const double>(maxs));
+        }
+        if (!partitions.writers[p].write(block)) {
+            return false;
+        }
+    }
+
+    groups.clear();
+    ++spills_;
+    return true;
+}
+
+template <typename Key>
+bool GroupSpill<Key>::read_block(const std::string& bytes, std::vector<Key>& keys,
+                                 std::vector<PartialAggregate>& states) const {
+    SnapshotReader reader(bytes);
+    uint64_t rows = 0;
+    if (!reader.pod(rows) || rows > bytes.size() || !read_column(reader, static_cast<size_t>(rows), keys)) {
+        return false;
+    }
+
+    states.assign(static_cast<size_t>(rows) * aggregate_count_, PartialAggregate{});
+    std::vector<uint64_t> counts;
+    std::vector<double> sums;
+    std::vector<double> mins;
+    std::vector<double> maxs;
+    for (size_t a = 0; a < aggregate_count_; ++a) {
+        if (!read_column(reader, static_cast<size_t>(rows), counts) ||
+            !read_column(reader, static_cast<size_t>(rows), sums) ||
+            !read_column(reader, static_cast<size_t>(rows), mins) ||
+            !read_column(reader, static_cast<size_t>(rows), maxs)) {
+            return false;
+        }
+        for (size_t r = 0; r < rows; ++r) {
+            states[r * aggregate_count_ + a] = {counts[r], sums[r], mins[r], maxs[r]};
+        }
+    }
+    return true;
+}
+
+template <typename Key>
+template <typename Emit>
+Expected<uint64_t, CsvError> GroupSpill<Key>::finish(Emit& emit) {
+    using Result = Expected<uint64_t, CsvError>;
+
+    if (partitions_.files.empty()) {
+        const uint64_t groups = emit_groups(groups_, emit);
+        groups_.clear();
+        return Result(groups);
+    }
+
+    if (!spill()) {
+        return Result(CsvError::IoError);
+    }
+    for (auto& writer : partitions_.writers) {
+        if (!writer.close()) {
+            return Result(CsvError::IoError);
+        }
+    }
+
+    Partitions partitions = std::move(partitions_);
+    partitions_ = {};
+    uint64_t total = 0;
+    for (const auto& file : partitions.files) {
+        auto groups = merge_partition(file, 1, emit);
+        if (!groups) {
+            return groups;
+        }
+        total += *groups;
+    }
+    return Result(total);
+}
+
+// Merges the states of one partition. A partition that still exceeds the
+// budget is split again with a different hash seed, up to kMaxLevels deep.
+template <typename Key>
+template <typename Emit>
+Expected<uint64_t, CsvError> GroupSpill<Key>::merge_partition(const SpillFile& file, int level, Emit& emit) {
+    using Result = Expected<uint64_t, CsvError>;
+
+    Groups groups;
+    Partitions children;
+    BlockReader reader(file.path());
+    std::string bytes;
+    std::vector<Key> keys;
+    std::vector<PartialAggregate> states;
+
+    while (reader.next(bytes)) {
+        if (!read_block(bytes, keys, states)) {
+            return Result(CsvError::IoError);
+        }
+        for (size_t r = 0; r < keys.size(); ++r) {
+            auto [it, inserted] = groups.slots.try_emplace(keys[r], groups.keys.size());
+            if (inserted) {
+                groups.add(keys[r], aggregate_count_);
+            }
+            for (size_t a = 0; a < aggregate_count_; ++a) {
+                groups.states[it->second * aggregate_count_ + a].merge(states[r * aggregate_count_ + a]);
+            }
+        }
+        if (groups.bytes > options_.memory_budget_bytes && level < kMaxLevels &&
+            !spill_into(groups, children, level)) {
+            return Result(CsvError::IoError);
+        }
+    }
+    if (reader.failed()) {
+        return Result(CsvError::IoError);
+    }
+
+    if (children.files.empty()) {
+        return Result(emit_groups(groups, emit));
+    }
+
+    if (!spill_into(groups, children, level)) {
+        return Result(CsvError::IoError);
+    }
+    for (auto& writer : children.writers) {
+        if (!writer.close()) {
+            return Result(CsvError::IoError);
+        }
+    }
+    uint64_t total = 0;
+    for (const auto& child : children.files) {
+        auto merged = merge_partition(child, level + 1, emit);
+        if (!merged) {
+            return merged;
+        }
+        total += *merged;
+    }
+    return Result(total);
+}
+
+template <typename Key>
+template <typename Emit>
+uint64_t GroupSpill<Key>::emit_groups(const Groups& groups, Emit& emit) const {
+    const size_t count = groups.keys.size();
+    for (size_t offset = 0; offset < count; offset += options_.block_rows) {
+        const size_t rows = std::min(options_.block_rows, count - offset);
+        emit(std::span<const Key>(groups.keys).subspan(offset, rows),
+             std::span<const PartialAggregate>(groups.states).subspan(offset * aggregate_count_, rows * aggregate_count_));
+    }
+    return count;
+}
+
+inline std::string aggregate_label(const Aggregate& request) {
+    static constexpr const char* kNames[] = {"count", "sum", "min", "max", "mean"};
+    return std::string(kNames[static_cast<int>(request.op)]) + "(" + request.column + ")";
+}
+
+}
+
+// Group-by with hash aggregation under a memory budget. Per-group
+// PartialAggregate states are accumulated in memory; when they outgrow the
+// budget they are spilled to hash partitions on disk, and finish() merges each
+// partition separately. Keys are widened like query results (int64_t, double
+// or std::string). The budget is checked between batches.
+template <ColumnType... ColumnTypes>
+class ExternalGroupBy {
+public:
+    using Table = Columnar<ColumnTypes...>;
+
+    ExternalGroupBy(std::string key_column, std::vector<Aggregate> aggregates, SpillOptions options = {})
+        : key_(std::move(key_column)), aggregates_(std::move(aggregates)), options_(std::move(options)) {
+        options_.block_rows = std::max<size_t>(options_.block_rows, 1);
+    }
+
+    ExternalGroupBy(const ExternalGroupBy&) = delete;
+    ExternalGroupBy& operator=(const ExternalGroupBy&) = delete;
+
+    // Returns the number of rows added so far.
+    [[nodiscard]] Expected<uint64_t, CsvError> add(const Table& batch);
+
+    // Passes the groups to `sink(const std::vector<ResultColumn>&)` in batches
+    // of at most `block_rows` groups: the key column, then one double column
+    // per aggregate named like "mean(px)". Groups come out in no particular
+    // order. Returns the number of groups.
+    template <typename Sink>
+    [[nodiscard]] Expected<uint64_t, CsvError> finish(Sink&& sink);
+
+    [[nodiscard]] size_t spill_count() const noexcept {
+        return std::visit([](const auto& state) -> size_t {
+            if constexpr (std::is_same_v<std::decay_t<decltype(state)>, std::monostate>) {
+                return 0;
+            } else {
+                return state.spill_count();
+            }
+        }, state_);
+    }
+
+private:
+    using State = std::variant<std::monostate, detail::GroupSpill<int64_t>, detail::GroupSpill<double>,
+                               detail::GroupSpill<std::string>>;
+
+    std::optional<CsvError> validate(const Table& batch) const;
+
+    std::string key_;
+    std::vector<Aggregate> aggregates_;
+    SpillOptions options_;
+    State state_;
+    StringInterner batch_keys_;
+    uint64_t rows_{0};
+};
+
+template <ColumnType... ColumnTypes>
+std::optional<CsvError> ExternalGroupBy<ColumnTypes...>::validate(const Table& batch) const {
+    if (!batch.visit_column(key_, [](auto) {})) {
+        return CsvError::ColumnNotFound;
+    }
+    for (const auto& request : aggregates_) {
+        if (request.op == AggregateOp::Count && request.column.empty()) {
+            continue;
+        }
+        bool numeric = true;
+        if (!batch.visit_column(request.column, [&](auto column) {
+                numeric = !std::is_same_v<typename decltype(column)::value_type, std::string>;
+            })) {
+            return CsvError::ColumnNotFound;
+        }
+        if (!numeric && request.op != AggregateOp::Count) {
+            return CsvError::ParseError;
+        }
+    }
+    return std::nullopt;
+}
+
+template <ColumnType... ColumnTypes>
+Expected<uint64_t, CsvError> ExternalGroupBy<ColumnTypes...>::add(const Table& batch) {
+    using Result = Expected<uint64_t, CsvError>;
+
+    if (auto error = validate(batch)) {
+        return Result(*error);
+    }
+
+    bool ok = true;
+    batch.visit_column(key_, [&](auto keys) {
+        using Key = detail::result_value_t<typename decltype(keys)::value_type>;
+        if (std::holds_alternative<std::monostate>(state_)) {
+            state_.template emplace<detail::GroupSpill<Key>>(aggregates_.size(), options_);
+        }
+        auto& state = std::get<detail::GroupSpill<Key>>(state_);
+
+        std::vector<size_t> slots(keys.size());
+        if constexpr (std::is_same_v<Key, std::string>) {
+            // Interning the batch first looks up each distinct key in the
+            // group table once; rows then map to their group by integer id.
+            batch_keys_.clear();
+            const auto ids = batch_keys_.intern_all(keys);
+            std::vector<size_t> id_slots(batch_keys_.size());
+            for (uint32_t id = 0; id < id_slots.size(); ++id) {
+                id_slots[id] = state.slot(batch_keys_.value(id));
+            }
+            for (size_t row = 0; row < keys.size(); ++row) {
+                slots[row] = id_slots[ids[row]];
+            }
+        } else {
+            for (size_t row = 0; row < keys.size(); ++row) {
+                slots[row] = state.slot(static_cast<Key>(keys[row]));
+            }
+        }
+
+        for (size_t a = 0; a < aggregates_.size(); ++a) {
+            const auto& request = aggregates_[a];
+            if (request.op == AggregateOp::Count) {
+                for (size_t slot : slots) {
+                    ++state.state(slot, a).count;
+                }
+                continue;
+            }
+            batch.visit_column(request.column, [&](auto values) {
+                using T = typename decltype(values)::value_type;
+                if constexpr (!std::is_same_v<T, std::string>) {
+                    for (size_t row = 0; row < values.size(); ++row) {
+                        state.state(slots[row], a).add(static_cast<double>(values[row]));
+                    }
+                }
+            });
+        }
+
+        if (state.over_budget()) {
+            ok = state.spill();
+        }
+    });
+
+    if (!ok) {
+        return Result(CsvError::IoError);
+    }
+    rows_ += batch.num_rows();
+    return Result(rows_);
+}
+
+template <ColumnType... ColumnTypes>
+template <typename Sink>
+Expected<uint64_t, CsvError> ExternalGroupBy<ColumnTypes...>::finish(Sink&& sink) {
+    using Result = Expected<uint64_t, CsvError>;
+
+    auto result = std::visit([&](auto& state) -> Result {
+        if constexpr (std::is_same_v<std::decay_t<decltype(state)>, std::monostate>) {
+            return Result(uint64_t{0});
+        } else {
+            auto emit = [&](auto keys, std::span<const PartialAggregate> states) {
+                using Key = typename decltype(keys)::value_type;
+                std::vector<ResultColumn> columns;
+                columns.push_back({key_, std::vector<Key>(keys.begin(), keys.end())});
+                for (size_t a = 0; a < aggregates_.size(); ++a) {
+                    std::vector<double> values(keys.size());
+                    for (size_t g = 0; g < keys.size(); ++g) {
+                        values[g] = states[g * aggregates_.size() + a].finish(aggregates_[a].op);
+                    }
+                    columns.push_back({detail::aggregate_label(aggregates_[a]), std::move(values)});
+                }
+                sink(static_cast<const std::vector<ResultColumn>&>(columns));
+            };
+            return state.finish(emit);
+        }
+    }, state_);
+
+    state_ = std::monostate{};
+    rows_ = 0;
+    return result;
+}
+
+}
+
+#endif
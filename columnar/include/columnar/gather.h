@@ -0,0 +1,140 @@
+#ifndef COLUMNAR_GATHER_H
+#define COLUMNAR_GATHER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "columnar/cpu.h"
+
+namespace columnar {
+
+namespace detail {
+
+constexpr size_t kGatherPrefetchDistance = 16;
+
+template <typename T>
+inline void prefetch_read(const T* address) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address, 0, 1);
+#else
+    (void)address;
+#endif
+}
+
+#if COLUMNAR_HAS_AVX512_KERNELS
+template <typename T>
+COLUMNAR_TARGET_AVX512 size_t gather_avx512(const T* src, const size_t* indices, size_t count, T* dst) noexcept {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m512i offsets = _mm512_loadu_si512(indices + i);
+        if constexpr (sizeof(T) == 8) {
+            _mm512_storeu_si512(dst + i, _mm512_i64gather_epi64(offsets, src, 8));
+        } else {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm512_i64gather_epi32(offsets, src, 4));
+        }
+    }
+    return i;
+}
+#endif
+
+#if COLUMNAR_HAS_AVX2_KERNELS
+template <typename T>
+COLUMNAR_TARGET_AVX2 size_t gather_avx2(const T* src, const size_t* indices, size_t count, T* dst) noexcept {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m256i offsets = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices + i));
+        if constexpr (sizeof(T) == 8) {
+            const __m256i values = _mm256_i64gather_epi64(reinterpret_cast<const long long*>(src), offsets, 8);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), values);
+        } else {
+            const __m128i values = _mm256_i64gather_epi32(reinterpret_cast<const int*>(src), offsets, 4);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), values);
+        }
+    }
+    return i;
+}
+#endif
+
+// Vectorised part of gather for 32- and 64-bit element types, at the level
+// simd_level() selects. Returns the number of leading indices it handled;
+// the caller finishes the tail.
+template <typename T>
+inline size_t gather_simd(const T* src, const size_t* indices, size_t count, T* dst) noexcept {
+    static_assert(std::is_arithmetic_v<T>);
+    if constexpr (sizeof(size_t) != 8 || (sizeof(T) != 4 && sizeof(T) != 8)) {
+        (void)src;
+        (void)indices;
+        (void)count;
+        (void)dst;
+        return 0;
+    } else {
+        switch (simd_level()) {
+#if COLUMNAR_HAS_AVX512_KERNELS
+            case SimdLevel::Avx512:
+                return gather_avx512(src, indices, count, dst);
+#endif
+#if COLUMNAR_HAS_AVX2_KERNELS
+            case SimdLevel::Avx2:
+                return gather_avx2(src, indices, count, dst);
+#endif
+            default:
+                return 0;
+        }
+    }
+}
+
+}
+
+// dst[i] = src[indices[i]] for every i. `dst` must have room for
+// indices.size() elements and every index must be within src.
+template <typename T>
+void gather(std::span<const T> src, std::span<const size_t> indices, T* dst) {
+    const size_t count = indices.size();
+    size_t i = 0;
+
+    if constexpr (std::is_arithmetic_v<T>) {
+        i = detail::gather_simd(src.data(), indices.data(), count, dst);
+    }
+
+    for (; i < count; ++i) {
+        if (i + detail::kGatherPrefetchDistance < count) {
+            detail::prefetch_read(src.data() + indices[i + detail::kGatherPrefetchDistance]);
+        }
+        dst[i] = src[indices[i]];
+    }
+}
+
+template <typename T>
+[[nodiscard]] std::vector<T> gather(std::span<const T> src, std::span<const size_t> indices) {
+    std::vector<T> result(indices.size());
+    gather(src, indices, result.data());
+    return result;
+}
+
+// Resizes `dst` once and gathers into it, instead of growing it element by
+// element.
+template <typename T>
+void gather_into(std::span<const T> src, std::span<const size_t> indices, std::vector<T>& dst) {
+    dst.resize(indices.size());
+    gather(src, indices, dst.data());
+}
+
+// dst[indices[i]] = src[i] for every i.
+template <typename T>
+void scatter(std::span<const T> src, std::span<const size_t> indices, T* dst) {
+    const size_t count = std::min(src.size(), indices.size());
+    for (size_t i = 0; i < count; ++i) {
+        if (i + detail::kGatherPrefetchDistance < count) {
+            detail::prefetch_read(dst + indices[i + detail::kGatherPrefetchDistance]);
+        }
+        dst[indices[i]] = src[i];
+    }
+}
+
+}
+
+#endif
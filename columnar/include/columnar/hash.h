@@ -0,0 +1,70 @@
+#ifndef COLUMNAR_HASH_H
+#define COLUMNAR_HASH_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace columnar {
+
+// 64-bit FNV-1a. Used for cache keys and file names where stability across
+// runs matters more than speed.
+[[nodiscard]] inline uint64_t fingerprint(std::string_view canonical) noexcept {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : canonical) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// splitmix64 finalizer; spreads FNV output (and seeds) over all 64 bits so
+// that low bits are usable as partition numbers.
+[[nodiscard]] constexpr uint64_t mix64(uint64_t value) noexcept {
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ull;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebull;
+    value ^= value >> 31;
+    return value;
+}
+
+// Hash of a byte string that consumes eight bytes per multiply. Stable
+// across runs, but not across byte orders.
+[[nodiscard]] inline uint64_t hash_bytes(std::string_view bytes, uint64_t seed = 0) noexcept {
+    constexpr uint64_t kMultiplier = 0x9e3779b97f4a7c15ull;
+    uint64_t hash = seed ^ (bytes.size() * kMultiplier);
+    const char* data = bytes.data();
+    size_t remaining = bytes.size();
+    for (; remaining >= 8; data += 8, remaining -= 8) {
+        uint64_t word;
+        std::memcpy(&word, data, 8);
+        hash = (hash ^ mix64(word)) * kMultiplier;
+    }
+    if (remaining != 0) {
+        uint64_t word = 0;
+        std::memcpy(&word, data, remaining);
+        hash = (hash ^ mix64(word)) * kMultiplier;
+    }
+    return mix64(hash);
+}
+
+// Stable hash of a column value. Values that compare equal hash equally,
+// including 0.0 and -0.0. Different seeds give independent hashes.
+template <typename T>
+[[nodiscard]] uint64_t hash_value(const T& value, uint64_t seed = 0) noexcept {
+    if constexpr (std::is_same_v<T, std::string>) {
+        return hash_bytes(value, seed);
+    } else {
+        const T normalized = value == T{} ? T{} : value;
+        char bytes[sizeof(T)];
+        std::memcpy(bytes, &normalized, sizeof(T));
+        return mix64(fingerprint(std::string_view(bytes, sizeof(T))) + seed);
+    }
+}
+
+}
+
+#endif
@@ -0,0 +1,186 @@
+#ifndef COLUMNAR_INGEST_H
+#define COLUMNAR_INGEST_H
+
+#include "columnar/columnar.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace columnar {
+
+// Multi-producer ingestion front-end. Every producer owns a single-producer /
+// single-consumer ring of fixed-size batches laid out as columns; the consumer
+// merges published batches into a target Columnar. Memory is bounded by
+// producers * batches_per_producer * batch_rows rows, and a full ring pushes
+// back on its producer instead of growing.
+template <ColumnType... ColumnTypes>
+class IngestQueue {
+public:
+    struct Options {
+        size_t batch_rows = 4096;
+        size_t batches_per_producer = 8;
+    };
+
+    class Producer {
+    public:
+        [[nodiscard]] bool try_push(ColumnTypes... values);
+
+        void push(ColumnTypes... values);
+
+        [[nodiscard]] bool try_flush();
+
+        void flush();
+
+    private:
+        friend class IngestQueue;
+
+        static constexpr size_t kCacheLineSize = 64;
+
+        Producer(size_t batch_rows, size_t capacity);
+
+        [[nodiscard]] bool acquire_slot() noexcept;
+        void publish() noexcept;
+
+        std::vector<Columnar<ColumnTypes...>> ring_;
+        size_t batch_rows_;
+
+        alignas(kCacheLineSize) std::atomic<uint64_t> tail_{0};
+        uint64_t cached_head_{0};
+
+        alignas(kCacheLineSize) std::atomic<uint64_t> head_{0};
+    };
+
+    IngestQueue(size_t producer_count, Options options);
+    explicit IngestQueue(size_t producer_count) : IngestQueue(producer_count, Options{}) {}
+
+    [[nodiscard]] Producer& producer(size_t index) { return *producers_[index]; }
+
+    [[nodiscard]] size_t num_producers() const noexcept { return producers_.size(); }
+
+    size_t drain_into(Columnar<ColumnTypes...>& target);
+
+private:
+    std::vector<std::unique_ptr<Producer>> producers_;
+};
+
+template <ColumnType... ColumnTypes>
+IngestQueue<ColumnTypes...>::Producer::Producer(size_t batch_rows, size_t capacity)
+    : ring_(capacity), batch_rows_(batch_rows) {
+    for (auto& batch : ring_) {
+        batch.reserve(batch_rows_);
+    }
+}
+
+template <ColumnType... ColumnTypes>
+bool IngestQueue<ColumnTypes...>::Producer::acquire_slot() noexcept {
+    const uint64_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - cached_head_ < ring_.size()) {
+        return true;
+    }
+    cached_head_ = head_.load(std::memory_order_acquire);
+    return tail - cached_head_ < ring_.size();
+}
+
+template <ColumnType... ColumnTypes>
+void IngestQueue<ColumnTypes...>::Producer::publish() noexcept {
+    tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+template <ColumnType... ColumnTypes>
+bool IngestQueue<ColumnTypes...>::Producer::try_push(ColumnTypes... values) {
+    if (!acquire_slot()) {
+        return false;
+    }
+
+    auto& batch = ring_[tail_.load(std::memory_order_relaxed) % ring_.size()];
+    batch.append_row(std::move(values)...);
+    if (batch.num_rows() >= batch_rows_) {
+        publish();
+    }
+    return true;
+}
+
+template <ColumnType... ColumnTypes>
+void IngestQueue<ColumnTypes...>::Producer::push(ColumnTypes... values) {
+    while (!acquire_slot()) {
+        std::this_thread::yield();
+    }
+    const bool pushed = try_push(std::move(values)...);
+    (void)pushed;
+}
+
+template <ColumnType... ColumnTypes>
+bool IngestQueue<ColumnTypes...>::Producer::try_flush() {
+    if (!acquire_slot()) {
+        return false;
+    }
+    if (ring_[tail_.load(std::memory_order_relaxed) % ring_.size()].num_rows() > 0) {
+        publish();
+    }
+    return true;
+}
+
+template <ColumnType... ColumnTypes>
+void IngestQueue<ColumnTypes...>::Producer::flush() {
+    while (!try_flush()) {
+        std::this_thread::yield();
+    }
+}
+
+template <ColumnType... ColumnTypes>
+IngestQueue<ColumnTypes...>::IngestQueue(size_t producer_count, Options options) {
+    const size_t batch_rows = std::max<size_t>(options.batch_rows, 1);
+    const size_t capacity = std::max<size_t>(options.batches_per_producer, 1);
+
+    producers_.reserve(producer_count);
+    for (size_t i = 0; i < producer_count; ++i) {
+        producers_.push_back(std::unique_ptr<Producer>(new Producer(batch_rows, capacity)));
+    }
+}
+
+template <ColumnType... ColumnTypes>
+size_t IngestQueue<ColumnTypes...>::drain_into(Columnar<ColumnTypes...>& target) {
+    struct PendingRange {
+        Producer* producer;
+        uint64_t head;
+        uint64_t tail;
+    };
+
+    std::vector<PendingRange> pending;
+    pending.reserve(producers_.size());
+
+    size_t rows = 0;
+    for (auto& producer : producers_) {
+        const uint64_t head = producer->head_.load(std::memory_order_relaxed);
+        const uint64_t tail = producer->tail_.load(std::memory_order_acquire);
+        for (uint64_t i = head; i < tail; ++i) {
+            rows += producer->ring_[i % producer->ring_.size()].num_rows();
+        }
+        pending.push_back({producer.get(), head, tail});
+    }
+
+    if (rows == 0) {
+        return 0;
+    }
+    // No reserve: it would size `target` exactly, so every drain would copy
+    // everything drained before. append() grows the columns geometrically.
+
+    for (auto& [producer, head, tail] : pending) {
+        for (uint64_t i = head; i < tail; ++i) {
+            auto& batch = producer->ring_[i % producer->ring_.size()];
+            target.append(batch);
+            batch.clear();
+        }
+        producer->head_.store(tail, std::memory_order_release);
+    }
+
+    return rows;
+}
+
+}
+
+#endif
@@ -0,0 +1,148 @@
+#ifndef COLUMNAR_INTERNING_H
+#define COLUMNAR_INTERNING_H
+
+#include "columnar/columnar.h"
+#include "columnar/hash.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace columnar {
+
+// Per-row hashes of a string column, equal to hash_value(column[i], seed).
+// Computed once, they let later passes (interning, partitioning, repeated
+// group-bys) skip rehashing the strings.
+[[nodiscard]] inline std::vector<uint64_t> hash_strings(std::span<const std::string> column, uint64_t seed = 0) {
+    std::vector<uint64_t> hashes(column.size());
+    for (size_t row = 0; row < column.size(); ++row) {
+        hashes[row] = hash_bytes(column[row], seed);
+    }
+    return hashes;
+}
+
+// Maps strings to dense ids 0, 1, 2, ... in order of first appearance. One
+// interner shared by several tables gives equal strings equal ids in all of
+// them, so string keys can be grouped and joined as integers. Not
+// thread-safe.
+class StringInterner {
+public:
+    static constexpr uint32_t kInvalidId = ~uint32_t{0};
+
+    // Id of `value`, added if new. `hash` must be hash_bytes(value).
+    uint32_t intern(std::string_view value, uint64_t hash);
+    uint32_t intern(std::string_view value) { return intern(value, hash_bytes(value)); }
+
+    [[nodiscard]] std::optional<uint32_t> find(std::string_view value) const;
+
+    [[nodiscard]] const std::string& value(uint32_t id) const { return values_[id]; }
+
+    [[nodiscard]] size_t size() const noexcept { return values_.size(); }
+
+    // Ids of every row of `column`, interning values not seen before.
+    [[nodiscard]] std::vector<uint32_t> intern_all(std::span<const std::string> column);
+
+    void clear() noexcept {
+        values_.clear();
+        slots_.clear();
+    }
+
+private:
+    struct Slot {
+        uint64_t hash;
+        uint32_t id;
+    };
+
+    [[nodiscard]] size_t probe(std::string_view value, uint64_t hash) const noexcept;
+    void grow();
+
+    std::vector<std::string> values_;
+    // Open addressing with linear probing; capacity is a power of two kept
+    // at least twice the number of values.
+    std::vector<Slot> slots_;
+};
+
+inline size_t StringInterner::probe(std::string_view value, uint64_t hash) const noexcept {
+    const size_t mask = slots_.size() - 1;
+    for (size_t index = static_cast<size_t>(hash) & mask;; index = (index + 1) & mask) {
+        const Slot& slot = slots_[index];
+        if (slot.id == kInvalidId || (slot.hash == hash && values_[slot.id] == value)) {
+            return index;
+        }
+    }
+}
+
+inline void StringInterner::grow() {
+    std::vector<Slot> old = std::move(slots_);
+    slots_.assign(std::max<size_t>(old.size() * 2, 64), Slot{0, kInvalidId});
+    const size_t mask = slots_.size() - 1;
+    for (const Slot& slot : old) {
+        if (slot.id == kInvalidId) {
+            continue;
+        }
+        size_t index = static_cast<size_t>(slot.hash) & mask;
+        while (slots_[index].id != kInvalidId) {
+            index = (index + 1) & mask;
+        }
+        slots_[index] = slot;
+    }
+}
+
+inline uint32_t StringInterner::intern(std::string_view value, uint64_t hash) {
+    if ((values_.size() + 1) * 2 > slots_.size()) {
+        grow();
+    }
+    Slot& slot = slots_[probe(value, hash)];
+    if (slot.id == kInvalidId) {
+        slot = {hash, static_cast<uint32_t>(values_.size())};
+        values_.emplace_back(value);
+    }
+    return slot.id;
+}
+
+inline std::optional<uint32_t> StringInterner::find(std::string_view value) const {
+    if (slots_.empty()) {
+        return std::nullopt;
+    }
+    const Slot& slot = slots_[probe(value, hash_bytes(value))];
+    return slot.id == kInvalidId ? std::nullopt : std::optional<uint32_t>(slot.id);
+}
+
+inline std::vector<uint32_t> StringInterner::intern_all(std::span<const std::string> column) {
+    const auto hashes = hash_strings(column);
+    std::vector<uint32_t> ids(column.size());
+    for (size_t row = 0; row < column.size(); ++row) {
+        ids[row] = intern(column[row], hashes[row]);
+    }
+    return ids;
+}
+
+// Interns the string column `name` of `table`. Fails with ColumnNotFound, or
+// ParseError if the column does not hold strings.
+template <typename Table>
+[[nodiscard]] Expected<std::vector<uint32_t>, CsvError>
+intern_column(const Table& table, std::string_view name, StringInterner& interner) {
+    using Result = Expected<std::vector<uint32_t>, CsvError>;
+
+    std::optional<std::vector<uint32_t>> ids;
+    const bool found = table.visit_column(name, [&](auto column) {
+        if constexpr (std::is_same_v<typename decltype(column)::value_type, std::string>) {
+            ids = interner.intern_all(column);
+        }
+    });
+    if (!found) {
+        return Result(CsvError::ColumnNotFound);
+    }
+    if (!ids) {
+        return Result(CsvError::ParseError);
+    }
+    return Result(std::move(*ids));
+}
+
+}
+
+#endif
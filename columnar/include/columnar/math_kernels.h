@@ -0,0 +1,535 @@
+#ifndef COLUMNAR_MATH_KERNELS_H
+#define COLUMNAR_MATH_KERNELS_H
+
+#include "columnar/cpu.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <vector>
+
+// The polynomial kernels need GCC/Clang vector types; elsewhere every level
+// runs the std:: loop.
+#if COLUMNAR_X86_DISPATCH
+#define COLUMNAR_HAS_VECTOR_MATH 1
+#else
+#define COLUMNAR_HAS_VECTOR_MATH 0
+#endif
+
+namespace columnar {
+
+namespace detail {
+
+#if COLUMNAR_X86_DISPATCH
+// GCC/Clang vector types of N doubles. The lane bodies below are written once
+// against them and inlined into the AVX2 and AVX-512 wrappers, which is where
+// the instructions are chosen; they take and return no vectors by value, so
+// nothing crosses a function boundary without AVX. Both levels use 4 lanes:
+// without AVX-512DQ, GCC turns comparison masks of 8 doubles into scalar
+// code, while 4-lane bodies built for AVX-512 still gain its encodings and
+// 32 registers.
+template <size_t N>
+struct MathLanes;
+
+template <>
+struct MathLanes<4> {
+    typedef double F __attribute__((vector_size(32)));
+    typedef int64_t I __attribute__((vector_size(32)));
+    typedef uint64_t U __attribute__((vector_size(32)));
+};
+
+template <typename V>
+__attribute__((always_inline)) inline void load_lanes(V& v, const double* p) noexcept {
+    std::memcpy(&v, p, sizeof(V));
+}
+
+template <typename V>
+__attribute__((always_inline)) inline void store_lanes(double* p, const V& v) noexcept {
+    std::memcpy(p, &v, sizeof(V));
+}
+
+// Bit i set if lane i of a comparison mask is set.
+template <size_t N, typename I>
+__attribute__((always_inline)) inline uint32_t lane_bits(const I& mask) noexcept {
+    uint32_t bits = 0;
+    for (size_t lane = 0; lane < N; ++lane) {
+        bits |= static_cast<uint32_t>(mask[lane] != 0) << lane;
+    }
+    return bits;
+}
+#endif
+
+// exp: x = k ln2 + r with |r| <= ln2 / 2 (Cody-Waite, ln2 split in two so
+// k * ln2_hi is exact), exp(r) by its Taylor series to r^13, whose
+// truncation error is below 2^-58, then scaled by 2^k through the exponent
+// bits.
+constexpr double kLog2e = 0x1.71547652b82fep0;
+constexpr double kLn2Hi = 0x1.62e42fefa3800p-1;
+constexpr double kLn2Lo = 0x1.ef35793c76730p-45;
+constexpr double kRoundShift = 0x1.8p52;
+// 1 / n! for n = 2..13.
+constexpr double kExpCoefficients[] = {1.0 / 2,         1.0 / 6,          1.0 / 24,        1.0 / 120,
+                                       1.0 / 720,       1.0 / 5040,       1.0 / 40320,     1.0 / 362880,
+                                       1.0 / 3628800,   1.0 / 39916800,   1.0 / 479001600, 1.0 / 6227020800};
+
+// log: x = 2^k m with m in [sqrt(2)/2, sqrt(2)), f = m - 1, s = f / (2 + f)
+// and log(1 + f) = f - (f^2/2 - s (f^2/2 + R(s^2))), R the fdlibm minimax
+// polynomial.
+constexpr double kSqrt2 = 0x1.6a09e667f3bcdp0;
+constexpr double kLogLg1 = 6.666666666666735130e-01;
+constexpr double kLogLg2 = 3.999999999940941908e-01;
+constexpr double kLogLg3 = 2.857142874366239149e-01;
+constexpr double kLogLg4 = 2.222219843214978396e-01;
+constexpr double kLogLg5 = 1.818357216161805012e-01;
+constexpr double kLogLg6 = 1.531383769920937332e-01;
+constexpr double kLogLg7 = 1.479819860511658591e-01;
+constexpr double kLogLn2Hi = 6.93147180369123816490e-01;
+constexpr double kLogLn2Lo = 1.90821492927058770002e-10;
+
+// atan2: t = min(|x|, |y|) / max(|x|, |y|) in [0, 1], reduced to
+// (t - 1) / (t + 1) around pi/4 above 0.66, atan by the Cephes rational
+// approximation, then mapped to the quadrant.
+constexpr double kAtanP[] = {-8.750608600031904122785e-01, -1.615753718733365076637e+01,
+                             -7.500855792314704667340e+01, -1.228866684490136173410e+02,
+                             -6.485021904942025371773e+01};
+constexpr double kAtanQ[] = {2.485846490142306297962e+01, 1.650270098316988542046e+02,
+                             4.328810604912902668951e+02, 4.853903996359136964868e+02,
+                             1.945506571482613964425e+02};
+constexpr double kPiOver4 = 7.85398163397448309616e-01;
+constexpr double kPiOver4Lo = 3.061616997868382943065e-17;
+constexpr double kPiOver2Hi = 1.57079632679489655800e+00;
+constexpr double kPiOver2Lo = 6.12323399573676603587e-17;
+constexpr double kPiHi = 3.14159265358979311600e+00;
+constexpr double kPiLo = 1.22464679914735317720e-16;
+
+#if COLUMNAR_X86_DISPATCH
+template <size_t N>
+__attribute__((always_inline)) inline void exp_body(const double* x, size_t count, double* out) noexcept {
+    using F = typename MathLanes<N>::F;
+    using I = typename MathLanes<N>::I;
+    const I one_bits = (I)(F{} + 1.0);
+    size_t i = 0;
+    for (; i + N <= count; i += N) {
+        F v;
+        load_lanes(v, x + i);
+        // Beyond 708 the result or 2^k leaves the normal range.
+        const I fast = (v <= 708.0) & (v >= -708.0);
+        const F shifted = v * kLog2e + kRoundShift;
+        const I k = (I)shifted - (I)(F{} + kRoundShift);
+        const F kd = shifted - kRoundShift;
+        const F r = (v - kd * kLn2Hi) - kd * kLn2Lo;
+        // exp(r) - 1 - r, by Horner from the r^13 term down.
+        const double* c = kExpCoefficients;
+        F p = c[10] + r * c[11];
+        p = c[9] + r * p;
+        p = c[8] + r * p;
+        p = c[7] + r * p;
+        p = c[6] + r * p;
+        p = c[5] + r * p;
+        p = c[4] + r * p;
+        p = c[3] + r * p;
+        p = c[2] + r * p;
+        p = c[1] + r * p;
+        p = c[0] + r * p;
+        const F result = (1.0 + (r + r * r * p)) * (F)((k << 52) + one_bits);
+        store_lanes(out + i, fast ? result : F{});
+        if (uint32_t bad = ~lane_bits<N>(fast) & ((1u << N) - 1)) {
+            for (; bad != 0; bad &= bad - 1) {
+                const size_t lane = static_cast<size_t>(std::countr_zero(bad));
+                out[i + lane] = std::exp(v[lane]);
+            }
+        }
+    }
+    for (; i < count; ++i) {
+        out[i] = std::exp(x[i]);
+    }
+}
+
+template <size_t N>
+__attribute__((always_inline)) inline void log_body(const double* x, size_t count, double* out) noexcept {
+    using F = typename MathLanes<N>::F;
+    using I = typename MathLanes<N>::I;
+    using U = typename MathLanes<N>::U;
+    const U mantissa_mask = (U)(I{} + 0x000fffffffffffffll);
+    const U one_bits = (U)(F{} + 1.0);
+    const U exponent_base = (U)(F{} + 0x1p52);
+    size_t i = 0;
+    for (; i + N <= count; i += N) {
+        F v;
+        load_lanes(v, x + i);
+        // Zeros, subnormals, negatives, infinities and NaN go to std::log.
+        const I fast = (v >= std::numeric_limits<double>::min()) & (v <= std::numeric_limits<double>::max());
+        const U bits = (U)v;
+        // Biased exponent as a double: 2^52 + e - 2^52, exact.
+        F k = ((F)((bits >> 52) | exponent_base) - 0x1p52) - 1023.0;
+        F m = (F)((bits & mantissa_mask) | one_bits);
+        const I high = m > kSqrt2;
+        m = high ? m * 0.5 : m;
+        k = high ? k + 1.0 : k;
+        const F f = m - 1.0;
+        const F s = f / (2.0 + f);
+        const F z = s * s;
+        const F w = z * z;
+        const F r = z * (kLogLg1 + w * (kLogLg3 + w * (kLogLg5 + w * kLogLg7))) +
+                    w * (kLogLg2 + w * (kLogLg4 + w * kLogLg6));
+        const F half_square = 0.5 * f * f;
+        const F result = k * kLogLn2Hi - ((half_square - (s * (half_square + r) + k * kLogLn2Lo)) - f);
+        store_lanes(out + i, fast ? result : F{});
+        if (uint32_t bad = ~lane_bits<N>(fast) & ((1u << N) - 1)) {
+            for (; bad != 0; bad &= bad - 1) {
+                const size_t lane = static_cast<size_t>(std::countr_zero(bad));
+                out[i + lane] = std::log(v[lane]);
+            }
+        }
+    }
+    for (; i < count; ++i) {
+        out[i] = std::log(x[i]);
+    }
+}
+
+template <size_t N>
+__attribute__((always_inline)) inline void atan2_body(const double* y, const double* x, size_t count,
+                                                      double* out) noexcept {
+    using F = typename MathLanes<N>::F;
+    using I = typename MathLanes<N>::I;
+    using U = typename MathLanes<N>::U;
+    const U sign_mask = (U)(I{} + std::numeric_limits<int64_t>::min());
+    size_t i = 0;
+    for (; i + N <= count; i += N) {
+        F vy;
+        load_lanes(vy, y + i);
+        F vx;
+        load_lanes(vx, x + i);
+        const F a = (F)((U)vx & ~sign_mask);
+        const F b = (F)((U)vy & ~sign_mask);
+        const I swapped = b > a;
+        const F low = swapped ? a : b;
+        const F high = swapped ? b : a;
+        // Both zero, an infinity or a NaN go to std::atan2.
+        const I fast = (high <= std::numeric_limits<double>::max()) & (high > 0.0);
+
+        // (t - 1) / (t + 1) formed from the inputs, not the rounded t.
+        const I reduced = low > 0.66 * high;
+        const F u = reduced ? (low - high) / (low + high) : low / high;
+        const F z = u * u;
+        const F p = (((kAtanP[0] * z + kAtanP[1]) * z + kAtanP[2]) * z + kAtanP[3]) * z + kAtanP[4];
+        const F q = ((((z + kAtanQ[0]) * z + kAtanQ[1]) * z + kAtanQ[2]) * z + kAtanQ[3]) * z + kAtanQ[4];
+        F angle = u + u * (z * p / q);
+        angle = reduced ? kPiOver4 + (angle + kPiOver4Lo) : angle;
+        angle = swapped ? kPiOver2Hi - (angle - kPiOver2Lo) : angle;
+        angle = vx < 0.0 ? kPiHi - (angle - kPiLo) : angle;
+        const F result = (F)((U)angle | ((U)vy & sign_mask));
+        store_lanes(out + i, fast ? result : F{});
+        if (uint32_t bad = ~lane_bits<N>(fast) & ((1u << N) - 1)) {
+            for (; bad != 0; bad &= bad - 1) {
+                const size_t lane = static_cast<size_t>(std::countr_zero(bad));
+                out[i + lane] = std::atan2(vy[lane], vx[lane]);
+            }
+        }
+    }
+    for (; i < count; ++i) {
+        out[i] = std::atan2(y[i], x[i]);
+    }
+}
+
+// x^2 + y^2 over whole groups of N elements. Lanes whose larger argument
+// lies outside [2^-500, 2^500], where the squares could overflow or lose
+// it to underflow, get std::hypot saved to `fallback` and their bits in
+// `lanes[group]` before `out` is written, so `out` may alias `x` or `y`.
+// Returns a bit per group holding such a lane; `count` is at most 64 N.
+template <size_t N>
+__attribute__((always_inline)) inline uint64_t sum_squares_body(const double* x, const double* y, size_t count,
+                                                                double* out, double* fallback,
+                                                                uint32_t* lanes) noexcept {
+    using F = typename MathLanes<N>::F;
+    using I = typename MathLanes<N>::I;
+    using U = typename MathLanes<N>::U;
+    const U sign_mask = (U)(I{} + std::numeric_limits<int64_t>::min());
+    uint64_t groups = 0;
+    for (size_t i = 0; i + N <= count; i += N) {
+        F vx;
+        load_lanes(vx, x + i);
+        F vy;
+        load_lanes(vy, y + i);
+        const F a = (F)((U)vx & ~sign_mask);
+        const F b = (F)((U)vy & ~sign_mask);
+        const F m = a > b ? a : b;
+        const I fast = (m <= 0x1p500) & (m >= 0x1p-500);
+        if (uint32_t bad = ~lane_bits<N>(fast) & ((1u << N) - 1)) {
+            groups |= uint64_t{1} << (i / N);
+            lanes[i / N] = bad;
+            for (; bad != 0; bad &= bad - 1) {
+                const size_t lane = static_cast<size_t>(std::countr_zero(bad));
+                fallback[i + lane] = std::hypot(vx[lane], vy[lane]);
+            }
+        }
+        store_lanes(out + i, vx * vx + vy * vy);
+    }
+    return groups;
+}
+#endif
+
+#if COLUMNAR_HAS_AVX512_KERNELS
+COLUMNAR_TARGET_AVX512 inline void sqrt_avx512(const double* x, size_t count, double* out) noexcept {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        // The zero-masking form: GCC 12 flags the plain one's undefined
+        // source as maybe-uninitialized.
+        _mm512_storeu_pd(out + i, _mm512_maskz_sqrt_pd(0xff, _mm512_loadu_pd(x + i)));
+    }
+    for (; i < count; ++i) {
+        out[i] = std::sqrt(x[i]);
+    }
+}
+#endif
+
+#if COLUMNAR_HAS_AVX2_KERNELS
+COLUMNAR_TARGET_AVX2 inline void sqrt_avx2(const double* x, size_t count, double* out) noexcept {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm256_storeu_pd(out + i, _mm256_sqrt_pd(_mm256_loadu_pd(x + i)));
+    }
+    for (; i < count; ++i) {
+        out[i] = std::sqrt(x[i]);
+    }
+}
+#endif
+
+#if COLUMNAR_X86_DISPATCH
+// Squares summed by the lane body and rooted by `Root` in blocks of 64
+// groups, then the out-of-range lanes patched from the fallback buffer.
+// The tail shorter than N uses std::hypot.
+template <size_t N, void (*Root)(const double*, size_t, double*) noexcept>
+__attribute__((always_inline)) inline void hypot_body(const double* x, const double* y, size_t count,
+                                                      double* out) noexcept {
+    double fallback[64 * N];
+    uint32_t lanes[64];
+    const size_t whole = count / N * N;
+    for (size_t begin = 0; begin < whole; begin += 64 * N) {
+        const size_t length = std::min(whole - begin, 64 * N);
+        const uint64_t groups = sum_squares_body<N>(x + begin, y + begin, length, out + begin, fallback, lanes);
+        Root(out + begin, length, out + begin);
+        for (uint64_t word = groups; word != 0; word &= word - 1) {
+            const size_t group = static_cast<size_t>(std::countr_zero(word));
+            for (uint32_t bad = lanes[group]; bad != 0; bad &= bad - 1) {
+                const size_t j = group * N + static_cast<size_t>(std::countr_zero(bad));
+                out[begin + j] = fallback[j];
+            }
+        }
+    }
+    for (size_t i = whole; i < count; ++i) {
+        out[i] = std::hypot(x[i], y[i]);
+    }
+}
+#endif
+
+#if COLUMNAR_HAS_AVX512_KERNELS && COLUMNAR_X86_DISPATCH
+COLUMNAR_TARGET_AVX512 inline void exp_avx512(const double* x, size_t count, double* out) noexcept {
+    exp_body<4>(x, count, out);
+}
+
+COLUMNAR_TARGET_AVX512 inline void log_avx512(const double* x, size_t count, double* out) noexcept {
+    log_body<4>(x, count, out);
+}
+
+COLUMNAR_TARGET_AVX512 inline void atan2_avx512(const double* y, const double* x, size_t count, double* out) noexcept {
+    atan2_body<4>(y, x, count, out);
+}
+
+COLUMNAR_TARGET_AVX512 inline void hypot_avx512(const double* x, const double* y, size_t count, double* out) noexcept {
+    hypot_body<4, sqrt_avx512>(x, y, count, out);
+}
+#endif
+
+#if COLUMNAR_HAS_AVX2_KERNELS && COLUMNAR_X86_DISPATCH
+COLUMNAR_TARGET_AVX2 inline void exp_avx2(const double* x, size_t count, double* out) noexcept {
+    exp_body<4>(x, count, out);
+}
+
+COLUMNAR_TARGET_AVX2 inline void log_avx2(const double* x, size_t count, double* out) noexcept {
+    log_body<4>(x, count, out);
+}
+
+COLUMNAR_TARGET_AVX2 inline void atan2_avx2(const double* y, const double* x, size_t count, double* out) noexcept {
+    atan2_body<4>(y, x, count, out);
+}
+
+COLUMNAR_TARGET_AVX2 inline void hypot_avx2(const double* x, const double* y, size_t count, double* out) noexcept {
+    hypot_body<4, sqrt_avx2>(x, y, count, out);
+}
+#endif
+
+}
+
+// out[i] = f(x[i]) for each element, at the level simd_level() selects.
+// `out` must hold x.size() values and may be `x` itself. The AVX2 and
+// AVX-512 kernels both evaluate polynomials over 4 lanes, built for their
+// own instruction set; values outside their range (overflow, subnormals,
+// zeros, infinities, NaN) take the std:: function, as does every element at
+// the scalar level. The tests hold them to the std:: result within 1 ulp for
+// exp, log and hypot and 2 ulp for atan2; sqrt is the hardware instruction
+// and exact.
+inline void vector_sqrt(std::span<const double> x, std::span<double> out) noexcept {
+    switch (simd_level()) {
+#if COLUMNAR_HAS_AVX512_KERNELS
+        case SimdLevel::Avx512:
+            detail::sqrt_avx512(x.data(), x.size(), out.data());
+            return;
+#endif
+#if COLUMNAR_HAS_AVX2_KERNELS
+        case SimdLevel::Avx2:
+            detail::sqrt_avx2(x.data(), x.size(), out.data());
+            return;
+#endif
+        default:
+            for (size_t i = 0; i < x.size(); ++i) {
+                out[i] = std::sqrt(x[i]);
+            }
+            return;
+    }
+}
+
+inline void vector_exp(std::span<const double> x, std::span<double> out) noexcept {
+    switch (simd_level()) {
+#if COLUMNAR_HAS_AVX512_KERNELS && COLUMNAR_HAS_VECTOR_MATH
+        case SimdLevel::Avx512:
+            detail::exp_avx512(x.data(), x.size(), out.data());
+            return;
+#endif
+#if COLUMNAR_HAS_AVX2_KERNELS && COLUMNAR_HAS_VECTOR_MATH
+        case SimdLevel::Avx2:
+            detail::exp_avx2(x.data(), x.size(), out.data());
+            return;
+#endif
+        default:
+            for (size_t i = 0; i < x.size(); ++i) {
+                out[i] = std::exp(x[i]);
+            }
+            return;
+    }
+}
+
+inline void vector_log(std::span<const double> x, std::span<double> out) noexcept {
+    switch (simd_level()) {
+#if COLUMNAR_HAS_AVX512_KERNELS && COLUMNAR_HAS_VECTOR_MATH
+        case SimdLevel::Avx512:
+            detail::log_avx512(x.data(), x.size(), out.data());
+            return;
+#endif
+#if COLUMNAR_HAS_AVX2_KERNELS && COLUMNAR_HAS_VECTOR_MATH
+        case SimdLevel::Avx2:
+            detail::log_avx2(x.data(), x.size(), out.data());
+            return;
+#endif
+        default:
+            for (size_t i = 0; i < x.size(); ++i) {
+                out[i] = std::log(x[i]);
+            }
+            return;
+    }
+}
+
+// out[i] = atan2(y[i], x[i]), in [-pi, pi].
+inline void vector_atan2(std::span<const double> y, std::span<const double> x, std::span<double> out) noexcept {
+    switch (simd_level()) {
+#if COLUMNAR_HAS_AVX512_KERNELS && COLUMNAR_HAS_VECTOR_MATH
+        case SimdLevel::Avx512:
+            detail::atan2_avx512(y.data(), x.data(), x.size(), out.data());
+            return;
+#endif
+#if COLUMNAR_HAS_AVX2_KERNELS && COLUMNAR_HAS_VECTOR_MATH
+        case SimdLevel::Avx2:
+            detail::atan2_avx2(y.data(), x.data(), x.size(), out.data());
+            return;
+#endif
+        default:
+            for (size_t i = 0; i < x.size(); ++i) {
+                out[i] = std::atan2(y[i], x[i]);
+            }
+            return;
+    }
+}
+
+// out[i] = sqrt(x[i]^2 + y[i]^2) without intermediate overflow.
+inline void vector_hypot(std::span<const double> x, std::span<const double> y, std::span<double> out) noexcept {
+    switch (simd_level()) {
+#if COLUMNAR_HAS_AVX512_KERNELS && COLUMNAR_HAS_VECTOR_MATH
+        case SimdLevel::Avx512:
+            detail::hypot_avx512(x.data(), y.data(), x.size(), out.data());
+            return;
+#endif
+#if COLUMNAR_HAS_AVX2_KERNELS && COLUMNAR_HAS_VECTOR_MATH
+        case SimdLevel::Avx2:
+            detail::hypot_avx2(x.data(), y.data(), x.size(), out.data());
+            return;
+#endif
+        default:
+            for (size_t i = 0; i < x.size(); ++i) {
+                out[i] = std::hypot(x[i], y[i]);
+            }
+            return;
+    }
+}
+
+// Derived kinematic columns from momentum components (and energy), built on
+// the kernels above. Inputs are columns of equal length.
+
+// pT = hypot(px, py).
+[[nodiscard]] inline std::vector<double> transverse_momentum(std::span<const double> px, std::span<const double> py) {
+    std::vector<double> pt(px.size());
+    vector_hypot(px, py, pt);
+    return pt;
+}
+
+// |p| = hypot(pT, pz).
+[[nodiscard]] inline std::vector<double> total_momentum(std::span<const double> px, std::span<const double> py,
+                                                        std::span<const double> pz) {
+    auto p = transverse_momentum(px, py);
+    vector_hypot(p, pz, p);
+    return p;
+}
+
+// phi = atan2(py, px), in [-pi, pi].
+[[nodiscard]] inline std::vector<double> azimuth(std::span<const double> px, std::span<const double> py) {
+    std::vector<double> phi(px.size());
+    vector_atan2(py, px, phi);
+    return phi;
+}
+
+// eta = asinh(pz / pT), evaluated as sign(pz) log((|p| + |pz|) / pT) so
+// that backward particles do not cancel. +-inf along the beam axis, NaN for
+// zero momentum.
+[[nodiscard]] inline std::vector<double> pseudorapidity(std::span<const double> px, std::span<const double> py,
+                                                        std::span<const double> pz) {
+    const auto pt = transverse_momentum(px, py);
+    std::vector<double> eta(pt.size());
+    vector_hypot(pt, pz, eta);
+    for (size_t i = 0; i < eta.size(); ++i) {
+        eta[i] = (eta[i] + std::fabs(pz[i])) / pt[i];
+    }
+    vector_log(eta, eta);
+    for (size_t i = 0; i < eta.size(); ++i) {
+        eta[i] = std::copysign(eta[i], pz[i]);
+    }
+    return eta;
+}
+
+// m = sqrt(E^2 - |p|^2), with E^2 - |p|^2 formed as (E - |p|)(E + |p|). NaN
+// where the four-vector is spacelike.
+[[nodiscard]] inline std::vector<double> invariant_mass(std::span<const double> energy, std::span<const double> px,
+                                                        std::span<const double> py, std::span<const double> pz) {
+    auto mass = total_momentum(px, py, pz);
+    for (size_t i = 0; i < mass.size(); ++i) {
+        mass[i] = (energy[i] - mass[i]) * (energy[i] + mass[i]);
+    }
+    vector_sqrt(mass, mass);
+    return mass;
+}
+
+}
+
+#endif
@@ -0,0 +1,348 @@
+#ifndef COLUMNAR_NUMA_H
+#define COLUMNAR_NUMA_H
+
+#include "columnar/csv_reader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace columnar {
+
+// CPUs of every NUMA node as reported by /sys/devices/system/node. Machines
+// without NUMA information (and every non-Linux platform) are described as a
+// single node owning all hardware threads, which turns pinning and memory
+// binding into no-ops.
+class NumaTopology {
+public:
+    [[nodiscard]] static const NumaTopology& system();
+
+    [[nodiscard]] static NumaTopology single_node(size_t cpu_count);
+
+    [[nodiscard]] static NumaTopology from_nodes(std::vector<std::vector<int>> node_cpus);
+
+    [[nodiscard]] size_t node_count() const noexcept { return node_cpus_.size(); }
+
+    [[nodiscard]] const std::vector<int>& cpus(size_t node) const { return node_cpus_[node]; }
+
+    [[nodiscard]] bool is_numa() const noexcept { return node_cpus_.size() > 1; }
+
+private:
+    static std::vector<int> parse_cpu_list(const std::string& list);
+
+    std::vector<std::vector<int>> node_cpus_;
+};
+
+inline NumaTopology NumaTopology::single_node(size_t cpu_count) {
+    NumaTopology topology;
+    topology.node_cpus_.emplace_back();
+    for (size_t cpu = 0; cpu < std::max<size_t>(cpu_count, 1); ++cpu) {
+        topology.node_cpus_.back().push_back(static_cast<int>(cpu));
+    }
+    return topology;
+}
+
+inline NumaTopology NumaTopology::from_nodes(std::vector<std::vector<int>> node_cpus) {
+    NumaTopology topology;
+    topology.node_cpus_ = std::move(node_cpus);
+    if (topology.node_cpus_.empty()) {
+        topology.node_cpus_.emplace_back(1, 0);
+    }
+    return topology;
+}
+
+inline std::vector<int> NumaTopology::parse_cpu_list(const std::string& list) {
+    std::vector<int> cpus;
+    size_t pos = 0;
+    while (pos < list.size()) {
+        size_t end = list.find(',', pos);
+        if (end == std::string::npos) {
+            end = list.size();
+        }
+        std::string_view item(list.data() + pos, end - pos);
+        pos = end + 1;
+
+        int first = 0;
+        int last = 0;
+        auto dash = item.find('-');
+        auto first_part = item.substr(0, dash);
+        if (std::from_chars(first_part.data(), first_part.data() + first_part.size(), first).ec != std::errc{}) {
+            continue;
+        }
+        last = first;
+        if (dash != std::string_view::npos) {
+            auto last_part = item.substr(dash + 1);
+            if (std::from_chars(last_part.data(), last_part.data() + last_part.size(), last).ec != std::errc{}) {
+                continue;
+            }
+        }
+        for (int cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+inline const NumaTopology& NumaTopology::system() {
+    static const NumaTopology topology = [] {
+        NumaTopology detected;
+#if defined(__linux__)
+        for (size_t node = 0;; ++node) {
+            std::ifstream cpulist("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+            if (!cpulist.is_open()) {
+                break;
+            }
+            std::string list;
+            std::getline(cpulist, list);
+            auto cpus = parse_cpu_list(list);
+            if (!cpus.empty()) {
+                detected.node_cpus_.push_back(std::move(cpus));
+            }
+        }
+#endif
+        if (detected.node_cpus_.empty()) {
+            return single_node(std::thread::hardware_concurrency());
+        }
+        return detected;
+    }();
+    return topology;
+}
+
+// Restricts the calling thread to the CPUs of `node`. Returns false when the
+// platform does not support affinity or the kernel rejects the mask.
+inline bool pin_current_thread_to_node(const NumaTopology& topology, size_t node) noexcept {
+#if defined(__linux__)
+    if (!topology.is_numa() || node >= topology.node_count()) {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : topology.cpus(node)) {
+        if (cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &set);
+        }
+    }
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    (void)topology;
+    (void)node;
+    return false;
+#endif
+}
+
+// Binds (and migrates) the pages fully contained in [data, data + bytes) to
+// `node` through mbind(2), without requiring libnuma.
+inline bool bind_memory_to_node(const void* data, size_t bytes, size_t node) noexcept {
+#if defined(__linux__) && defined(SYS_mbind)
+    constexpr int kMpolBind = 2;
+    constexpr unsigned kMpolMfMove = 1u << 1;
+    constexpr size_t kMaskBits = 8 * sizeof(unsigned long);
+
+    if (node >= kMaskBits) {
+        return false;
+    }
+
+    const auto page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    const auto begin = (reinterpret_cast<uintptr_t>(data) + page_size - 1) & ~(page_size - 1);
+    const auto end = (reinterpret_cast<uintptr_t>(data) + bytes) & ~(page_size - 1);
+    if (end <= begin) {
+        return false;
+    }
+
+    unsigned long node_mask = 1ul << node;
+    return syscall(SYS_mbind, begin, end - begin, kMpolBind, &node_mask, kMaskBits + 1, kMpolMfMove) == 0;
+#else
+    (void)data;
+    (void)bytes;
+    (void)node;
+    return false;
+#endif
+}
+
+struct NumaPartition {
+    size_t node;
+    size_t begin_row;
+    size_t end_row;
+};
+
+template <ColumnType... ColumnTypes>
+struct NumaTable {
+    Columnar<ColumnTypes...> table;
+    std::vector<NumaPartition> partitions;
+};
+
+// Loads the CSV with one group of worker threads per NUMA node, each pinned to
+// its node. Every node parses a contiguous slice of the file. The result's
+// numeric columns are reserved and each slice's pages bound to its node before
+// anything is written to them, so they are allocated there; the threads that
+// parsed a slice then copy it into its rows. On single-node machines this is
+// a plain parallel load.
+template <ColumnType... ColumnTypes>
+[[nodiscard]] Expected<NumaTable<ColumnTypes...>, CsvError>
+try_read_from_csv_numa(const std::filesystem::path& filepath, size_t threads_per_node = 0,
+                       const NumaTopology& topology = NumaTopology::system()) {
+    using Result = Expected<NumaTable<ColumnTypes...>, CsvError>;
+    using Piece = Expected<Columnar<ColumnTypes...>, CsvError>;
+
+    const size_t node_count = topology.node_count();
+    std::vector<size_t> workers(node_count);
+    size_t total_workers = 0;
+    for (size_t node = 0; node < node_count; ++node) {
+        workers[node] = threads_per_node != 0 ? threads_per_node : std::max<size_t>(topology.cpus(node).size(), 1);
+        total_workers += workers[node];
+    }
+
+    auto layout = try_split_csv(filepath, total_workers);
+    if (!layout) {
+        return Result(layout.error());
+    }
+    auto names = Columnar<ColumnTypes...>::try_parse_csv_header(layout->header);
+    if (!names) {
+        return Result(names.error());
+    }
+
+    std::vector<std::optional<Piece>> pieces(total_workers);
+    std::vector<size_t> piece_node(total_workers);
+    {
+        std::vector<std::thread> threads;
+        size_t piece = 0;
+        for (size_t node = 0; node < node_count; ++node) {
+            for (size_t w = 0; w < workers[node]; ++w, ++piece) {
+                piece_node[piece] = node;
+                threads.emplace_back([&, node, piece] {
+                    pin_current_thread_to_node(topology, node);
+                    pieces[piece].emplace(
+                        try_read_csv_range<ColumnTypes...>(filepath, *names, layout->ranges[piece]));
+                });
+            }
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    NumaTable<ColumnTypes...> result;
+    std::vector<size_t> piece_begin(pieces.size() + 1, 0);
+    for (size_t piece = 0; piece < pieces.size(); ++piece) {
+        if (!*pieces[piece]) {
+            return Result((*pieces[piece]).error());
+        }
+        const size_t begin_row = piece_begin[piece];
+        const size_t end_row = begin_row + (**pieces[piece]).num_rows();
+        piece_begin[piece + 1] = end_row;
+
+        if (!result.partitions.empty() && result.partitions.back().node == piece_node[piece]) {
+            result.partitions.back().end_row = end_row;
+        } else {
+            result.partitions.push_back({piece_node[piece], begin_row, end_row});
+        }
+    }
+    const size_t rows = piece_begin.back();
+
+    // Binding before the first write makes resize() allocate every bound page
+    // on its node, so nothing is migrated afterwards.
+    std::tuple<std::vector<ColumnTypes>...> columns;
+    [&]<size_t... Is>(std::index_sequence<Is...>) {
+        (([&] {
+            auto& column = std::get<Is>(columns);
+            using T = typename std::tuple_element_t<Is, decltype(columns)>::value_type;
+            if constexpr (std::is_arithmetic_v<T>) {
+                column.reserve(rows);
+                if (topology.is_numa()) {
+                    for (const auto& partition : result.partitions) {
+                        bind_memory_to_node(column.data() + partition.begin_row,
+                                            (partition.end_row - partition.begin_row) * sizeof(T), partition.node);
+                    }
+                }
+            }
+            column.resize(rows);
+        }()), ...);
+    }(std::make_index_sequence<sizeof...(ColumnTypes)>{});
+
+    {
+        std::vector<std::thread> threads;
+        for (size_t piece = 0; piece < pieces.size(); ++piece) {
+            threads.emplace_back([&, piece] {
+                pin_current_thread_to_node(topology, piece_node[piece]);
+                const auto& source = **pieces[piece];
+                [&]<size_t... Is>(std::index_sequence<Is...>) {
+                    (std::ranges::copy(source.template get_column_view<Is>(),
+                                       std::get<Is>(columns).begin() + static_cast<ptrdiff_t>(piece_begin[piece])),
+                     ...);
+                }(std::make_index_sequence<sizeof...(ColumnTypes)>{});
+                pieces[piece].reset();
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    auto table = std::apply([&](auto&... column) {
+        return Columnar<ColumnTypes...>::from_columns(*names, std::move(column)...);
+    }, columns);
+    if (!table) {
+        return Result(table.error());
+    }
+    result.table = std::move(*table);
+
+    return Result(std::move(result));
+}
+
+// Morsel-driven execution over a NUMA-partitioned table: every node runs
+// `threads_per_node` pinned workers that process morsels of their own
+// partitions first and then steal remaining morsels from other nodes.
+template <typename F>
+void numa_parallel_for(const std::vector<NumaPartition>& partitions, size_t morsel_rows, F&& fn,
+                       size_t threads_per_node = 0, const NumaTopology& topology = NumaTopology::system()) {
+    const size_t node_count = topology.node_count();
+    morsel_rows = std::max<size_t>(morsel_rows, 1);
+
+    struct Morsels {
+        std::vector<std::pair<size_t, size_t>> ranges;
+        std::atomic<size_t> next{0};
+    };
+    std::vector<Morsels> per_node(node_count);
+    for (const auto& partition : partitions) {
+        auto& ranges = per_node[partition.node % node_count].ranges;
+        for (size_t begin = partition.begin_row; begin < partition.end_row; begin += morsel_rows) {
+            ranges.emplace_back(begin, std::min(begin + morsel_rows, partition.end_row));
+        }
+    }
+
+    std::vector<std::thread> threads;
+    for (size_t node = 0; node < node_count; ++node) {
+        const size_t workers =
+            threads_per_node != 0 ? threads_per_node : std::max<size_t>(topology.cpus(node).size(), 1);
+        for (size_t w = 0; w < workers; ++w) {
+            threads.emplace_back([&, node] {
+                pin_current_thread_to_node(topology, node);
+                for (size_t offset = 0; offset < node_count; ++offset) {
+                    auto& morsels = per_node[(node + offset) % node_count];
+                    for (size_t i = morsels.next.fetch_add(1); i < morsels.ranges.size();
+                         i = morsels.next.fetch_add(1)) {
+                        fn(morsels.ranges[i].first, morsels.ranges[i].second);
+                    }
+                }
+            });
+        }
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+}
+
+#endif
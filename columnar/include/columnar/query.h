@@ -0,0 +1,494 @@
+#ifndef COLUMNAR_QUERY_H
+#define COLUMNAR_QUERY_H
+
+#include "columnar/columnar.h"
+#include "columnar/cpu.h"
+#include "columnar/string_kernels.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace columnar {
+
+enum class CompareOp {
+    Equal,
+    NotEqual,
+    Less,
+    LessEqual,
+    Greater,
+    GreaterEqual,
+    // String columns only.
+    StartsWith,
+    EndsWith,
+    Contains,
+    Like
+};
+
+using Scalar = std::variant<int64_t, double, std::string>;
+
+// `column <op> value`. Numeric columns accept int64_t and double constants,
+// string columns accept string constants. StartsWith, EndsWith, Contains and
+// Like (SQL LIKE with '%', '_' and '\' escapes) apply to string columns only.
+struct Comparison {
+    std::string column;
+    CompareOp op;
+    Scalar value;
+};
+
+enum class AggregateOp {
+    Count,
+    Sum,
+    Min,
+    Max,
+    Mean
+};
+
+struct Aggregate {
+    AggregateOp op;
+    std::string column;
+};
+
+// One bit per row of a table; bit i is set when row i is selected.
+class SelectionBitmap {
+public:
+    SelectionBitmap() = default;
+    explicit SelectionBitmap(size_t size, bool selected = false)
+        : words_((size + 63) / 64, selected ? ~uint64_t{0} : uint64_t{0}), size_(size) {
+        clear_padding();
+    }
+
+    [[nodiscard]] size_t size() const noexcept { return size_; }
+
+    [[nodiscard]] bool test(size_t index) const noexcept { return (words_[index / 64] >> (index % 64)) & 1u; }
+
+    void set(size_t index) noexcept { words_[index / 64] |= uint64_t{1} << (index % 64); }
+
+    [[nodiscard]] size_t count() const noexcept {
+        size_t total = 0;
+        for (uint64_t word : words_) {
+            total += static_cast<size_t>(std::popcount(word));
+        }
+        return total;
+    }
+
+    SelectionBitmap& operator&=(const SelectionBitmap& other) noexcept {
+        for (size_t i = 0; i < words_.size() && i < other.words_.size(); ++i) {
+            words_[i] &= other.words_[i];
+        }
+        return *this;
+    }
+
+    [[nodiscard]] std::vector<size_t> to_indices() const {
+        std::vector<size_t> indices;
+        indices.reserve(count());
+        for (size_t w = 0; w < words_.size(); ++w) {
+            for (uint64_t word = words_[w]; word != 0; word &= word - 1) {
+                indices.push_back(w * 64 + static_cast<size_t>(std::countr_zero(word)));
+            }
+        }
+        return indices;
+    }
+
+    [[nodiscard]] std::span<uint64_t> words() noexcept { return words_; }
+    [[nodiscard]] std::span<const uint64_t> words() const noexcept { return words_; }
+
+    [[nodiscard]] size_t memory_usage() const noexcept { return words_.size() * sizeof(uint64_t); }
+
+private:
+    void clear_padding() noexcept {
+        if (size_ % 64 != 0 && !words_.empty()) {
+            words_.back() &= (uint64_t{1} << (size_ % 64)) - 1;
+        }
+    }
+
+    std::vector<uint64_t> words_;
+    size_t size_{0};
+};
+
+namespace detail {
+
+[[nodiscard]] constexpr bool is_string_op(CompareOp op) noexcept {
+    return op == CompareOp::StartsWith || op == CompareOp::EndsWith || op == CompareOp::Contains ||
+           op == CompareOp::Like;
+}
+
+[[nodiscard]] constexpr StringMatchKind string_match_kind(CompareOp op) noexcept {
+    switch (op) {
+        case CompareOp::StartsWith:
+            return StringMatchKind::StartsWith;
+        case CompareOp::EndsWith:
+            return StringMatchKind::EndsWith;
+        case CompareOp::Contains:
+            return StringMatchKind::Contains;
+        case CompareOp::Like:
+            return StringMatchKind::Like;
+        default:
+            return StringMatchKind::Equals;
+    }
+}
+
+template <typename T, typename V, typename Compare>
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((always_inline))
+#endif
+inline void compare_words_body(std::span<const T> column, const V& value, Compare compare, uint64_t* words) {
+    const size_t full_words = column.size() / 64;
+    for (size_t w = 0; w < full_words; ++w) {
+        // Blocks already cleared by an earlier predicate are not evaluated.
+        if (words[w] == 0) {
+            continue;
+        }
+        const T* values = column.data() + w * 64;
+        uint64_t bits = 0;
+        for (size_t b = 0; b < 64; ++b) {
+            bits |= static_cast<uint64_t>(compare(values[b], value)) << b;
+        }
+        words[w] &= bits;
+    }
+    if (const size_t tail = column.size() % 64; tail != 0 && words[full_words] != 0) {
+        const T* values = column.data() + full_words * 64;
+        uint64_t bits = 0;
+        for (size_t b = 0; b < tail; ++b) {
+            bits |= static_cast<uint64_t>(compare(values[b], value)) << b;
+        }
+        words[full_words] &= bits;
+    }
+}
+
+#if COLUMNAR_HAS_AVX512_KERNELS
+template <typename T, typename V, typename Compare>
+COLUMNAR_TARGET_AVX512 void compare_words_avx512(std::span<const T> column, const V& value, Compare compare,
+                                                 uint64_t* words) {
+    compare_words_body(column, value, compare, words);
+}
+#endif
+
+#if COLUMNAR_HAS_AVX2_KERNELS
+template <typename T, typename V, typename Compare>
+COLUMNAR_TARGET_AVX2 void compare_words_avx2(std::span<const T> column, const V& value, Compare compare,
+                                             uint64_t* words) {
+    compare_words_body(column, value, compare, words);
+}
+#endif
+
+// The same loop compiled for each SIMD level; the compiler vectorises the
+// 64-row blocks with the widest registers the level allows.
+template <typename T, typename V, typename Compare>
+void compare_into_words(std::span<const T> column, const V& value, Compare compare, uint64_t* words) {
+    if constexpr (std::is_arithmetic_v<T>) {
+        switch (simd_level()) {
+#if COLUMNAR_HAS_AVX512_KERNELS
+            case SimdLevel::Avx512:
+                compare_words_avx512(column, value, compare, words);
+                return;
+#endif
+#if COLUMNAR_HAS_AVX2_KERNELS
+            case SimdLevel::Avx2:
+                compare_words_avx2(column, value, compare, words);
+                return;
+#endif
+            default:
+                break;
+        }
+    }
+    compare_words_body(column, value, compare, words);
+}
+
+template <typename T, typename V>
+void compare_into_words(std::span<const T> column, CompareOp op, const V& value, uint64_t* words) {
+    switch (op) {
+        case CompareOp::Equal:
+            compare_into_words(column, value, [](const T& a, const V& b) { return a == b; }, words);
+            break;
+        case CompareOp::NotEqual:
+            compare_into_words(column, value, [](const T& a, const V& b) { return a != b; }, words);
+            break;
+        case CompareOp::Less:
+            compare_into_words(column, value, [](const T& a, const V& b) { return a < b; }, words);
+            break;
+        case CompareOp::LessEqual:
+            compare_into_words(column, value, [](const T& a, const V& b) { return a <= b; }, words);
+            break;
+        case CompareOp::Greater:
+            compare_into_words(column, value, [](const T& a, const V& b) { return a > b; }, words);
+            break;
+        case CompareOp::GreaterEqual:
+            compare_into_words(column, value, [](const T& a, const V& b) { return a >= b; }, words);
+            break;
+        case CompareOp::StartsWith:
+        case CompareOp::EndsWith:
+        case CompareOp::Contains:
+        case CompareOp::Like:
+            if constexpr (std::is_same_v<V, std::string>) {
+                match_into_words(column, StringMatcher(string_match_kind(op), value), words);
+            }
+            break;
+    }
+}
+
+// Calls `fn(value)` with the constant of `comparison` converted to the type
+// it is compared in against a column of T: int64_t for signed or narrow
+// integral columns given an integer, std::string for string columns and
+// double otherwise. Returns false when the constant cannot be compared with
+// the column's element type, or the operator is a string operator on a
+// numeric column.
+template <typename T, typename F>
+bool with_comparison_value(const Comparison& comparison, F&& fn) {
+    if constexpr (std::is_same_v<T, std::string>) {
+        const auto* value = std::get_if<std::string>(&comparison.value);
+        if (value == nullptr) {
+            return false;
+        }
+        fn(*value);
+        return true;
+    } else {
+        if (std::holds_alternative<std::string>(comparison.value) || is_string_op(comparison.op)) {
+            return false;
+        }
+        if constexpr (std::integral<T> && (std::is_signed_v<T> || sizeof(T) < sizeof(int64_t))) {
+            if (const auto* value = std::get_if<int64_t>(&comparison.value)) {
+                fn(*value);
+                return true;
+            }
+        }
+        const double value = std::visit(
+            [](const auto& v) -> double {
+                if constexpr (std::is_arithmetic_v<std::decay_t<decltype(v)>>) {
+                    return static_cast<double>(v);
+                } else {
+                    return 0.0;
+                }
+            },
+            comparison.value);
+        fn(value);
+        return true;
+    }
+}
+
+// ANDs the result of `comparison` into `words`. Returns false when the
+// constant cannot be compared with the column's element type.
+template <typename T>
+bool apply_comparison(std::span<const T> column, const Comparison& comparison, uint64_t* words) {
+    return with_comparison_value<T>(comparison, [&](const auto& value) {
+        compare_into_words(column, comparison.op, value, words);
+    });
+}
+
+}
+
+// Evaluates the conjunction of `where` over the table. An empty conjunction
+// selects every row.
+template <typename Table>
+[[nodiscard]] Expected<SelectionBitmap, CsvError> select_rows(const Table& table, std::span<const Comparison> where) {
+    using Result = Expected<SelectionBitmap, CsvError>;
+
+    SelectionBitmap selection(table.num_rows(), true);
+    for (const auto& comparison : where) {
+        bool type_matches = true;
+        bool found = table.visit_column(comparison.column, [&](auto column) {
+            type_matches = detail::apply_comparison(column, comparison, selection.words().data());
+        });
+        if (!found) {
+            return Result(CsvError::ColumnNotFound);
+        }
+        if (!type_matches) {
+            return Result(CsvError::ParseError);
+        }
+    }
+    return Result(std::move(selection));
+}
+
+// Mergeable state of an aggregate: partial results computed over disjoint
+// row sets combine with merge() and are turned into a value with finish().
+struct PartialAggregate {
+    uint64_t count = 0;
+    double sum = 0.0;
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+
+    void add(double value) noexcept {
+        sum += value;
+        min = std::min(min, value);
+        max = std::max(max, value);
+        ++count;
+    }
+
+    void merge(const PartialAggregate& other) noexcept {
+        count += other.count;
+        sum += other.sum;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+    }
+
+    // Min, Max and Mean of an empty set are NaN.
+    [[nodiscard]] double finish(AggregateOp op) const noexcept {
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        switch (op) {
+            case AggregateOp::Count:
+                return static_cast<double>(count);
+            case AggregateOp::Sum:
+                return sum;
+            case AggregateOp::Min:
+                return count != 0 ? min : nan;
+            case AggregateOp::Max:
+                return count != 0 ? max : nan;
+            case AggregateOp::Mean:
+                return count != 0 ? sum / static_cast<double>(count) : nan;
+        }
+        return nan;
+    }
+};
+
+// Accumulates the column of `request` over the selected rows (all rows
+// without a selection). Count only counts rows and accepts any column, or
+// none.
+template <typename Table>
+[[nodiscard]] Expected<PartialAggregate, CsvError>
+partial_aggregate(const Table& table, const Aggregate& request, const SelectionBitmap* selection = nullptr) {
+    using Result = Expected<PartialAggregate, CsvError>;
+
+    if (request.op == AggregateOp::Count) {
+        if (!request.column.empty() && !table.visit_column(request.column, [](auto) {})) {
+            return Result(CsvError::ColumnNotFound);
+        }
+        PartialAggregate partial;
+        partial.count = selection != nullptr ? selection->count() : table.num_rows();
+        return Result(partial);
+    }
+
+    std::optional<Result> result;
+    bool found = table.visit_column(request.column, [&](auto column) {
+        using T = typename decltype(column)::value_type;
+        if constexpr (std::is_same_v<T, std::string>) {
+            result.emplace(CsvError::ParseError);
+        } else {
+            PartialAggregate partial;
+            if (selection == nullptr) {
+                for (const T& value : column) {
+                    partial.add(static_cast<double>(value));
+                }
+            } else {
+                for (size_t index : selection->to_indices()) {
+                    partial.add(static_cast<double>(column[index]));
+                }
+            }
+            result.emplace(partial);
+        }
+    });
+
+    if (!found) {
+        return Result(CsvError::ColumnNotFound);
+    }
+    return std::move(*result);
+}
+
+// Computes `request` over the selected rows (all rows without a selection).
+// Min, Max and Mean of an empty selection are NaN.
+template <typename Table>
+[[nodiscard]] Expected<double, CsvError>
+aggregate(const Table& table, const Aggregate& request, const SelectionBitmap* selection = nullptr) {
+    auto partial = partial_aggregate(table, request, selection);
+    if (!partial) {
+        return Expected<double, CsvError>(partial.error());
+    }
+    return Expected<double, CsvError>(partial->finish(request.op));
+}
+
+// A filter/projection/aggregate request against one table: rows matching
+// `where` are projected onto `columns` (at most `limit` rows) and every entry
+// of `aggregates` is computed over all matching rows.
+struct QueryRequest {
+    std::string table;
+    std::vector<Comparison> where;
+    std::vector<std::string> columns;
+    std::vector<Aggregate> aggregates;
+    uint64_t limit = std::numeric_limits<uint64_t>::max();
+};
+
+// Projected values widened to one type per kind, so results of any schema can
+// be represented without knowing it at compile time.
+using ResultValues = std::variant<std::vector<int64_t>, std::vector<double>, std::vector<std::string>>;
+
+namespace detail {
+
+// Element type used for a column of type T in ResultValues.
+template <typename T>
+using result_value_t = std::conditional_t<std::is_same_v<T, std::string>, std::string,
+                                          std::conditional_t<std::floating_point<T>, double, int64_t>>;
+
+}
+
+struct ResultColumn {
+    std::string name;
+    ResultValues values;
+};
+
+// `aggregates[i]` is the value of `request.aggregates[i]`; `partials[i]` is
+// its mergeable state, used to combine results computed on separate
+// partitions of a table.
+struct QueryResult {
+    uint64_t matched_rows = 0;
+    std::vector<ResultColumn> columns;
+    std::vector<double> aggregates;
+    std::vector<PartialAggregate> partials;
+};
+
+template <typename Table>
+[[nodiscard]] Expected<QueryResult, CsvError> execute_query(const Table& table, const QueryRequest& request) {
+    using Result = Expected<QueryResult, CsvError>;
+
+    auto selection = select_rows(table, request.where);
+    if (!selection) {
+        return Result(selection.error());
+    }
+
+    QueryResult result;
+    result.matched_rows = selection->count();
+
+    if (!request.columns.empty()) {
+        auto indices = selection->to_indices();
+        if (indices.size() > request.limit) {
+            indices.resize(static_cast<size_t>(request.limit));
+        }
+
+        for (const auto& name : request.columns) {
+            ResultColumn column{name, {}};
+            bool found = table.visit_column(name, [&](auto values) {
+                using Wide = detail::result_value_t<typename decltype(values)::value_type>;
+                std::vector<Wide> projected;
+                projected.reserve(indices.size());
+                for (size_t index : indices) {
+                    projected.push_back(static_cast<Wide>(values[index]));
+                }
+                column.values = std::move(projected);
+            });
+            if (!found) {
+                return Result(CsvError::ColumnNotFound);
+            }
+            result.columns.push_back(std::move(column));
+        }
+    }
+
+    for (const auto& request_aggregate : request.aggregates) {
+        auto partial = partial_aggregate(table, request_aggregate, &*selection);
+        if (!partial) {
+            return Result(partial.error());
+        }
+        result.aggregates.push_back(partial->finish(request_aggregate.op));
+        result.partials.push_back(*partial);
+    }
+
+    return Result(std::move(result));
+}
+
+}
+
+#endif
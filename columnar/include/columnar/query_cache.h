@@ -0,0 +1,266 @@
+#ifndef COLUMNAR_QUERY_CACHE_H
+#define COLUMNAR_QUERY_CACHE_H
+
+#include "columnar/hash.h"
+#include "columnar/query.h"
+
+#include <algorithm>
+#include <charconv>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+namespace columnar {
+
+namespace detail {
+
+inline void append_length_prefixed(std::string& out, std::string_view text) {
+    out += std::to_string(text.size());
+    out += ':';
+    out += text;
+}
+
+inline void append_scalar(std::string& out, const Scalar& value) {
+    if (const auto* text = std::get_if<std::string>(&value)) {
+        out += 's';
+        append_length_prefixed(out, *text);
+        return;
+    }
+
+    // 5 and 5.0 select the same rows, so integral doubles share the int64
+    // form. Only below 2^53: from there on a double comparison also matches
+    // neighbouring integers (2^53 + 1 rounds to 2^53) that the int64 one
+    // does not.
+    const double* real = std::get_if<double>(&value);
+    if (real == nullptr || (std::trunc(*real) == *real && std::abs(*real) < 0x1p53)) {
+        out += 'i';
+        out += std::to_string(real == nullptr ? std::get<int64_t>(value) : static_cast<int64_t>(*real));
+        return;
+    }
+
+    char buffer[32];
+    auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), *real);
+    out += 'd';
+    out.append(buffer, ec == std::errc{} ? end : buffer);
+}
+
+}
+
+// Canonical form of a conjunction: the order of the predicates and repeated
+// predicates do not change the selected rows, so neither changes the key.
+[[nodiscard]] inline std::string canonicalize(std::span<const Comparison> where) {
+    std::vector<std::string> terms;
+    terms.reserve(where.size());
+    for (const auto& comparison : where) {
+        std::string term;
+        detail::append_length_prefixed(term, comparison.column);
+        term += static_cast<char>('0' + static_cast<int>(comparison.op));
+        detail::append_scalar(term, comparison.value);
+        terms.push_back(std::move(term));
+    }
+    std::sort(terms.begin(), terms.end());
+    terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+
+    std::string canonical;
+    for (const auto& term : terms) {
+        canonical += term;
+        canonical += ';';
+    }
+    return canonical;
+}
+
+[[nodiscard]] inline std::string canonicalize(std::span<const Comparison> where, const Aggregate& request) {
+    std::string canonical = "agg";
+    canonical += static_cast<char>('0' + static_cast<int>(request.op));
+    detail::append_length_prefixed(canonical, request.column);
+    canonical += '|';
+    canonical += canonicalize(where);
+    return canonical;
+}
+
+// LRU cache of selection bitmaps and aggregate values keyed by the table's
+// generation and the canonical query. Mutating a table changes its generation,
+// so stale entries are never served; they age out under the memory budget.
+class QueryCache {
+public:
+    explicit QueryCache(size_t memory_budget_bytes) : budget_(memory_budget_bytes) {}
+
+    template <ColumnType... ColumnTypes>
+    [[nodiscard]] Expected<std::shared_ptr<const SelectionBitmap>, CsvError>
+    select_rows(const Columnar<ColumnTypes...>& table, std::span<const Comparison> where);
+
+    template <ColumnType... ColumnTypes>
+    [[nodiscard]] Expected<double, CsvError>
+    aggregate(const Columnar<ColumnTypes...>& table, std::span<const Comparison> where, const Aggregate& request);
+
+    template <ColumnType... ColumnTypes>
+    void invalidate(const Columnar<ColumnTypes...>& table) {
+        invalidate_generation(table.generation());
+    }
+
+    void clear();
+
+    [[nodiscard]] size_t memory_usage() const;
+    [[nodiscard]] size_t size() const;
+    [[nodiscard]] size_t hits() const;
+    [[nodiscard]] size_t misses() const;
+
+private:
+    using Value = std::variant<std::shared_ptr<const SelectionBitmap>, double>;
+
+    struct Entry {
+        std::string key;
+        uint64_t generation;
+        Value value;
+        size_t bytes;
+    };
+
+    static constexpr size_t kEntryOverhead = 96;
+
+    static std::string make_key(uint64_t generation, const std::string& canonical) {
+        return std::to_string(generation) + '#' + canonical;
+    }
+
+    std::optional<Value> lookup(const std::string& key);
+    void insert(std::string key, uint64_t generation, Value value, size_t value_bytes);
+    void invalidate_generation(uint64_t generation);
+    void evict_to_budget();
+
+    size_t budget_;
+    size_t used_{0};
+    size_t hits_{0};
+    size_t misses_{0};
+    std::list<Entry> lru_;
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+    mutable std::mutex mutex_;
+};
+
+template <ColumnType... ColumnTypes>
+[[nodiscard]] Expected<std::shared_ptr<const SelectionBitmap>, CsvError>
+QueryCache::select_rows(const Columnar<ColumnTypes...>& table, std::span<const Comparison> where) {
+    using Result = Expected<std::shared_ptr<const SelectionBitmap>, CsvError>;
+
+    const uint64_t generation = table.generation();
+    std::string key = make_key(generation, canonicalize(where));
+    if (auto cached = lookup(key)) {
+        return Result(std::get<std::shared_ptr<const SelectionBitmap>>(*cached));
+    }
+
+    auto selection = columnar::select_rows(table, where);
+    if (!selection) {
+        return Result(selection.error());
+    }
+
+    auto shared = std::make_shared<const SelectionBitmap>(std::move(*selection));
+    insert(std::move(key), generation, shared, shared->memory_usage());
+    return Result(std::move(shared));
+}
+
+template <ColumnType... ColumnTypes>
+[[nodiscard]] Expected<double, CsvError>
+QueryCache::aggregate(const Columnar<ColumnTypes...>& table, std::span<const Comparison> where,
+                      const Aggregate& request) {
+    using Result = Expected<double, CsvError>;
+
+    const uint64_t generation = table.generation();
+    std::string key = make_key(generation, canonicalize(where, request));
+    if (auto cached = lookup(key)) {
+        return Result(std::get<double>(*cached));
+    }
+
+    std::shared_ptr<const SelectionBitmap> selection;
+    if (!where.empty()) {
+        auto selected = select_rows(table, where);
+        if (!selected) {
+            return Result(selected.error());
+        }
+        selection = *selected;
+    }
+
+    auto value = columnar::aggregate(table, request, selection.get());
+    if (value) {
+        insert(std::move(key), generation, *value, sizeof(double));
+    }
+    return value;
+}
+
+inline std::optional<QueryCache::Value> QueryCache::lookup(const std::string& key) {
+    std::lock_guard lock(mutex_);
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+        ++misses_;
+        return std::nullopt;
+    }
+    ++hits_;
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return it->second->value;
+}
+
+inline void QueryCache::insert(std::string key, uint64_t generation, Value value, size_t value_bytes) {
+    const size_t bytes = value_bytes + key.size() + kEntryOverhead;
+
+    std::lock_guard lock(mutex_);
+    if (bytes > budget_ || index_.contains(key)) {
+        return;
+    }
+    lru_.push_front({key, generation, std::move(value), bytes});
+    index_.emplace(std::move(key), lru_.begin());
+    used_ += bytes;
+    evict_to_budget();
+}
+
+inline void QueryCache::evict_to_budget() {
+    while (used_ > budget_ && !lru_.empty()) {
+        used_ -= lru_.back().bytes;
+        index_.erase(lru_.back().key);
+        lru_.pop_back();
+    }
+}
+
+inline void QueryCache::invalidate_generation(uint64_t generation) {
+    std::lock_guard lock(mutex_);
+    for (auto it = lru_.begin(); it != lru_.end();) {
+        if (it->generation == generation) {
+            used_ -= it->bytes;
+            index_.erase(it->key);
+            it = lru_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+inline void QueryCache::clear() {
+    std::lock_guard lock(mutex_);
+    lru_.clear();
+    index_.clear();
+    used_ = 0;
+}
+
+inline size_t QueryCache::memory_usage() const {
+    std::lock_guard lock(mutex_);
+    return used_;
+}
+
+inline size_t QueryCache::size() const {
+    std::lock_guard lock(mutex_);
+    return lru_.size();
+}
+
+inline size_t QueryCache::hits() const {
+    std::lock_guard lock(mutex_);
+    return hits_;
+}
+
+inline size_t QueryCache::misses() const {
+    std::lock_guard lock(mutex_);
+    return misses_;
+}
+
+}
+
+#endif
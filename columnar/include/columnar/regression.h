@@ -0,0 +1,140 @@
+#ifndef COLUMNAR_REGRESSION_H
+#define COLUMNAR_REGRESSION_H
+
+#include "columnar/correlation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace columnar {
+
+namespace detail {
+
+// Solves a * x = b for symmetric positive definite `a` (n x n, row-major)
+// by Cholesky factorisation, overwriting `a` with the factor and `b` with x.
+// Returns false if a pivot falls below `tolerance` times its diagonal entry,
+// i.e. the system is singular to working precision.
+inline bool cholesky_solve(std::vector<double>& a, std::vector<double>& b, double tolerance = 1e-12) {
+    const size_t n = b.size();
+    for (size_t j = 0; j < n; ++j) {
+        const double diagonal = a[j * n + j];
+        double pivot = diagonal;
+        for (size_t k = 0; k < j; ++k) {
+            pivot -= a[j * n + k] * a[j * n + k];
+        }
+        if (!(pivot > tolerance * diagonal) || !(diagonal > 0.0)) {
+            return false;
+        }
+        a[j * n + j] = std::sqrt(pivot);
+        for (size_t i = j + 1; i < n; ++i) {
+            double value = a[i * n + j];
+            for (size_t k = 0; k < j; ++k) {
+                value -= a[i * n + k] * a[j * n + k];
+            }
+            a[i * n + j] = value / a[j * n + j];
+        }
+    }
+    // L z = b, then L^T x = z.
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t k = 0; k < i; ++k) {
+            b[i] -= a[i * n + k] * b[k];
+        }
+        b[i] /= a[i * n + i];
+    }
+    for (size_t i = n; i-- > 0;) {
+        for (size_t k = i + 1; k < n; ++k) {
+            b[i] -= a[k * n + i] * b[k];
+        }
+        b[i] /= a[i * n + i];
+    }
+    return true;
+}
+
+}
+
+// Ordinary least squares fit y = intercept + sum(coefficients[i] * x_i).
+struct LinearFit {
+    std::vector<std::string> predictors;
+    std::string response;
+    uint64_t count = 0;
+    double intercept = 0.0;
+    std::vector<double> coefficients;
+    // Sum of squared residuals and coefficient of determination.
+    double residual_sum_of_squares = 0.0;
+    double r_squared = std::numeric_limits<double>::quiet_NaN();
+
+    [[nodiscard]] double predict(std::span<const double> x) const noexcept {
+        double y = intercept;
+        for (size_t i = 0; i < coefficients.size() && i < x.size(); ++i) {
+            y += coefficients[i] * x[i];
+        }
+        return y;
+    }
+};
+
+// Fits `response` on `predictors` over the rows `selection` keeps (all rows
+// without one), in parallel on `pool` if given. One scan accumulates X^T X
+// and X^T y of the mean-centred design with the same mergeable blocks as
+// covariance_matrix, which keeps offsets like timestamps from swamping the
+// fit; the normal system is then solved by Cholesky. Fails with
+// ColumnNotFound, ParseError for a string column, or InvalidFormat if the
+// selection does not match the table or the predictors are collinear
+// (including fewer rows than coefficients).
+template <typename Table>
+[[nodiscard]] Expected<LinearFit, CsvError>
+fit_linear(const Table& table, std::span<const std::string> predictors, std::string_view response,
+           ThreadPool* pool = nullptr, const SelectionBitmap* selection = nullptr) {
+    using Result = Expected<LinearFit, CsvError>;
+
+    const size_t p = predictors.size();
+    std::vector<std::string> columns(predictors.begin(), predictors.end());
+    columns.emplace_back(response);
+
+    auto state = detail::accumulate_column_blocks(table, std::span<const std::string>(columns), selection, pool,
+                                                  CovarianceAccumulator(p + 1));
+    if (!state) {
+        return Result(state.error());
+    }
+    if (state->count() <= p) {
+        return Result(CsvError::InvalidFormat);
+    }
+
+    std::vector<double> xtx(p * p);
+    std::vector<double> xty(p);
+    for (size_t i = 0; i < p; ++i) {
+        for (size_t j = 0; j < p; ++j) {
+            xtx[i * p + j] = state->comoment(i, j);
+        }
+        xty[i] = state->comoment(i, p);
+    }
+    if (!detail::cholesky_solve(xtx, xty)) {
+        return Result(CsvError::InvalidFormat);
+    }
+
+    LinearFit fit;
+    fit.predictors.assign(predictors.begin(), predictors.end());
+    fit.response = std::string(response);
+    fit.count = state->count();
+    fit.coefficients = std::move(xty);
+    fit.intercept = state->means()[p];
+    double explained = 0.0;
+    for (size_t i = 0; i < p; ++i) {
+        fit.intercept -= fit.coefficients[i] * state->means()[i];
+        explained += fit.coefficients[i] * state->comoment(i, p);
+    }
+    const double total = state->comoment(p, p);
+    fit.residual_sum_of_squares = std::max(total - explained, 0.0);
+    if (total > 0.0) {
+        fit.r_squared = 1.0 - fit.residual_sum_of_squares / total;
+    }
+    return Result(std::move(fit));
+}
+
+}
+
+#endif
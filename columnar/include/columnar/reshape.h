@@ -0,0 +1,222 @@
+#ifndef COLUMNAR_RESHAPE_H
+#define COLUMNAR_RESHAPE_H
+
+#include "columnar/distinct.h"
+#include "columnar/gather.h"
+#include "columnar/query.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+namespace columnar {
+
+namespace detail {
+
+// Text of a value used as a column name by pivot: integers in decimal,
+// floating point in the shortest form that reads back exactly.
+template <typename T>
+std::string format_value(const T& value) {
+    if constexpr (std::is_same_v<T, std::string>) {
+        return value;
+    } else if constexpr (std::is_same_v<T, bool>) {
+        return value ? "true" : "false";
+    } else {
+        char buffer[64];
+        const auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        return ec == std::errc{} ? std::string(buffer, end) : std::string();
+    }
+}
+
+// Index of the ResultValues alternative `columns` widen to together:
+// int64_t if all are integers, double if numeric with at least one
+// floating-point column, std::string if all are strings. Empty if strings
+// mix with numbers or a column is missing (`missing` tells which).
+template <typename Table>
+std::optional<size_t> common_result_type(const Table& table, std::span<const std::string> columns, bool& missing) {
+    bool any_string = false;
+    bool any_floating = false;
+    bool any_integral = false;
+    missing = false;
+    for (const auto& name : columns) {
+        missing = missing || !table.visit_column(name, [&](auto column) {
+            using T = typename decltype(column)::value_type;
+            any_string = any_string || std::is_same_v<T, std::string>;
+            any_floating = any_floating || std::floating_point<T>;
+            any_integral = any_integral || std::integral<T>;
+        });
+    }
+    if (missing || (any_string && (any_floating || any_integral))) {
+        return std::nullopt;
+    }
+    return any_string ? 2 : any_floating ? 1 : 0;
+}
+
+}
+
+// Unpivots `value_columns` (every column not in `id_columns` when empty)
+// into rows: one output row per input row and value column, ordered by
+// value column. The result has the id columns, tiled once per value
+// column, then `variable_name` holding the source column's name and
+// `value_name` holding the value, widened to the common type of the value
+// columns. Built by block copies, not row by row. Fails with
+// ColumnNotFound, or ParseError if the value columns mix strings and
+// numbers.
+template <typename Table>
+[[nodiscard]] Expected<std::vector<ResultColumn>, CsvError>
+melt(const Table& table, std::span<const std::string> id_columns, std::span<const std::string> value_columns = {},
+     std::string variable_name = "variable", std::string value_name = "value") {
+    using Result = Expected<std::vector<ResultColumn>, CsvError>;
+
+    std::vector<std::string> melted(value_columns.begin(), value_columns.end());
+    if (melted.empty()) {
+        for (const auto& name : table.column_names()) {
+            if (std::find(id_columns.begin(), id_columns.end(), name) == id_columns.end()) {
+                melted.push_back(name);
+            }
+        }
+    }
+
+    bool missing = false;
+    const auto value_type = detail::common_result_type(table, melted, missing);
+    if (!value_type) {
+        return Result(missing ? CsvError::ColumnNotFound : CsvError::ParseError);
+    }
+
+    const size_t rows = table.num_rows();
+    const size_t blocks = melted.size();
+    std::vector<ResultColumn> result;
+    result.reserve(id_columns.size() + 2);
+
+    for (const auto& name : id_columns) {
+        const bool found = table.visit_column(name, [&](auto column) {
+            using Wide = detail::result_value_t<typename decltype(column)::value_type>;
+            std::vector<Wide> tiled(rows * blocks);
+            for (size_t block = 0; block < blocks; ++block) {
+                std::copy(column.begin(), column.end(), tiled.begin() + static_cast<std::ptrdiff_t>(block * rows));
+            }
+            result.push_back({name, std::move(tiled)});
+        });
+        if (!found) {
+            return Result(CsvError::ColumnNotFound);
+        }
+    }
+
+    std::vector<std::string> variables(rows * blocks);
+    for (size_t block = 0; block < blocks; ++block) {
+        std::fill_n(variables.begin() + static_cast<std::ptrdiff_t>(block * rows), rows, melted[block]);
+    }
+    result.push_back({std::move(variable_name), std::move(variables)});
+
+    ResultValues values;
+    if (*value_type == 0) {
+        values = std::vector<int64_t>(rows * blocks);
+    } else if (*value_type == 1) {
+        values = std::vector<double>(rows * blocks);
+    } else {
+        values = std::vector<std::string>(rows * blocks);
+    }
+    std::visit([&](auto& out) {
+        using Wide = typename std::decay_t<decltype(out)>::value_type;
+        for (size_t block = 0; block < blocks; ++block) {
+            table.visit_column(melted[block], [&](auto column) {
+                using T = typename decltype(column)::value_type;
+                if constexpr (std::is_same_v<T, std::string> == std::is_same_v<Wide, std::string>) {
+                    std::transform(column.begin(), column.end(), out.begin() + static_cast<std::ptrdiff_t>(block * rows),
+                                   [](const T& value) { return static_cast<Wide>(value); });
+                }
+            });
+        }
+    }, values);
+    result.push_back({std::move(value_name), std::move(values)});
+    return Result(std::move(result));
+}
+
+// Spreads `values` into one column per distinct value of `columns`, with
+// one row per distinct value of `index` (both in order of first
+// appearance). The result is the widened index column followed by the
+// spread columns, named after their `columns` value. Numeric values come
+// out as double, NaN where an (index, column) pair has no row; string
+// values as empty strings there. Rows are numbered through hash tables
+// (by runs for sorted keys) and scattered into preallocated output. Fails
+// with ColumnNotFound, or InvalidFormat if an (index, column) pair occurs
+// twice.
+template <typename Table>
+[[nodiscard]] Expected<std::vector<ResultColumn>, CsvError>
+pivot(const Table& table, std::string_view index, std::string_view columns, std::string_view values) {
+    using Result = Expected<std::vector<ResultColumn>, CsvError>;
+
+    const size_t rows = table.num_rows();
+    std::vector<ResultColumn> result;
+
+    std::vector<uint32_t> row_ids(rows);
+    size_t groups = 0;
+    const bool index_found = table.visit_column(index, [&](auto column) {
+        using Wide = detail::result_value_t<typename decltype(column)::value_type>;
+        const auto first_rows = detail::dense_ids(column, row_ids.data());
+        std::vector<Wide> keys;
+        keys.reserve(first_rows.size());
+        for (size_t row : first_rows) {
+            keys.push_back(static_cast<Wide>(column[row]));
+        }
+        groups = keys.size();
+        result.push_back({std::string(index), std::move(keys)});
+    });
+
+    std::vector<uint32_t> column_ids(rows);
+    std::vector<std::string> names;
+    const bool columns_found = table.visit_column(columns, [&](auto column) {
+        for (size_t row : detail::dense_ids(column, column_ids.data())) {
+            names.push_back(detail::format_value(column[row]));
+        }
+    });
+    if (!index_found || !columns_found) {
+        return Result(CsvError::ColumnNotFound);
+    }
+
+    // Output cell of each row in a groups x names.size() column-major grid.
+    std::vector<size_t> cells(rows);
+    std::vector<uint8_t> filled(groups * names.size(), 0);
+    for (size_t row = 0; row < rows; ++row) {
+        cells[row] = column_ids[row] * groups + row_ids[row];
+        if (filled[cells[row]]++ != 0) {
+            return Result(CsvError::InvalidFormat);
+        }
+    }
+
+    const bool values_found = table.visit_column(values, [&](auto column) {
+        using T = typename decltype(column)::value_type;
+        using Cell = std::conditional_t<std::is_same_v<T, std::string>, std::string, double>;
+        std::vector<Cell> grid(groups * names.size());
+        if constexpr (std::is_same_v<Cell, double>) {
+            std::fill(grid.begin(), grid.end(), std::numeric_limits<double>::quiet_NaN());
+        }
+        if constexpr (std::is_same_v<T, Cell>) {
+            scatter(column, cells, grid.data());
+        } else {
+            const std::vector<Cell> converted(column.begin(), column.end());
+            scatter(std::span<const Cell>(converted), cells, grid.data());
+        }
+        for (size_t c = 0; c < names.size(); ++c) {
+            const auto first = grid.begin() + static_cast<std::ptrdiff_t>(c * groups);
+            result.push_back({std::move(names[c]), std::vector<Cell>(std::make_move_iterator(first),
+                                                                     std::make_move_iterator(first + static_cast<std::ptrdiff_t>(groups)))});
+        }
+    });
+    if (!values_found) {
+        return Result(CsvError::ColumnNotFound);
+    }
+    return Result(std::move(result));
+}
+
+}
+
+#endif
@@ -0,0 +1,485 @@
+#ifndef COLUMNAR_SERVER_H
+#define COLUMNAR_SERVER_H
+
+#include "columnar/wire.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace columnar {
+
+namespace detail {
+
+constexpr uint32_t kMaxFrameSize = 1u << 30;
+
+inline bool write_all(int fd, const char* data, size_t size) {
+    while (size > 0) {
+#if defined(MSG_NOSIGNAL)
+        const ssize_t written = ::send(fd, data, size, MSG_NOSIGNAL);
+#else
+        const ssize_t written = ::send(fd, data, size, 0);
+#endif
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+inline bool read_all(int fd, char* data, size_t size) {
+    while (size > 0) {
+        const ssize_t received = ::recv(fd, data, size, 0);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            return false;
+        }
+        data += received;
+        size -= static_cast<size_t>(received);
+    }
+    return true;
+}
+
+// Frames are a native-endian u32 length followed by the message. Payloads
+// over kMaxFrameSize are refused without writing anything, since the peer
+// would reject them (or, past 4 GiB, misread the length).
+inline bool send_frame(int fd, const std::string& payload) {
+    if (payload.size() > kMaxFrameSize) {
+        return false;
+    }
+    const auto size = static_cast<uint32_t>(payload.size());
+    return write_all(fd, reinterpret_cast<const char*>(&size), sizeof(size)) &&
+           write_all(fd, payload.data(), payload.size());
+}
+
+inline bool receive_frame(int fd, std::string& payload) {
+    uint32_t size = 0;
+    if (!read_all(fd, reinterpret_cast<char*>(&size), sizeof(size)) || size > kMaxFrameSize) {
+        return false;
+    }
+    payload.resize(size);
+    return read_all(fd, payload.data(), size);
+}
+
+inline bool make_socket_address(const std::filesystem::path& path, sockaddr_un& address) {
+    const std::string native = path.string();
+    if (native.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    address = {};
+    address.sun_family = AF_UNIX;
+    std::copy(native.begin(), native.end(), address.sun_path);
+    return true;
+}
+
+}
+
+// Keeps tables resident and answers QueryRequests over a Unix domain socket.
+// Each connection is served by its own thread and may send any number of
+// requests; tables can be registered while the server is running. Requests
+// for an unknown table fail with CsvError::FileNotFound.
+//
+// A server that accepts a schema (accept_tables) also acts as a worker: it
+// stores tables of that schema sent by a client with QueryClient::load.
+class QueryServer {
+public:
+    using Handler = std::function<Expected<QueryResult, CsvError>(const QueryRequest&)>;
+    using Loader = std::function<Expected<uint64_t, CsvError>(const LoadRequest&)>;
+
+    QueryServer() = default;
+    QueryServer(const QueryServer&) = delete;
+    QueryServer& operator=(const QueryServer&) = delete;
+    ~QueryServer() { stop(); }
+
+    template <ColumnType... ColumnTypes>
+    void add_table(const std::string& name, std::shared_ptr<const Columnar<ColumnTypes...>> table) {
+        add_handler(name, [table](const QueryRequest& request) { return execute_query(*table, request); });
+    }
+
+    void add_handler(const std::string& name, Handler handler) {
+        std::unique_lock lock(tables_mutex_);
+        tables_[name] = std::move(handler);
+    }
+
+    template <ColumnType... ColumnTypes>
+    void accept_tables() {
+        std::unique_lock lock(tables_mutex_);
+        loaders_.push_back([this](const LoadRequest& request) {
+            auto table = try_deserialize<ColumnTypes...>(request.snapshot);
+            if (!table) {
+                return Expected<uint64_t, CsvError>(table.error());
+            }
+            const uint64_t rows = table->num_rows();
+            add_table(request.table, std::make_shared<const Columnar<ColumnTypes...>>(std::move(*table)));
+            return Expected<uint64_t, CsvError>(rows);
+        });
+    }
+
+    // Stores the table in `request` with the first accepted schema it matches.
+    // Returns the number of rows loaded, or InvalidFormat when no schema fits.
+    [[nodiscard]] Expected<uint64_t, CsvError> load(const LoadRequest& request) const;
+
+    [[nodiscard]] Expected<std::filesystem::path, CsvError> listen(const std::filesystem::path& socket_path);
+
+    // Accepts and serves connections until stop() is called.
+    void serve();
+
+    // Wakes serve() through a pipe and waits for it to return before closing
+    // the listening socket, then shuts down open connections and joins them.
+    void stop();
+
+    // Largest encoded result sent back; a larger one is replaced by
+    // CsvError::IoError, and a limit on the request keeps it smaller.
+    // Capped at the frame size clients accept. Call before serve().
+    void set_max_response_size(size_t bytes) noexcept {
+        max_response_size_ = std::min<size_t>(bytes, detail::kMaxFrameSize);
+    }
+
+    // Connection threads not yet joined: those still serving a client and
+    // those that finished since the last accept.
+    [[nodiscard]] size_t connection_count() {
+        std::lock_guard lock(connections_mutex_);
+        return connection_threads_.size();
+    }
+
+    [[nodiscard]] Expected<QueryResult, CsvError> execute(const QueryRequest& request) const;
+
+private:
+    void serve_connection(int fd);
+    // Joins the threads of closed connections. Needs connections_mutex_.
+    void reap_finished_connections();
+
+    std::map<std::string, Handler> tables_;
+    std::vector<Loader> loaders_;
+    mutable std::shared_mutex tables_mutex_;
+
+    // Set by listen() and closed by stop() only once no serve() call is
+    // running, so serve() never polls or accepts on a closed descriptor.
+    int listen_fd_{-1};
+    // stop() writes to wake_fds_[1] to end serve()'s poll.
+    int wake_fds_[2]{-1, -1};
+    std::filesystem::path socket_path_;
+    std::atomic<bool> stopping_{false};
+    size_t max_response_size_{detail::kMaxFrameSize};
+
+    std::mutex lifecycle_mutex_;
+    std::condition_variable serve_finished_;
+    int serving_{0};
+
+    std::mutex connections_mutex_;
+    std::set<int> connection_fds_;
+    std::vector<std::thread> connection_threads_;
+    std::vector<std::thread::id> finished_connections_;
+};
+
+inline Expected<std::filesystem::path, CsvError> QueryServer::listen(const std::filesystem::path& socket_path) {
+    using Result = Expected<std::filesystem::path, CsvError>;
+
+    sockaddr_un address{};
+    if (!detail::make_socket_address(socket_path, address)) {
+        return Result(CsvError::InvalidFormat);
+    }
+
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return Result(CsvError::IoError);
+    }
+
+    ::unlink(address.sun_path);
+    int wake[2];
+    if (::bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || ::listen(fd, 64) != 0 ||
+        ::pipe(wake) != 0) {
+        ::close(fd);
+        return Result(CsvError::IoError);
+    }
+
+    std::lock_guard lock(lifecycle_mutex_);
+    listen_fd_ = fd;
+    wake_fds_[0] = wake[0];
+    wake_fds_[1] = wake[1];
+    socket_path_ = socket_path;
+    stopping_ = false;
+    return Result(socket_path);
+}
+
+inline void QueryServer::serve() {
+    {
+        std::lock_guard lock(lifecycle_mutex_);
+        if (stopping_.load() || listen_fd_ < 0) {
+            return;
+        }
+        ++serving_;
+    }
+
+    while (!stopping_.load()) {
+        pollfd fds[2] = {{listen_fd_, POLLIN, 0}, {wake_fds_[0], POLLIN, 0}};
+        const int ready = ::poll(fds, 2, -1);
+        if (ready <= 0 || fds[1].revents != 0) {
+            continue;
+        }
+
+        const int fd = ::accept(listen_fd_, nullptr, nullptr);
+        if (fd < 0) {
+            continue;
+        }
+#if defined(SO_NOSIGPIPE)
+        int one = 1;
+        ::setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+
+        std::lock_guard lock(connections_mutex_);
+        if (stopping_.load()) {
+            ::close(fd);
+            break;
+        }
+        reap_finished_connections();
+        connection_fds_.insert(fd);
+        connection_threads_.emplace_back([this, fd] { serve_connection(fd); });
+    }
+
+    {
+        std::lock_guard lock(lifecycle_mutex_);
+        --serving_;
+    }
+    serve_finished_.notify_all();
+}
+
+inline void QueryServer::serve_connection(int fd) {
+    std::string request_frame;
+    std::string response_frame;
+    while (detail::receive_frame(fd, request_frame)) {
+        Expected<QueryResult, CsvError> result(CsvError::InvalidFormat);
+        if (peek_message_type(request_frame) == MessageType::LoadTable) {
+            // The reply to a load is a result whose matched_rows is the row count.
+            if (auto load_request = try_decode_load(request_frame)) {
+                auto rows = load(*load_request);
+                result = rows ? Expected<QueryResult, CsvError>(QueryResult{*rows, {}, {}, {}})
+                              : Expected<QueryResult, CsvError>(rows.error());
+            }
+        } else if (auto request = try_decode_request(request_frame)) {
+            result = execute(*request);
+        }
+        response_frame.clear();
+        encode(result, response_frame);
+        if (response_frame.size() > max_response_size_) {
+            response_frame.clear();
+            encode(Expected<QueryResult, CsvError>(CsvError::IoError), response_frame);
+        }
+        if (!detail::send_frame(fd, response_frame)) {
+            break;
+        }
+    }
+
+    std::lock_guard lock(connections_mutex_);
+    if (connection_fds_.erase(fd) != 0) {
+        ::close(fd);
+    }
+    finished_connections_.push_back(std::this_thread::get_id());
+}
+
+inline void QueryServer::reap_finished_connections() {
+    // A finished thread only has to return from serve_connection, so these
+    // joins do not wait on clients.
+    for (const auto id : finished_connections_) {
+        auto it = std::find_if(connection_threads_.begin(), connection_threads_.end(),
+                               [id](const std::thread& thread) { return thread.get_id() == id; });
+        if (it != connection_threads_.end()) {
+            it->join();
+            *it = std::move(connection_threads_.back());
+            connection_threads_.pop_back();
+        }
+    }
+    finished_connections_.clear();
+}
+
+inline Expected<QueryResult, CsvError> QueryServer::execute(const QueryRequest& request) const {
+    Handler handler;
+    {
+        std::shared_lock lock(tables_mutex_);
+        auto it = tables_.find(request.table);
+        if (it == tables_.end()) {
+            return Expected<QueryResult, CsvError>(CsvError::FileNotFound);
+        }
+        handler = it->second;
+    }
+    return handler(request);
+}
+
+inline Expected<uint64_t, CsvError> QueryServer::load(const LoadRequest& request) const {
+    std::vector<Loader> loaders;
+    {
+        std::shared_lock lock(tables_mutex_);
+        loaders = loaders_;
+    }
+    for (const auto& loader : loaders) {
+        if (auto rows = loader(request)) {
+            return rows;
+        }
+    }
+    return Expected<uint64_t, CsvError>(CsvError::InvalidFormat);
+}
+
+inline void QueryServer::stop() {
+    {
+        std::unique_lock lock(lifecycle_mutex_);
+        stopping_ = true;
+        if (wake_fds_[1] >= 0) {
+            const char wake = 0;
+            while (::write(wake_fds_[1], &wake, 1) < 0 && errno == EINTR) {
+            }
+        }
+        serve_finished_.wait(lock, [this] { return serving_ == 0; });
+    }
+
+    std::vector<std::thread> threads;
+    {
+        std::lock_guard lock(connections_mutex_);
+        for (int fd : connection_fds_) {
+            ::shutdown(fd, SHUT_RDWR);
+        }
+        threads.swap(connection_threads_);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    {
+        std::lock_guard lock(connections_mutex_);
+        finished_connections_.clear();
+    }
+
+    std::lock_guard lock(lifecycle_mutex_);
+    for (int& fd : wake_fds_) {
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+    if (listen_fd_ >= 0) {
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        std::error_code ec;
+        std::filesystem::remove(socket_path_, ec);
+    }
+}
+
+class QueryClient {
+public:
+    [[nodiscard]] static Expected<QueryClient, CsvError> try_connect(const std::filesystem::path& socket_path);
+
+    QueryClient(const QueryClient&) = delete;
+    QueryClient& operator=(const QueryClient&) = delete;
+    QueryClient(QueryClient&& other) noexcept : fd_(std::exchange(other.fd_, -1)) {}
+    QueryClient& operator=(QueryClient&& other) noexcept {
+        if (this != &other) {
+            close();
+            fd_ = std::exchange(other.fd_, -1);
+        }
+        return *this;
+    }
+    ~QueryClient() { close(); }
+
+    [[nodiscard]] Expected<QueryResult, CsvError> execute(const QueryRequest& request);
+
+    // Sends `table` to a worker server, which keeps it under `name`. Returns
+    // the number of rows the worker loaded.
+    template <ColumnType... ColumnTypes>
+    [[nodiscard]] Expected<uint64_t, CsvError> load(const std::string& name, const Columnar<ColumnTypes...>& table) {
+        std::string frame;
+        encode_load(name, table, frame);
+        if (!send(frame)) {
+            return Expected<uint64_t, CsvError>(CsvError::IoError);
+        }
+        auto reply = receive();
+        if (!reply) {
+            return Expected<uint64_t, CsvError>(reply.error());
+        }
+        return Expected<uint64_t, CsvError>(reply->matched_rows);
+    }
+
+    // Split halves of execute()/load(), so a caller talking to several
+    // servers can send to all of them before waiting on any.
+    [[nodiscard]] bool send(const std::string& frame) { return fd_ >= 0 && detail::send_frame(fd_, frame); }
+    [[nodiscard]] Expected<QueryResult, CsvError> receive();
+
+private:
+    explicit QueryClient(int fd) : fd_(fd) {}
+
+    void close() noexcept {
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    int fd_{-1};
+};
+
+inline Expected<QueryClient, CsvError> QueryClient::try_connect(const std::filesystem::path& socket_path) {
+    using Result = Expected<QueryClient, CsvError>;
+
+    sockaddr_un address{};
+    if (!detail::make_socket_address(socket_path, address)) {
+        return Result(CsvError::InvalidFormat);
+    }
+
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return Result(CsvError::IoError);
+    }
+    if (::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        ::close(fd);
+        return Result(CsvError::FileNotFound);
+    }
+#if defined(SO_NOSIGPIPE)
+    int one = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+    return Result(QueryClient(fd));
+}
+
+inline Expected<QueryResult, CsvError> QueryClient::execute(const QueryRequest& request) {
+    std::string frame;
+    encode(request, frame);
+    if (!send(frame)) {
+        return Expected<QueryResult, CsvError>(CsvError::IoError);
+    }
+    return receive();
+}
+
+inline Expected<QueryResult, CsvError> QueryClient::receive() {
+    std::string frame;
+    if (fd_ < 0 || !detail::receive_frame(fd_, frame)) {
+        return Expected<QueryResult, CsvError>(CsvError::IoError);
+    }
+    return try_decode_result(frame);
+}
+
+}
+
+#endif
+
+#endif
@@ -0,0 +1,596 @@
+#ifndef COLUMNAR_SNAPSHOT_H
+#define COLUMNAR_SNAPSHOT_H
+
+#include "columnar/columnar.h"
+#include "columnar/hash.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define COLUMNAR_HAS_MMAP 1
+#endif
+
+namespace columnar {
+
+// Binary snapshot layout (native byte order, checked on read):
+//
+//   "CLNRSNAP" | u32 version | u32 byte-order mark | u64 rows | u32 columns
+//   | str type signature | str tag | str name x columns
+//   | per column, 8-byte aligned: u64 payload size | payload
+//
+// Numeric payloads are the raw column values. String payloads are rows + 1
+// u64 offsets followed by the concatenated bytes. `str` is u32 length + bytes.
+namespace detail {
+
+constexpr char kSnapshotMagic[8] = {'C', 'L', 'N', 'R', 'S', 'N', 'A', 'P'};
+constexpr uint32_t kSnapshotVersion = 1;
+constexpr uint32_t kSnapshotByteOrderMark = 0x01020304;
+
+template <typename T>
+std::string type_code() {
+    if constexpr (std::is_same_v<T, std::string>) {
+        return "s";
+    } else if constexpr (std::is_same_v<T, bool>) {
+        return "b";
+    } else if constexpr (std::floating_point<T>) {
+        return "f" + std::to_string(sizeof(T));
+    } else if constexpr (std::is_signed_v<T>) {
+        return "i" + std::to_string(sizeof(T));
+    } else {
+        return "u" + std::to_string(sizeof(T));
+    }
+}
+
+class SnapshotWriter {
+public:
+    explicit SnapshotWriter(std::string& out) : out_(out) {}
+
+    template <typename T>
+    void pod(const T& value) {
+        out_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void bytes(const void* data, size_t size) { out_.append(static_cast<const char*>(data), size); }
+
+    void str(std::string_view text) {
+        pod(static_cast<uint32_t>(text.size()));
+        bytes(text.data(), text.size());
+    }
+
+    void align() { out_.append((8 - out_.size() % 8) % 8, '\0'); }
+
+private:
+    std::string& out_;
+};
+
+class SnapshotReader {
+public:
+    explicit SnapshotReader(std::span<const char> data) : data_(data) {}
+
+    template <typename T>
+    bool pod(T& value) {
+        return bytes(&value, sizeof(T));
+    }
+
+    bool bytes(void* dst, size_t size) {
+        if (size > data_.size() - pos_) {
+            return false;
+        }
+        if (size != 0) {
+            std::memcpy(dst, data_.data() + pos_, size);
+        }
+        pos_ += size;
+        return true;
+    }
+
+    bool view(std::span<const char>& out, size_t size) {
+        if (size > data_.size() - pos_) {
+            return false;
+        }
+        out = data_.subspan(pos_, size);
+        pos_ += size;
+        return true;
+    }
+
+    bool str(std::string& out) {
+        uint32_t size = 0;
+        std::span<const char> text;
+        if (!pod(size) || !view(text, size)) {
+            return false;
+        }
+        out.assign(text.data(), text.size());
+        return true;
+    }
+
+    bool align() {
+        const size_t padding = (8 - pos_ % 8) % 8;
+        if (padding > data_.size() - pos_) {
+            return false;
+        }
+        pos_ += padding;
+        return true;
+    }
+
+    [[nodiscard]] size_t position() const noexcept { return pos_; }
+
+private:
+    std::span<const char> data_;
+    size_t pos_{0};
+};
+
+// SnapshotReader's interface over a file, for reading the header and the
+// section sizes without reading the sections.
+class SnapshotStreamReader {
+public:
+    explicit SnapshotStreamReader(std::ifstream& in) : in_(in) {}
+
+    template <typename T>
+    bool pod(T& value) {
+        return bytes(&value, sizeof(T));
+    }
+
+    bool bytes(void* dst, size_t size) {
+        if (size != 0 && !in_.read(static_cast<char*>(dst), static_cast<std::streamsize>(size))) {
+            return false;
+        }
+        pos_ += size;
+        return true;
+    }
+
+    bool str(std::string& out) {
+        uint32_t size = 0;
+        if (!pod(size)) {
+            return false;
+        }
+        out.resize(size);
+        return bytes(out.data(), size);
+    }
+
+    bool skip(uint64_t size) {
+        if (size > file_size_ - pos_ ||
+            !in_.seekg(static_cast<std::streamoff>(size), std::ios::cur)) {
+            return false;
+        }
+        pos_ += size;
+        return true;
+    }
+
+    bool align() { return skip((8 - pos_ % 8) % 8); }
+
+    void set_file_size(uint64_t size) noexcept { file_size_ = size; }
+
+private:
+    std::ifstream& in_;
+    uint64_t pos_{0};
+    uint64_t file_size_{0};
+};
+
+// Reads the header up to the first column section, checking it against the
+// schema. `names` receives the column names.
+template <ColumnType... ColumnTypes, typename Reader>
+bool read_snapshot_header(Reader& reader, uint64_t& rows, std::string& tag,
+                          std::array<std::string, sizeof...(ColumnTypes)>& names);
+
+template <typename T>
+void write_column(SnapshotWriter& writer, std::span<const T> column) {
+    writer.align();
+    if constexpr (std::is_same_v<T, std::string>) {
+        uint64_t total = 0;
+        for (const auto& value : column) {
+            total += value.size();
+        }
+        writer.pod(static_cast<uint64_t>((column.size() + 1) * sizeof(uint64_t) + total));
+        uint64_t offset = 0;
+        writer.pod(offset);
+        for (const auto& value : column) {
+            offset += value.size();
+            writer.pod(offset);
+        }
+        for (const auto& value : column) {
+            writer.bytes(value.data(), value.size());
+        }
+    } else {
+        writer.pod(static_cast<uint64_t>(column.size() * sizeof(T)));
+        writer.bytes(column.data(), column.size() * sizeof(T));
+    }
+}
+
+// `rows` comes from the header and is untrusted: it is checked against the
+// payload size by division, so a corrupt count cannot wrap the product.
+template <typename T>
+bool read_column(SnapshotReader& reader, uint64_t rows, std::vector<T>& column) {
+    uint64_t payload_size = 0;
+    std::span<const char> payload;
+    if (!reader.align() || !reader.pod(payload_size) || !reader.view(payload, payload_size)) {
+        return false;
+    }
+
+    if constexpr (std::is_same_v<T, std::string>) {
+        // rows + 1 offsets must fit.
+        if (rows >= payload.size() / sizeof(uint64_t)) {
+            return false;
+        }
+        const size_t offsets_size = (rows + 1) * sizeof(uint64_t);
+        const char* blob = payload.data() + offsets_size;
+        const size_t blob_size = payload.size() - offsets_size;
+
+        column.resize(rows);
+        uint64_t begin = 0;
+        std::memcpy(&begin, payload.data(), sizeof(uint64_t));
+        for (size_t i = 0; i < rows; ++i) {
+            uint64_t end = 0;
+            std::memcpy(&end, payload.data() + (i + 1) * sizeof(uint64_t), sizeof(uint64_t));
+            if (end < begin || end > blob_size) {
+                return false;
+            }
+            column[i].assign(blob + begin, end - begin);
+            begin = end;
+        }
+    } else {
+        if (rows > payload.size() / sizeof(T) || payload.size() != rows * sizeof(T)) {
+            return false;
+        }
+        column.resize(rows);
+        if (rows != 0) {
+            std::memcpy(column.data(), payload.data(), payload.size());
+        }
+    }
+    return true;
+}
+
+}
+
+template <ColumnType... ColumnTypes>
+[[nodiscard]] std::string type_signature() {
+    std::string signature;
+    ((signature += detail::type_code<ColumnTypes>(), signature += ','), ...);
+    return signature;
+}
+
+// Appends the binary encoding of `table` to `out`. `tag` is free-form
+// metadata stored alongside, e.g. the cache key the snapshot was built for.
+template <ColumnType... ColumnTypes>
+void serialize(const Columnar<ColumnTypes...>& table, std::string& out, std::string_view tag = {}) {
+    detail::SnapshotWriter writer(out);
+    writer.bytes(detail::kSnapshotMagic, sizeof(detail::kSnapshotMagic));
+    writer.pod(detail::kSnapshotVersion);
+    writer.pod(detail::kSnapshotByteOrderMark);
+    writer.pod(static_cast<uint64_t>(table.num_rows()));
+    writer.pod(static_cast<uint32_t>(table.num_cols()));
+    writer.str(type_signature<ColumnTypes...>());
+    writer.str(tag);
+    for (const auto& name : table.column_names()) {
+        writer.str(name);
+    }
+
+    [&]<size_t... Is>(std::index_sequence<Is...>) {
+        (detail::write_column(writer, table.template get_column_view<Is>()), ...);
+    }(std::make_index_sequence<sizeof...(ColumnTypes)>{});
+}
+
+namespace detail {
+
+template <ColumnType... ColumnTypes, typename Reader>
+bool read_snapshot_header(Reader& reader, uint64_t& rows, std::string& tag,
+                          std::array<std::string, sizeof...(ColumnTypes)>& names) {
+    char magic[sizeof(kSnapshotMagic)];
+    uint32_t version = 0;
+    uint32_t byte_order = 0;
+    uint32_t columns = 0;
+    std::string signature;
+
+    if (!reader.bytes(magic, sizeof(magic)) || std::memcmp(magic, kSnapshotMagic, sizeof(magic)) != 0 ||
+        !reader.pod(version) || version != kSnapshotVersion || !reader.pod(byte_order) ||
+        byte_order != kSnapshotByteOrderMark || !reader.pod(rows) || !reader.pod(columns) ||
+        columns != sizeof...(ColumnTypes) || !reader.str(signature) ||
+        signature != type_signature<ColumnTypes...>() || !reader.str(tag)) {
+        return false;
+    }
+    for (auto& name : names) {
+        if (!reader.str(name)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+template <ColumnType... ColumnTypes>
+[[nodiscard]] Expected<Columnar<ColumnTypes...>, CsvError>
+try_deserialize(std::span<const char> data, std::string* tag = nullptr) {
+    using Result = Expected<Columnar<ColumnTypes...>, CsvError>;
+
+    detail::SnapshotReader reader(data);
+    uint64_t rows = 0;
+    std::string stored_tag;
+    std::array<std::string, sizeof...(ColumnTypes)> names;
+    if (!detail::read_snapshot_header<ColumnTypes...>(reader, rows, stored_tag, names)) {
+        return Result(CsvError::InvalidFormat);
+    }
+
+    std::tuple<std::vector<ColumnTypes>...> values;
+    const bool complete = [&]<size_t... Is>(std::index_sequence<Is...>) {
+        return (detail::read_column(reader, rows, std::get<Is>(values)) && ...);
+    }(std::make_index_sequence<sizeof...(ColumnTypes)>{});
+    if (!complete) {
+        return Result(CsvError::InvalidFormat);
+    }
+
+    if (tag != nullptr) {
+        *tag = std::move(stored_tag);
+    }
+    return std::apply([&](auto&... columns_data) {
+        return Columnar<ColumnTypes...>::from_columns(std::move(names), std::move(columns_data)...);
+    }, values);
+}
+
+// Read-only view of a whole file, memory-mapped where the platform allows and
+// read into memory otherwise.
+class MappedFile {
+public:
+    [[nodiscard]] static Expected<MappedFile, CsvError> try_open(const std::filesystem::path& filepath);
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept
+        : mapping_(std::exchange(other.mapping_, nullptr)), size_(std::exchange(other.size_, 0)),
+          buffer_(std::move(other.buffer_)) {}
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            release();
+            mapping_ = std::exchange(other.mapping_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            buffer_ = std::move(other.buffer_);
+        }
+        return *this;
+    }
+    ~MappedFile() { release(); }
+
+    [[nodiscard]] std::span<const char> data() const noexcept {
+        return mapping_ != nullptr ? std::span<const char>(static_cast<const char*>(mapping_), size_)
+                                   : std::span<const char>(buffer_);
+    }
+
+private:
+    MappedFile() = default;
+
+    void release() noexcept {
+#if defined(COLUMNAR_HAS_MMAP)
+        if (mapping_ != nullptr) {
+            munmap(mapping_, size_);
+        }
+#endif
+        mapping_ = nullptr;
+        size_ = 0;
+    }
+
+    void* mapping_{nullptr};
+    size_t size_{0};
+    std::vector<char> buffer_;
+};
+
+inline Expected<MappedFile, CsvError> MappedFile::try_open(const std::filesystem::path& filepath) {
+    using Result = Expected<MappedFile, CsvError>;
+
+    MappedFile file;
+#if defined(COLUMNAR_HAS_MMAP)
+    const int fd = ::open(filepath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return Result(CsvError::FileNotFound);
+    }
+    struct stat info {};
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        return Result(CsvError::IoError);
+    }
+    if (info.st_size > 0) {
+        void* mapping = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            ::close(fd);
+            return Result(CsvError::IoError);
+        }
+        file.mapping_ = mapping;
+        file.size_ = static_cast<size_t>(info.st_size);
+    }
+    ::close(fd);
+#else
+    std::ifstream in(filepath, std::ios::binary);
+    if (!in.is_open()) {
+        return Result(CsvError::FileNotFound);
+    }
+    file.buffer_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+#endif
+    return Result(std::move(file));
+}
+
+namespace detail {
+
+// Suffix for a temporary file no other writer uses at the same time: the
+// process id (a start-time stamp where there is none) and a per-process
+// sequence number.
+inline std::string unique_temporary_suffix() {
+    static std::atomic<uint64_t> sequence{0};
+#if defined(COLUMNAR_HAS_MMAP)
+    const uint64_t process = static_cast<uint64_t>(::getpid());
+#else
+    static const uint64_t process =
+        static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    return ".tmp" + std::to_string(process) + "." + std::to_string(sequence.fetch_add(1, std::memory_order_relaxed));
+}
+
+}
+
+template <ColumnType... ColumnTypes>
+[[nodiscard]] Expected<size_t, CsvError>
+write_snapshot(const Columnar<ColumnTypes...>& table, const std::filesystem::path& filepath,
+               std::string_view tag = {}) {
+    std::string buffer;
+    serialize(table, buffer, tag);
+
+    // Write next to the destination and rename, so readers never observe a
+    // partially written snapshot.
+    auto temporary = filepath;
+    temporary += detail::unique_temporary_suffix();
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out.is_open() || !out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()))) {
+            std::error_code ec;
+            std::filesystem::remove(temporary, ec);
+            return Expected<size_t, CsvError>(CsvError::IoError);
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(temporary, filepath, ec);
+    if (ec) {
+        std::filesystem::remove(temporary, ec);
+        return Expected<size_t, CsvError>(CsvError::IoError);
+    }
+    return Expected<size_t, CsvError>(buffer.size());
+}
+
+template <ColumnType... ColumnTypes>
+[[nodiscard]] Expected<Columnar<ColumnTypes...>, CsvError>
+try_read_snapshot(const std::filesystem::path& filepath, std::string* tag = nullptr) {
+    auto file = MappedFile::try_open(filepath);
+    if (!file) {
+        return Expected<Columnar<ColumnTypes...>, CsvError>(file.error());
+    }
+    return try_deserialize<ColumnTypes...>(file->data(), tag);
+}
+
+// What a snapshot holds, read from its header and section sizes alone.
+struct SnapshotInfo {
+    uint64_t rows = 0;
+    std::string tag;
+    std::vector<std::string> column_names;
+    // Size of each column section in the file.
+    std::vector<uint64_t> payload_bytes;
+    // Memory the columns take once loaded: values, plus the std::string
+    // objects and characters of string columns.
+    uint64_t memory_bytes = 0;
+};
+
+// Reads the header of the snapshot at `filepath` and seeks past each column
+// section, so the cost does not depend on the data size. Fails like
+// try_read_snapshot for a missing file, another schema or a truncated file;
+// the contents of the sections are not checked.
+template <ColumnType... ColumnTypes>
+[[nodiscard]] Expected<SnapshotInfo, CsvError> try_read_snapshot_info(const std::filesystem::path& filepath) {
+    using Result = Expected<SnapshotInfo, CsvError>;
+
+    std::error_code ec;
+    const uint64_t file_size = std::filesystem::file_size(filepath, ec);
+    std::ifstream in(filepath, std::ios::binary);
+    if (ec || !in.is_open()) {
+        return Result(CsvError::FileNotFound);
+    }
+
+    detail::SnapshotStreamReader reader(in);
+    reader.set_file_size(file_size);
+    SnapshotInfo info;
+    std::array<std::string, sizeof...(ColumnTypes)> names;
+    if (!detail::read_snapshot_header<ColumnTypes...>(reader, info.rows, info.tag, names)) {
+        return Result(CsvError::InvalidFormat);
+    }
+    info.column_names.assign(names.begin(), names.end());
+
+    constexpr std::array<bool, sizeof...(ColumnTypes)> is_string{std::is_same_v<ColumnTypes, std::string>...};
+    constexpr std::array<size_t, sizeof...(ColumnTypes)> value_size{sizeof(ColumnTypes)...};
+    for (size_t c = 0; c < sizeof...(ColumnTypes); ++c) {
+        uint64_t size = 0;
+        if (!reader.align() || !reader.pod(size) || !reader.skip(size)) {
+            return Result(CsvError::InvalidFormat);
+        }
+        info.payload_bytes.push_back(size);
+        if (is_string[c]) {
+            // rows + 1 offsets, then the characters.
+            if (info.rows >= size / sizeof(uint64_t)) {
+                return Result(CsvError::InvalidFormat);
+            }
+            const uint64_t offsets = (info.rows + 1) * sizeof(uint64_t);
+            info.memory_bytes += info.rows * sizeof(std::string) + (size - offsets);
+        } else {
+            if (info.rows > size / value_size[c] || size != info.rows * value_size[c]) {
+                return Result(CsvError::InvalidFormat);
+            }
+            info.memory_bytes += size;
+        }
+    }
+    return Result(std::move(info));
+}
+
+// Cache key of a CSV file for a given schema: canonical path, size,
+// modification time and type signature.
+template <ColumnType... ColumnTypes>
+[[nodiscard]] Expected<std::string, CsvError> csv_cache_key(const std::filesystem::path& csv_path) {
+    std::error_code ec;
+    const auto canonical = std::filesystem::canonical(csv_path, ec);
+    if (ec) {
+        return Expected<std::string, CsvError>(CsvError::FileNotFound);
+    }
+    const auto size = std::filesystem::file_size(canonical, ec);
+    if (ec) {
+        return Expected<std::string, CsvError>(CsvError::FileNotFound);
+    }
+    const auto mtime = std::filesystem::last_write_time(canonical, ec);
+    if (ec) {
+        return Expected<std::string, CsvError>(CsvError::FileNotFound);
+    }
+
+    return Expected<std::string, CsvError>(canonical.string() + '|' + std::to_string(size) + '|' +
+                                           std::to_string(mtime.time_since_epoch().count()) + '|' +
+                                           type_signature<ColumnTypes...>());
+}
+
+// Loads `csv_path` through a snapshot cache in `cache_dir`. The first load
+// parses the CSV and writes a snapshot; later loads of the unchanged file map
+// the snapshot instead of parsing. Failing to write the cache is not an error.
+template <ColumnType... ColumnTypes>
+[[nodiscard]] Expected<Columnar<ColumnTypes...>, CsvError>
+try_read_from_csv_cached(const std::filesystem::path& csv_path, const std::filesystem::path& cache_dir) {
+    auto key = csv_cache_key<ColumnTypes...>(csv_path);
+    if (!key) {
+        return Expected<Columnar<ColumnTypes...>, CsvError>(key.error());
+    }
+
+    char name[32];
+    auto [end, ec] = std::to_chars(name, name + sizeof(name), fingerprint(*key), 16);
+    (void)ec;
+    const auto snapshot_path = cache_dir / (std::string(name, end) + ".colsnap");
+
+    std::string stored_key;
+    auto cached = try_read_snapshot<ColumnTypes...>(snapshot_path, &stored_key);
+    if (cached && stored_key == *key) {
+        return cached;
+    }
+
+    auto parsed = Columnar<ColumnTypes...>::try_read_from_csv(csv_path);
+    if (parsed) {
+        std::error_code dir_ec;
+        std::filesystem::create_directories(cache_dir, dir_ec);
+        (void)write_snapshot(*parsed, snapshot_path, *key);
+    }
+    return parsed;
+}
+
+}
+
+#endif
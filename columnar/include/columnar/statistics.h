@@ -0,0 +1,314 @@
+#ifndef COLUMNAR_STATISTICS_H
+#define COLUMNAR_STATISTICS_H
+
+#include "columnar/hash.h"
+#include "columnar/query.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace columnar {
+
+// Approximate distinct counter (HyperLogLog with 2^12 registers, about 1.6%
+// standard error). Counters over disjoint rows merge losslessly.
+class HyperLogLog {
+public:
+    static constexpr int kPrecision = 12;
+    static constexpr size_t kRegisters = size_t{1} << kPrecision;
+
+    void add_hash(uint64_t hash) noexcept {
+        const size_t index = static_cast<size_t>(hash >> (64 - kPrecision));
+        const uint64_t rest = hash << kPrecision;
+        const auto rank = static_cast<uint8_t>(rest == 0 ? 64 - kPrecision + 1 : std::countl_zero(rest) + 1);
+        registers_[index] = std::max(registers_[index], rank);
+    }
+
+    template <typename T>
+    void add(const T& value) noexcept {
+        add_hash(hash_value(value));
+    }
+
+    void merge(const HyperLogLog& other) noexcept {
+        for (size_t i = 0; i < kRegisters; ++i) {
+            registers_[i] = std::max(registers_[i], other.registers_[i]);
+        }
+    }
+
+    [[nodiscard]] double estimate() const noexcept {
+        double sum = 0.0;
+        size_t zeros = 0;
+        for (uint8_t rank : registers_) {
+            sum += std::ldexp(1.0, -static_cast<int>(rank));
+            zeros += rank == 0;
+        }
+        const double m = static_cast<double>(kRegisters);
+        const double raw = (0.7213 / (1.0 + 1.079 / m)) * m * m / sum;
+        // Linear counting is more accurate while many registers are empty.
+        if (raw <= 2.5 * m && zeros != 0) {
+            return m * std::log(m / static_cast<double>(zeros));
+        }
+        return raw;
+    }
+
+private:
+    std::array<uint8_t, kRegisters> registers_{};
+};
+
+// One bucket of an equi-depth histogram: `count` rows with values in
+// (previous upper, upper], `distinct` of them different.
+struct HistogramBucket {
+    double upper;
+    uint64_t count;
+    uint64_t distinct;
+};
+
+// Statistics of one column. Numeric columns have min/max and a histogram;
+// for floating-point columns NaN counts as null. String columns only have a
+// distinct estimate and their null count is always 0.
+struct ColumnStatistics {
+    uint64_t rows = 0;
+    uint64_t null_count = 0;
+    std::optional<double> min;
+    std::optional<double> max;
+    double distinct = 0.0;
+    std::vector<HistogramBucket> histogram;
+    bool is_string = false;
+};
+
+struct TableStatistics {
+    uint64_t rows = 0;
+    std::map<std::string, ColumnStatistics, std::less<>> columns;
+
+    [[nodiscard]] const ColumnStatistics* find(std::string_view name) const {
+        auto it = columns.find(name);
+        return it == columns.end() ? nullptr : &it->second;
+    }
+};
+
+namespace detail {
+
+template <typename T>
+ColumnStatistics column_statistics(std::span<const T> column, size_t histogram_buckets) {
+    ColumnStatistics stats;
+    stats.rows = column.size();
+    stats.is_string = std::is_same_v<T, std::string>;
+
+    HyperLogLog distinct;
+    if constexpr (std::is_same_v<T, std::string>) {
+        for (const auto& value : column) {
+            distinct.add(value);
+        }
+        stats.distinct = std::min(distinct.estimate(), static_cast<double>(column.size()));
+    } else {
+        std::vector<double> values;
+        values.reserve(column.size());
+        for (const T& value : column) {
+            if constexpr (std::floating_point<T>) {
+                if (std::isnan(value)) {
+                    ++stats.null_count;
+                    continue;
+                }
+            }
+            values.push_back(static_cast<double>(value));
+        }
+        if (values.empty()) {
+            return stats;
+        }
+
+        std::sort(values.begin(), values.end());
+        stats.min = values.front();
+        stats.max = values.back();
+
+        // Equi-depth: every bucket holds about the same number of rows, and
+        // equal values never straddle two buckets.
+        const size_t buckets = std::max<size_t>(histogram_buckets, 1);
+        const size_t depth = (values.size() + buckets - 1) / buckets;
+        uint64_t total_distinct = 0;
+        size_t begin = 0;
+        while (begin < values.size()) {
+            size_t end = std::min(begin + depth, values.size());
+            while (end < values.size() && values[end] == values[end - 1]) {
+                ++end;
+            }
+            uint64_t bucket_distinct = 1;
+            for (size_t i = begin + 1; i < end; ++i) {
+                bucket_distinct += values[i] != values[i - 1];
+            }
+            stats.histogram.push_back({values[end - 1], static_cast<uint64_t>(end - begin), bucket_distinct});
+            total_distinct += bucket_distinct;
+            begin = end;
+        }
+        // The values are already sorted, so the exact count is free here.
+        stats.distinct = static_cast<double>(total_distinct);
+    }
+    return stats;
+}
+
+// Fraction of the column's non-null rows with a value below `value` (or at
+// most `value` when `inclusive`), interpolating linearly inside a bucket.
+inline double fraction_below(const ColumnStatistics& stats, double value, bool inclusive) {
+    const uint64_t non_null = stats.rows - stats.null_count;
+    if (non_null == 0 || !stats.min) {
+        return 0.0;
+    }
+    if (value < *stats.min || (!inclusive && value == *stats.min)) {
+        return 0.0;
+    }
+    if (value > *stats.max || (inclusive && value == *stats.max)) {
+        return 1.0;
+    }
+
+    double below = 0.0;
+    double lower = *stats.min;
+    for (const auto& bucket : stats.histogram) {
+        if (value > bucket.upper) {
+            below += static_cast<double>(bucket.count);
+            lower = bucket.upper;
+            continue;
+        }
+        const double width = bucket.upper - lower;
+        const double part = width > 0.0 ? (value - lower) / width : (inclusive ? 1.0 : 0.0);
+        below += std::clamp(part, 0.0, 1.0) * static_cast<double>(bucket.count);
+        break;
+    }
+    return std::clamp(below / static_cast<double>(non_null), 0.0, 1.0);
+}
+
+inline double fraction_equal(const ColumnStatistics& stats, double value) {
+    const uint64_t non_null = stats.rows - stats.null_count;
+    if (non_null == 0 || !stats.min || value < *stats.min || value > *stats.max) {
+        return 0.0;
+    }
+    for (const auto& bucket : stats.histogram) {
+        if (value <= bucket.upper) {
+            return static_cast<double>(bucket.count) / static_cast<double>(bucket.distinct) /
+                   static_cast<double>(non_null);
+        }
+    }
+    return 0.0;
+}
+
+}
+
+// Computes statistics for every column of `table`. Histograms have at most
+// `histogram_buckets` buckets.
+template <typename Table>
+[[nodiscard]] TableStatistics compute_statistics(const Table& table, size_t histogram_buckets = 32) {
+    TableStatistics stats;
+    stats.rows = table.num_rows();
+    for (const auto& name : table.column_names()) {
+        table.visit_column(name, [&](auto column) {
+            using T = typename decltype(column)::value_type;
+            stats.columns[name] = detail::column_statistics<T>(column, histogram_buckets);
+        });
+    }
+    return stats;
+}
+
+// Estimated fraction of rows that satisfy `comparison`. Unknown columns and
+// comparisons the statistics cannot judge (ranges and pattern matches over
+// strings) fall back to fixed guesses; null rows never match.
+[[nodiscard]] inline double estimate_selectivity(const TableStatistics& stats, const Comparison& comparison) {
+    constexpr double kDefaultRange = 1.0 / 3.0;
+
+    const ColumnStatistics* column = stats.find(comparison.column);
+    if (column == nullptr || column->rows == 0) {
+        return 1.0;
+    }
+    const double non_null = static_cast<double>(column->rows - column->null_count) / static_cast<double>(column->rows);
+
+    if (column->is_string || std::holds_alternative<std::string>(comparison.value)) {
+        const double equal = column->distinct > 0.0 ? 1.0 / column->distinct : 0.0;
+        switch (comparison.op) {
+            case CompareOp::Equal:
+                return equal;
+            case CompareOp::NotEqual:
+                return 1.0 - equal;
+            default:
+                return kDefaultRange;
+        }
+    }
+
+    const double value = std::holds_alternative<int64_t>(comparison.value)
+                             ? static_cast<double>(std::get<int64_t>(comparison.value))
+                             : std::get<double>(comparison.value);
+    double fraction = 0.0;
+    switch (comparison.op) {
+        case CompareOp::Equal:
+            fraction = detail::fraction_equal(*column, value);
+            break;
+        case CompareOp::NotEqual:
+            fraction = 1.0 - detail::fraction_equal(*column, value);
+            break;
+        case CompareOp::Less:
+            fraction = detail::fraction_below(*column, value, false);
+            break;
+        case CompareOp::LessEqual:
+            fraction = detail::fraction_below(*column, value, true);
+            break;
+        case CompareOp::Greater:
+            fraction = 1.0 - detail::fraction_below(*column, value, true);
+            break;
+        case CompareOp::GreaterEqual:
+            fraction = 1.0 - detail::fraction_below(*column, value, false);
+            break;
+        case CompareOp::StartsWith:
+        case CompareOp::EndsWith:
+        case CompareOp::Contains:
+        case CompareOp::Like:
+            fraction = kDefaultRange;
+            break;
+    }
+    return std::clamp(fraction, 0.0, 1.0) * non_null;
+}
+
+// Relative cost of evaluating one comparison per row.
+[[nodiscard]] inline double estimate_cost(const TableStatistics& stats, const Comparison& comparison) {
+    constexpr double kStringCost = 4.0;
+    const ColumnStatistics* column = stats.find(comparison.column);
+    return column != nullptr && column->is_string ? kStringCost : 1.0;
+}
+
+// Orders a conjunction so that predicates that remove the most rows per unit
+// of cost run first (ascending cost / (1 - selectivity)). Predicates that
+// remove nothing go last; ties keep their original order.
+[[nodiscard]] inline std::vector<Comparison> order_predicates(const TableStatistics& stats,
+                                                              std::span<const Comparison> where) {
+    std::vector<std::pair<double, size_t>> ranks;
+    ranks.reserve(where.size());
+    for (size_t i = 0; i < where.size(); ++i) {
+        const double removed = 1.0 - estimate_selectivity(stats, where[i]);
+        const double cost = estimate_cost(stats, where[i]);
+        ranks.emplace_back(removed > 0.0 ? cost / removed : std::numeric_limits<double>::infinity(), i);
+    }
+    std::stable_sort(ranks.begin(), ranks.end(),
+                     [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    std::vector<Comparison> ordered;
+    ordered.reserve(where.size());
+    for (const auto& [rank, index] : ranks) {
+        ordered.push_back(where[index]);
+    }
+    return ordered;
+}
+
+// select_rows() with the conjunction reordered by `stats`. Later predicates
+// skip 64-row blocks that earlier ones already cleared, so the order pays off.
+template <typename Table>
+[[nodiscard]] Expected<SelectionBitmap, CsvError>
+select_rows(const Table& table, std::span<const Comparison> where, const TableStatistics& stats) {
+    const auto ordered = order_predicates(stats, where);
+    return select_rows(table, std::span<const Comparison>(ordered));
+}
+
+}
+
+#endif
@@ -0,0 +1,156 @@
+#ifndef COLUMNAR_STREAMING_H
+#define COLUMNAR_STREAMING_H
+
+#include "columnar/csv_reader.h"
+#include "columnar/query.h"
+#include "columnar/thread_pool.h"
+
+#include <concepts>
+#include <optional>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace columnar {
+
+// Running state of a one-pass computation over the rows of a CSV file.
+// add() sees each row's parsed values in column order; merge() folds in
+// the state built over another, disjoint part of the file. Copies of the
+// initial state are handed to each worker, so it must be the identity of
+// merge().
+template <typename A, typename... ColumnTypes>
+concept RowAggregator = std::copy_constructible<A> && requires(A aggregator, const A& other,
+                                                               const ColumnTypes&... values) {
+    aggregator.add(values...);
+    aggregator.merge(other);
+};
+
+namespace detail {
+
+// Parses every field of `line` into `row`, reusing its storage.
+template <ColumnType... ColumnTypes>
+bool parse_csv_row(std::string_view line, std::tuple<ColumnTypes...>& row, char delimiter) {
+    size_t pos = 0;
+    const bool parsed = std::apply(
+        [&](auto&... values) { return (detail::assign_csv_field(values, line, pos, delimiter) && ...); }, row);
+    return parsed && !has_trailing_data(line, pos);
+}
+
+template <typename Aggregator, ColumnType... ColumnTypes>
+std::optional<CsvError> aggregate_csv_range(const std::filesystem::path& filepath, CsvByteRange range,
+                                            Aggregator& aggregator) {
+    std::tuple<ColumnTypes...> row;
+    return read_csv_range_lines(filepath, range, [&](std::string_view line) {
+        if (!parse_csv_row(line, row, ',')) {
+            return false;
+        }
+        std::apply([&](const auto&... values) { aggregator.add(values...); }, row);
+        return true;
+    });
+}
+
+// PartialAggregate over the numeric column at `column`.
+template <ColumnType... ColumnTypes>
+struct ColumnAggregator {
+    size_t column;
+    PartialAggregate partial;
+
+    void add(const ColumnTypes&... values) noexcept {
+        size_t index = 0;
+        (add_if_selected(values, index++), ...);
+    }
+
+    void merge(const ColumnAggregator& other) noexcept { partial.merge(other.partial); }
+
+private:
+    template <typename T>
+    void add_if_selected(const T& value, size_t index) noexcept {
+        if constexpr (!std::is_same_v<T, std::string>) {
+            if (index == column) {
+                partial.add(static_cast<double>(value));
+            }
+        }
+    }
+};
+
+}
+
+// Runs `init` over every row of the file without building a table: each of
+// `parts` byte ranges (pool.size() by default) is parsed on the pool into a
+// copy of `init`, and the copies are merged in file order. Memory use is one
+// row buffer and one aggregator per range, whatever the file size.
+//
+//     struct MaxEnergy {
+//         double max = -inf;
+//         void add(const int64_t&, const double& energy) { max = std::max(max, energy); }
+//         void merge(const MaxEnergy& other) { max = std::max(max, other.max); }
+//     };
+//     auto result = try_aggregate_csv<int64_t, double>("events.csv", pool, MaxEnergy{});
+template <ColumnType... ColumnTypes, typename Aggregator>
+requires RowAggregator<Aggregator, ColumnTypes...>
+[[nodiscard]] Expected<Aggregator, CsvError>
+try_aggregate_csv(const std::filesystem::path& filepath, ThreadPool& pool, Aggregator init, size_t parts = 0) {
+    using Result = Expected<Aggregator, CsvError>;
+
+    auto layout = try_split_csv(filepath, parts == 0 ? pool.size() : parts);
+    if (!layout) {
+        return Result(layout.error());
+    }
+    auto names = Columnar<ColumnTypes...>::try_parse_csv_header(layout->header);
+    if (!names) {
+        return Result(names.error());
+    }
+
+    std::vector<Aggregator> states(layout->ranges.size(), init);
+    std::vector<std::optional<CsvError>> errors(layout->ranges.size());
+    pool.parallel_for(states.size(), [&](size_t i) {
+        errors[i] = detail::aggregate_csv_range<Aggregator, ColumnTypes...>(filepath, layout->ranges[i], states[i]);
+    });
+
+    for (size_t i = 0; i < states.size(); ++i) {
+        if (errors[i]) {
+            return Result(*errors[i]);
+        }
+        init.merge(states[i]);
+    }
+    return Result(std::move(init));
+}
+
+// Count, sum, min and max of one numeric column, computed while parsing.
+// Fails with ColumnNotFound, or ParseError for a string column.
+template <ColumnType... ColumnTypes>
+[[nodiscard]] Expected<PartialAggregate, CsvError>
+try_aggregate_csv_column(const std::filesystem::path& filepath, ThreadPool& pool, std::string_view column,
+                         size_t parts = 0) {
+    using Result = Expected<PartialAggregate, CsvError>;
+
+    auto layout = try_split_csv(filepath, 1);
+    if (!layout) {
+        return Result(layout.error());
+    }
+    auto names = Columnar<ColumnTypes...>::try_parse_csv_header(layout->header);
+    if (!names) {
+        return Result(names.error());
+    }
+
+    const size_t index = detail::find_column(*names, column);
+    if (index == names->size()) {
+        return Result(CsvError::ColumnNotFound);
+    }
+    constexpr std::array<bool, sizeof...(ColumnTypes)> is_string{std::is_same_v<ColumnTypes, std::string>...};
+    if (is_string[index]) {
+        return Result(CsvError::ParseError);
+    }
+
+    auto result = try_aggregate_csv<ColumnTypes...>(filepath, pool, detail::ColumnAggregator<ColumnTypes...>{index, {}},
+                                                    parts);
+    if (!result) {
+        return Result(result.error());
+    }
+    return Result(result->partial);
+}
+
+}
+
+#endif
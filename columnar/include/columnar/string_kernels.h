@@ -0,0 +1,350 @@
+#ifndef COLUMNAR_STRING_KERNELS_H
+#define COLUMNAR_STRING_KERNELS_H
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "columnar/cpu.h"
+
+namespace columnar {
+
+namespace detail {
+
+// Vector passes of find_bytes(): candidate positions are filtered a whole
+// register at a time by comparing the needle's first and last bytes, and
+// memcmp only runs where both match. Each pass starts at `i`, advances it
+// past the positions it has ruled out and returns the match or npos; the
+// caller searches the remaining tail.
+#if COLUMNAR_HAS_AVX512_KERNELS
+COLUMNAR_TARGET_AVX512 inline size_t find_bytes_avx512(std::string_view haystack, std::string_view needle,
+                                                       size_t& i) noexcept {
+    const char* h = haystack.data();
+    const size_t n = haystack.size();
+    const size_t k = needle.size();
+    const __m512i first = _mm512_set1_epi8(needle[0]);
+    const __m512i last = _mm512_set1_epi8(needle[k - 1]);
+    for (; i + k - 1 + 64 <= n; i += 64) {
+        const __m512i block_first = _mm512_loadu_si512(h + i);
+        const __m512i block_last = _mm512_loadu_si512(h + i + k - 1);
+        for (uint64_t mask = _mm512_cmpeq_epi8_mask(first, block_first) & _mm512_cmpeq_epi8_mask(last, block_last);
+             mask != 0; mask &= mask - 1) {
+            const size_t offset = i + static_cast<size_t>(std::countr_zero(mask));
+            if (std::memcmp(h + offset + 1, needle.data() + 1, k - 2) == 0) {
+                return offset;
+            }
+        }
+    }
+    return std::string_view::npos;
+}
+#endif
+
+#if COLUMNAR_HAS_AVX2_KERNELS
+COLUMNAR_TARGET_AVX2 inline size_t find_bytes_avx2(std::string_view haystack, std::string_view needle,
+                                                   size_t& i) noexcept {
+    const char* h = haystack.data();
+    const size_t n = haystack.size();
+    const size_t k = needle.size();
+    const __m256i first = _mm256_set1_epi8(needle[0]);
+    const __m256i last = _mm256_set1_epi8(needle[k - 1]);
+    for (; i + k - 1 + 32 <= n; i += 32) {
+        const __m256i block_first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + i));
+        const __m256i block_last = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + i + k - 1));
+        auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(first, block_first), _mm256_cmpeq_epi8(last, block_last))));
+        for (; mask != 0; mask &= mask - 1) {
+            const size_t offset = i + static_cast<size_t>(std::countr_zero(mask));
+            if (std::memcmp(h + offset + 1, needle.data() + 1, k - 2) == 0) {
+                return offset;
+            }
+        }
+    }
+    return std::string_view::npos;
+}
+#endif
+
+#if defined(__SSE2__)
+inline size_t find_bytes_sse2(std::string_view haystack, std::string_view needle, size_t& i) noexcept {
+    const char* h = haystack.data();
+    const size_t n = haystack.size();
+    const size_t k = needle.size();
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[k - 1]);
+    for (; i + k - 1 + 16 <= n; i += 16) {
+        const __m128i block_first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i));
+        const __m128i block_last = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i + k - 1));
+        auto mask = static_cast<uint32_t>(
+            _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last))));
+        for (; mask != 0; mask &= mask - 1) {
+            const size_t offset = i + static_cast<size_t>(std::countr_zero(mask));
+            if (std::memcmp(h + offset + 1, needle.data() + 1, k - 2) == 0) {
+                return offset;
+            }
+        }
+    }
+    return std::string_view::npos;
+}
+#endif
+
+// Leftmost position of `needle` in `haystack` at or after `from`, or npos.
+inline size_t find_bytes(std::string_view haystack, std::string_view needle, size_t from = 0) noexcept {
+    const size_t n = haystack.size();
+    const size_t k = needle.size();
+    if (from > n || k > n - from) {
+        return std::string_view::npos;
+    }
+    if (k <= 1) {
+        return haystack.find(needle, from);
+    }
+
+    size_t i = from;
+    size_t found = std::string_view::npos;
+    switch (simd_level()) {
+#if COLUMNAR_HAS_AVX512_KERNELS
+        case SimdLevel::Avx512:
+            found = find_bytes_avx512(haystack, needle, i);
+            break;
+#endif
+#if COLUMNAR_HAS_AVX2_KERNELS
+        case SimdLevel::Avx2:
+            found = find_bytes_avx2(haystack, needle, i);
+            break;
+#endif
+        default:
+#if defined(__SSE2__)
+            found = find_bytes_sse2(haystack, needle, i);
+#endif
+            break;
+    }
+    return found != std::string_view::npos ? found : haystack.find(needle, i);
+}
+
+inline bool contains_bytes(std::string_view haystack, std::string_view needle) noexcept {
+    return find_bytes(haystack, needle) != std::string_view::npos;
+}
+
+}
+
+// SQL LIKE pattern: '%' matches any run of characters, '_' exactly one and
+// '\' makes the next character literal. The pattern is compiled once into
+// the literal pieces between '%'s; matching does not allocate.
+class LikePattern {
+public:
+    explicit LikePattern(std::string_view pattern);
+
+    [[nodiscard]] bool matches(std::string_view text) const noexcept;
+
+private:
+    struct Piece {
+        std::string text;
+        // Positions of '_' in `text`, as a per-byte mask; empty if none.
+        std::vector<bool> any;
+    };
+
+    [[nodiscard]] static bool piece_matches_at(const Piece& piece, std::string_view text, size_t at) noexcept;
+    [[nodiscard]] static size_t find_piece(const Piece& piece, std::string_view text, size_t from) noexcept;
+
+    std::vector<Piece> pieces_;
+    bool anchored_start_{true};
+    bool anchored_end_{true};
+    size_t min_length_{0};
+};
+
+inline LikePattern::LikePattern(std::string_view pattern) {
+    Piece current;
+    bool escaped = false;
+    bool seen_percent = false;
+    for (char c : pattern) {
+        if (escaped) {
+            current.text += c;
+            escaped = false;
+            continue;
+        }
+        if (c == '\\') {
+            escaped = true;
+        } else if (c == '%') {
+            if (pieces_.empty() && current.text.empty() && !seen_percent) {
+                anchored_start_ = false;
+            }
+            pieces_.push_back(std::move(current));
+            current = Piece{};
+            seen_percent = true;
+        } else if (c == '_') {
+            current.any.resize(current.text.size(), false);
+            current.any.push_back(true);
+            current.text += '\0';
+        } else {
+            current.text += c;
+        }
+    }
+    if (escaped) {
+        current.text += '\\';
+    }
+    anchored_end_ = !current.text.empty() || !seen_percent;
+    pieces_.push_back(std::move(current));
+
+    // Keep the masks as long as their pieces, and drop empty middle pieces.
+    for (auto& piece : pieces_) {
+        if (!piece.any.empty()) {
+            piece.any.resize(piece.text.size(), false);
+        }
+        min_length_ += piece.text.size();
+    }
+    if (!anchored_start_ && !pieces_.empty() && pieces_.front().text.empty()) {
+        pieces_.erase(pieces_.begin());
+    }
+    if (!anchored_end_ && !pieces_.empty() && pieces_.back().text.empty()) {
+        pieces_.pop_back();
+    }
+}
+
+inline bool LikePattern::piece_matches_at(const Piece& piece, std::string_view text, size_t at) noexcept {
+    if (at + piece.text.size() > text.size()) {
+        return false;
+    }
+    if (piece.any.empty()) {
+        return std::memcmp(text.data() + at, piece.text.data(), piece.text.size()) == 0;
+    }
+    for (size_t i = 0; i < piece.text.size(); ++i) {
+        if (!piece.any[i] && text[at + i] != piece.text[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Leftmost position at or after `from` where `piece` matches, or npos.
+inline size_t LikePattern::find_piece(const Piece& piece, std::string_view text, size_t from) noexcept {
+    if (piece.any.empty()) {
+        return detail::find_bytes(text, piece.text, from);
+    }
+    for (size_t at = from; at + piece.text.size() <= text.size(); ++at) {
+        if (piece_matches_at(piece, text, at)) {
+            return at;
+        }
+    }
+    return std::string_view::npos;
+}
+
+// The pieces have fixed lengths, so taking the leftmost match of every
+// middle piece never rules out a match that a later choice would allow.
+inline bool LikePattern::matches(std::string_view text) const noexcept {
+    if (text.size() < min_length_) {
+        return false;
+    }
+    if (pieces_.empty()) {
+        return true;
+    }
+    if (pieces_.size() == 1 && anchored_start_ && anchored_end_) {
+        return text.size() == pieces_[0].text.size() && piece_matches_at(pieces_[0], text, 0);
+    }
+
+    size_t first = 0;
+    size_t last = pieces_.size();
+    size_t position = 0;
+    size_t end = text.size();
+
+    if (anchored_start_) {
+        if (!piece_matches_at(pieces_[0], text, 0)) {
+            return false;
+        }
+        position = pieces_[0].text.size();
+        ++first;
+    }
+    if (anchored_end_ && last > first) {
+        const Piece& tail = pieces_[last - 1];
+        if (tail.text.size() > end - position || !piece_matches_at(tail, text, end - tail.text.size())) {
+            return false;
+        }
+        end -= tail.text.size();
+        --last;
+    }
+
+    const std::string_view middle = text.substr(0, end);
+    for (size_t p = first; p < last; ++p) {
+        const Piece& piece = pieces_[p];
+        if (piece.text.empty()) {
+            continue;
+        }
+        const size_t found = find_piece(piece, middle, position);
+        if (found == std::string_view::npos) {
+            return false;
+        }
+        position = found + piece.text.size();
+    }
+    return true;
+}
+
+enum class StringMatchKind {
+    Equals,
+    StartsWith,
+    EndsWith,
+    Contains,
+    Like
+};
+
+// A string predicate prepared once and applied to many values.
+class StringMatcher {
+public:
+    StringMatcher(StringMatchKind kind, std::string pattern) : kind_(kind), pattern_(std::move(pattern)) {
+        if (kind_ == StringMatchKind::Like) {
+            like_.emplace(pattern_);
+        }
+    }
+
+    [[nodiscard]] bool matches(std::string_view text) const noexcept {
+        const std::string_view pattern(pattern_);
+        switch (kind_) {
+            case StringMatchKind::Equals:
+                return text.size() == pattern.size() && std::memcmp(text.data(), pattern.data(), text.size()) == 0;
+            case StringMatchKind::StartsWith:
+                return text.size() >= pattern.size() && std::memcmp(text.data(), pattern.data(), pattern.size()) == 0;
+            case StringMatchKind::EndsWith:
+                return text.size() >= pattern.size() &&
+                       std::memcmp(text.data() + text.size() - pattern.size(), pattern.data(), pattern.size()) == 0;
+            case StringMatchKind::Contains:
+                return detail::contains_bytes(text, pattern);
+            case StringMatchKind::Like:
+                return like_->matches(text);
+        }
+        return false;
+    }
+
+private:
+    StringMatchKind kind_;
+    std::string pattern_;
+    std::optional<LikePattern> like_;
+};
+
+namespace detail {
+
+// ANDs `matcher` over `column` into `words`, skipping 64-row blocks that are
+// already clear. Works on any element convertible to std::string_view.
+template <typename S>
+void match_into_words(std::span<const S> column, const StringMatcher& matcher, uint64_t* words) {
+    const size_t word_count = (column.size() + 63) / 64;
+    for (size_t w = 0; w < word_count; ++w) {
+        if (words[w] == 0) {
+            continue;
+        }
+        const size_t begin = w * 64;
+        const size_t rows = std::min<size_t>(64, column.size() - begin);
+        uint64_t bits = 0;
+        for (size_t b = 0; b < rows; ++b) {
+            bits |= static_cast<uint64_t>(matcher.matches(std::string_view(column[begin + b]))) << b;
+        }
+        words[w] &= bits;
+    }
+}
+
+}
+
+}
+
+#endif
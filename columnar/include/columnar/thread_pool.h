@@ -0,0 +1,104 @@
+#ifndef COLUMNAR_THREAD_POOL_H
+#define COLUMNAR_THREAD_POOL_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <latch>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace columnar {
+
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t thread_count = std::max(1u, std::thread::hardware_concurrency()));
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool();
+
+    void submit(std::function<void()> task);
+
+    // Runs fn(0) ... fn(count - 1) on the pool and blocks until all of them have
+    // returned. Must not be called from a pool thread.
+    template <typename F>
+    void parallel_for(size_t count, F&& fn);
+
+    [[nodiscard]] size_t size() const noexcept { return workers_.size(); }
+
+private:
+    void worker_loop();
+
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_{false};
+};
+
+inline ThreadPool::ThreadPool(size_t thread_count) {
+    workers_.reserve(std::max<size_t>(thread_count, 1));
+    for (size_t i = 0; i < std::max<size_t>(thread_count, 1); ++i) {
+        workers_.emplace_back([this] { worker_loop(); });
+    }
+}
+
+inline ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+inline void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard lock(mutex_);
+        tasks_.push_back(std::move(task));
+    }
+    cv_.notify_one();
+}
+
+template <typename F>
+void ThreadPool::parallel_for(size_t count, F&& fn) {
+    if (count == 0) {
+        return;
+    }
+
+    std::latch remaining(static_cast<std::ptrdiff_t>(count));
+    for (size_t i = 0; i < count; ++i) {
+        submit([&fn, &remaining, i] {
+            fn(i);
+            remaining.count_down();
+        });
+    }
+    remaining.wait();
+}
+
+inline void ThreadPool::worker_loop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock lock(mutex_);
+            cv_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+            if (tasks_.empty()) {
+                return;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+        task();
+    }
+}
+
+}
+
+#endif
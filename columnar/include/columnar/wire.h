@@ -0,0 +1,276 @@
+#ifndef COLUMNAR_WIRE_H
+#define COLUMNAR_WIRE_H
+
+#include "columnar/query.h"
+#include "columnar/snapshot.h"
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+
+namespace columnar {
+
+// Binary encoding of QueryRequest / QueryResult messages exchanged with a
+// QueryServer. Every message starts with a MessageType byte; result columns
+// use the same payload layout as snapshot columns.
+enum class MessageType : uint8_t {
+    Query = 1,
+    Result = 2,
+    LoadTable = 3
+};
+
+// Asks a worker to hold `snapshot` (the serialize() encoding of a table) under
+// the name `table`. `snapshot` points into the decoded frame.
+struct LoadRequest {
+    std::string table;
+    std::span<const char> snapshot;
+};
+
+namespace detail {
+
+enum class ScalarKind : uint8_t {
+    Integer = 0,
+    Real = 1,
+    Text = 2
+};
+
+inline void write_scalar(SnapshotWriter& writer, const Scalar& value) {
+    if (const auto* integer = std::get_if<int64_t>(&value)) {
+        writer.pod(ScalarKind::Integer);
+        writer.pod(*integer);
+    } else if (const auto* real = std::get_if<double>(&value)) {
+        writer.pod(ScalarKind::Real);
+        writer.pod(*real);
+    } else {
+        writer.pod(ScalarKind::Text);
+        writer.str(std::get<std::string>(value));
+    }
+}
+
+inline bool read_scalar(SnapshotReader& reader, Scalar& value) {
+    ScalarKind kind{};
+    if (!reader.pod(kind)) {
+        return false;
+    }
+    switch (kind) {
+        case ScalarKind::Integer: {
+            int64_t integer = 0;
+            value = integer;
+            return reader.pod(std::get<int64_t>(value));
+        }
+        case ScalarKind::Real: {
+            double real = 0.0;
+            value = real;
+            return reader.pod(std::get<double>(value));
+        }
+        case ScalarKind::Text: {
+            value = std::string();
+            return reader.str(std::get<std::string>(value));
+        }
+    }
+    return false;
+}
+
+template <typename Enum>
+bool read_enum(SnapshotReader& reader, Enum& value, Enum last) {
+    uint8_t raw = 0;
+    if (!reader.pod(raw) || raw > static_cast<uint8_t>(last)) {
+        return false;
+    }
+    value = static_cast<Enum>(raw);
+    return true;
+}
+
+template <typename T, typename ReadItem>
+bool read_list(SnapshotReader& reader, std::vector<T>& items, ReadItem read_item) {
+    uint32_t count = 0;
+    if (!reader.pod(count)) {
+        return false;
+    }
+    items.clear();
+    for (uint32_t i = 0; i < count; ++i) {
+        T item{};
+        if (!read_item(item)) {
+            return false;
+        }
+        items.push_back(std::move(item));
+    }
+    return true;
+}
+
+}
+
+inline void encode(const QueryRequest& request, std::string& out) {
+    detail::SnapshotWriter writer(out);
+    writer.pod(MessageType::Query);
+    writer.str(request.table);
+
+    writer.pod(static_cast<uint32_t>(request.where.size()));
+    for (const auto& comparison : request.where) {
+        writer.str(comparison.column);
+        writer.pod(static_cast<uint8_t>(comparison.op));
+        detail::write_scalar(writer, comparison.value);
+    }
+
+    writer.pod(static_cast<uint32_t>(request.columns.size()));
+    for (const auto& column : request.columns) {
+        writer.str(column);
+    }
+
+    writer.pod(static_cast<uint32_t>(request.aggregates.size()));
+    for (const auto& request_aggregate : request.aggregates) {
+        writer.pod(static_cast<uint8_t>(request_aggregate.op));
+        writer.str(request_aggregate.column);
+    }
+
+    writer.pod(request.limit);
+}
+
+[[nodiscard]] inline Expected<QueryRequest, CsvError> try_decode_request(std::span<const char> data) {
+    using Result = Expected<QueryRequest, CsvError>;
+
+    detail::SnapshotReader reader(data);
+    QueryRequest request;
+    MessageType type{};
+
+    bool ok = reader.pod(type) && type == MessageType::Query && reader.str(request.table) &&
+              detail::read_list(reader, request.where, [&](Comparison& comparison) {
+                  return reader.str(comparison.column) &&
+                         detail::read_enum(reader, comparison.op, CompareOp::Like) &&
+                         detail::read_scalar(reader, comparison.value);
+              }) &&
+              detail::read_list(reader, request.columns, [&](std::string& column) { return reader.str(column); }) &&
+              detail::read_list(reader, request.aggregates, [&](Aggregate& request_aggregate) {
+                  return detail::read_enum(reader, request_aggregate.op, AggregateOp::Mean) &&
+                         reader.str(request_aggregate.column);
+              }) &&
+              reader.pod(request.limit);
+
+    if (!ok) {
+        return Result(CsvError::InvalidFormat);
+    }
+    return Result(std::move(request));
+}
+
+// Encodes either a result or the error that prevented one.
+inline void encode(const Expected<QueryResult, CsvError>& result, std::string& out) {
+    detail::SnapshotWriter writer(out);
+    writer.pod(MessageType::Result);
+    if (!result) {
+        writer.pod(static_cast<uint8_t>(1 + static_cast<int>(result.error())));
+        return;
+    }
+    writer.pod(uint8_t{0});
+    writer.pod(result->matched_rows);
+
+    writer.pod(static_cast<uint32_t>(result->aggregates.size()));
+    for (double value : result->aggregates) {
+        writer.pod(value);
+    }
+
+    writer.pod(static_cast<uint32_t>(result->partials.size()));
+    for (const auto& partial : result->partials) {
+        writer.pod(partial.count);
+        writer.pod(partial.sum);
+        writer.pod(partial.min);
+        writer.pod(partial.max);
+    }
+
+    writer.pod(static_cast<uint32_t>(result->columns.size()));
+    for (const auto& column : result->columns) {
+        writer.str(column.name);
+        writer.pod(static_cast<uint8_t>(column.values.index()));
+        std::visit([&](const auto& values) {
+            writer.pod(static_cast<uint64_t>(values.size()));
+            detail::write_column(writer, std::span{values});
+        }, column.values);
+    }
+}
+
+[[nodiscard]] inline Expected<QueryResult, CsvError> try_decode_result(std::span<const char> data) {
+    using Result = Expected<QueryResult, CsvError>;
+
+    detail::SnapshotReader reader(data);
+    MessageType type{};
+    uint8_t status = 0;
+    if (!reader.pod(type) || type != MessageType::Result || !reader.pod(status)) {
+        return Result(CsvError::InvalidFormat);
+    }
+    if (status != 0) {
+        if (status - 1 > static_cast<int>(CsvError::IoError)) {
+            return Result(CsvError::InvalidFormat);
+        }
+        return Result(static_cast<CsvError>(status - 1));
+    }
+
+    QueryResult result;
+    bool ok = reader.pod(result.matched_rows) &&
+              detail::read_list(reader, result.aggregates, [&](double& value) { return reader.pod(value); }) &&
+              detail::read_list(reader, result.partials, [&](PartialAggregate& partial) {
+                  return reader.pod(partial.count) && reader.pod(partial.sum) && reader.pod(partial.min) &&
+                         reader.pod(partial.max);
+              }) &&
+              detail::read_list(reader, result.columns, [&](ResultColumn& column) {
+                  uint8_t kind = 0;
+                  uint64_t rows = 0;
+                  if (!reader.str(column.name) || !reader.pod(kind) || !reader.pod(rows)) {
+                      return false;
+                  }
+                  switch (kind) {
+                      case 0:
+                          column.values = std::vector<int64_t>();
+                          return detail::read_column(reader, rows, std::get<0>(column.values));
+                      case 1:
+                          column.values = std::vector<double>();
+                          return detail::read_column(reader, rows, std::get<1>(column.values));
+                      case 2:
+                          column.values = std::vector<std::string>();
+                          return detail::read_column(reader, rows, std::get<2>(column.values));
+                      default:
+                          return false;
+                  }
+              });
+
+    if (!ok) {
+        return Result(CsvError::InvalidFormat);
+    }
+    return Result(std::move(result));
+}
+
+// Snapshot payloads are 8-byte aligned relative to their own start, so the
+// header is padded to keep offsets within the message consistent.
+template <ColumnType... ColumnTypes>
+void encode_load(const std::string& table_name, const Columnar<ColumnTypes...>& table, std::string& out) {
+    detail::SnapshotWriter writer(out);
+    const size_t start = out.size();
+    writer.pod(MessageType::LoadTable);
+    writer.str(table_name);
+    out.append((8 - (out.size() - start) % 8) % 8, '\0');
+    serialize(table, out);
+}
+
+[[nodiscard]] inline Expected<LoadRequest, CsvError> try_decode_load(std::span<const char> data) {
+    using Result = Expected<LoadRequest, CsvError>;
+
+    detail::SnapshotReader reader(data);
+    LoadRequest request;
+    MessageType type{};
+    if (!reader.pod(type) || type != MessageType::LoadTable || !reader.str(request.table) || !reader.align()) {
+        return Result(CsvError::InvalidFormat);
+    }
+    request.snapshot = data.subspan(reader.position());
+    return Result(std::move(request));
+}
+
+[[nodiscard]] inline std::optional<MessageType> peek_message_type(std::span<const char> data) {
+    if (data.empty() || data[0] < static_cast<char>(MessageType::Query) ||
+        data[0] > static_cast<char>(MessageType::LoadTable)) {
+        return std::nullopt;
+    }
+    return static_cast<MessageType>(data[0]);
+}
+
+}
+
+#endif
@@ -0,0 +1,225 @@
+// C++20 module interface for the library: `import columnar;` instead of
+// including the headers. Built by the columnar_module target when
+// COLUMNAR_BUILD_MODULE is on. Macros such as COLUMNAR_INSTANTIATE_SCHEMA
+// cannot be exported; include columnar/columnar.h where they are needed.
+module;
+
+#include "columnar/adaptive.h"
+#include "columnar/async.h"
+#include "columnar/buffer_manager.h"
+#include "columnar/columnar.h"
+#include "columnar/correlation.h"
+#include "columnar/cpu.h"
+#include "columnar/csv_reader.h"
+#include "columnar/distinct.h"
+#include "columnar/distributed.h"
+#include "columnar/external.h"
+#include "columnar/gather.h"
+#include "columnar/hash.h"
+#include "columnar/ingest.h"
+#include "columnar/interning.h"
+#include "columnar/math_kernels.h"
+#include "columnar/numa.h"
+#include "columnar/query.h"
+#include "columnar/query_cache.h"
+#include "columnar/regression.h"
+#include "columnar/reshape.h"
+#include "columnar/server.h"
+#include "columnar/snapshot.h"
+#include "columnar/statistics.h"
+#include "columnar/streaming.h"
+#include "columnar/string_kernels.h"
+#include "columnar/thread_pool.h"
+#include "columnar/wire.h"
+
+export module columnar;
+
+export namespace columnar {
+
+// adaptive.h
+using columnar::AdaptiveFilter;
+using columnar::AdaptiveFilterOptions;
+using columnar::PredicateProfile;
+using columnar::select_rows_adaptive;
+
+// async.h
+using columnar::AsyncCsvStream;
+using columnar::CoroutineResumer;
+
+// buffer_manager.h
+using columnar::BufferManager;
+using columnar::ManagedTable;
+using columnar::PinnedChunk;
+
+// columnar.h
+using columnar::ColumnType;
+using columnar::Columnar;
+using columnar::ColumnarView;
+using columnar::CsvError;
+using columnar::Expected;
+
+// correlation.h
+using columnar::CovarianceAccumulator;
+using columnar::CovarianceMatrix;
+using columnar::covariance_matrix;
+
+// cpu.h
+using columnar::SimdLevel;
+using columnar::parse_simd_level;
+using columnar::set_simd_level;
+using columnar::simd_level;
+using columnar::simd_level_name;
+using columnar::supported_simd_level;
+
+// csv_reader.h
+using columnar::CsvBatchReader;
+using columnar::CsvByteRange;
+using columnar::CsvLayout;
+using columnar::try_read_csv_range;
+using columnar::try_read_from_csv_parallel;
+using columnar::try_split_csv;
+
+// distinct.h
+using columnar::DistinctCounter;
+using columnar::DuplicateKeep;
+using columnar::ValueCounts;
+using columnar::combine_column_hash;
+using columnar::drop_duplicates;
+using columnar::hash_column;
+using columnar::select_unique_rows;
+using columnar::unique;
+using columnar::value_counts;
+
+// distributed.h
+#if defined(__unix__) || defined(__APPLE__)
+using columnar::Coordinator;
+using columnar::Partitioning;
+using columnar::hash_partition;
+#endif
+
+// external.h
+using columnar::ExternalGroupBy;
+using columnar::ExternalSorter;
+using columnar::SortOrder;
+using columnar::SpillOptions;
+
+// gather.h
+using columnar::gather;
+using columnar::gather_into;
+using columnar::scatter;
+
+// hash.h
+using columnar::fingerprint;
+using columnar::hash_bytes;
+using columnar::hash_value;
+using columnar::mix64;
+
+// ingest.h
+using columnar::IngestQueue;
+
+// interning.h
+using columnar::StringInterner;
+using columnar::hash_strings;
+using columnar::intern_column;
+
+// math_kernels.h
+using columnar::azimuth;
+using columnar::invariant_mass;
+using columnar::pseudorapidity;
+using columnar::total_momentum;
+using columnar::transverse_momentum;
+using columnar::vector_atan2;
+using columnar::vector_exp;
+using columnar::vector_hypot;
+using columnar::vector_log;
+using columnar::vector_sqrt;
+
+// numa.h
+using columnar::NumaPartition;
+using columnar::NumaTable;
+using columnar::NumaTopology;
+using columnar::bind_memory_to_node;
+using columnar::numa_parallel_for;
+using columnar::pin_current_thread_to_node;
+using columnar::try_read_from_csv_numa;
+
+// query.h
+using columnar::Aggregate;
+using columnar::AggregateOp;
+using columnar::CompareOp;
+using columnar::Comparison;
+using columnar::PartialAggregate;
+using columnar::QueryRequest;
+using columnar::QueryResult;
+using columnar::ResultColumn;
+using columnar::ResultValues;
+using columnar::Scalar;
+using columnar::SelectionBitmap;
+using columnar::aggregate;
+using columnar::execute_query;
+using columnar::partial_aggregate;
+using columnar::select_rows;
+
+// query_cache.h
+using columnar::QueryCache;
+
+// regression.h
+using columnar::LinearFit;
+using columnar::fit_linear;
+
+// reshape.h
+using columnar::melt;
+using columnar::pivot;
+
+// server.h
+#if defined(__unix__) || defined(__APPLE__)
+using columnar::QueryClient;
+using columnar::QueryServer;
+#endif
+
+// snapshot.h
+using columnar::MappedFile;
+using columnar::SnapshotInfo;
+using columnar::csv_cache_key;
+using columnar::serialize;
+using columnar::try_deserialize;
+using columnar::try_read_from_csv_cached;
+using columnar::try_read_snapshot;
+using columnar::try_read_snapshot_info;
+using columnar::type_signature;
+using columnar::write_snapshot;
+
+// statistics.h
+using columnar::ColumnStatistics;
+using columnar::HistogramBucket;
+using columnar::HyperLogLog;
+using columnar::TableStatistics;
+using columnar::compute_statistics;
+using columnar::estimate_cost;
+using columnar::estimate_selectivity;
+using columnar::order_predicates;
+
+// streaming.h
+using columnar::RowAggregator;
+using columnar::try_aggregate_csv;
+using columnar::try_aggregate_csv_column;
+
+// string_kernels.h
+using columnar::LikePattern;
+using columnar::StringMatchKind;
+using columnar::StringMatcher;
+
+// thread_pool.h
+using columnar::ThreadPool;
+
+// wire.h
+using columnar::LoadRequest;
+using columnar::MessageType;
+using columnar::encode;
+using columnar::encode_load;
+using columnar::peek_message_type;
+using columnar::try_decode_load;
+using columnar::try_decode_request;
+using columnar::try_decode_result;
+
+}
@@ -0,0 +1,30 @@
+#ifndef COLUMNAR_TESTS_SIMD_TEST_UTIL_H
+#define COLUMNAR_TESTS_SIMD_TEST_UTIL_H
+
+#include "columnar/cpu.h"
+
+#include <vector>
+
+// Restores the level in use when a test ends.
+class SimdLevelGuard {
+public:
+    SimdLevelGuard() : saved_(columnar::simd_level()) {}
+    ~SimdLevelGuard() { columnar::set_simd_level(saved_); }
+
+private:
+    columnar::SimdLevel saved_;
+};
+
+// Every level this machine can run, lowest first.
+inline std::vector<columnar::SimdLevel> available_levels() {
+    using columnar::SimdLevel;
+    std::vector<SimdLevel> levels;
+    for (SimdLevel level : {SimdLevel::Scalar, SimdLevel::Avx2, SimdLevel::Avx512}) {
+        if (level <= columnar::supported_simd_level()) {
+            levels.push_back(level);
+        }
+    }
+    return levels;
+}
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef COLUMNAR_TESTS_TEMP_DIR_UTIL_H
+#define COLUMNAR_TESTS_TEMP_DIR_UTIL_H
+
+#include <atomic>
+#include <filesystem>
+#include <string>
+
+#if defined(_WIN32)
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+// An empty directory under the system temp directory, removed with its
+// contents when the object goes away. ctest runs each test in its own
+// process, possibly in parallel, so the name carries the process id as well
+// as a per-process sequence number.
+class TempDirectory {
+public:
+    explicit TempDirectory(const std::string& prefix = "columnar_test")
+        : path_(std::filesystem::temp_directory_path() /
+                (prefix + "_" + std::to_string(process_id()) + "_" + std::to_string(next_sequence()))) {
+        std::filesystem::remove_all(path_);
+        std::filesystem::create_directories(path_);
+    }
+    ~TempDirectory() {
+        std::error_code ec;
+        std::filesystem::remove_all(path_, ec);
+    }
+
+    TempDirectory(const TempDirectory&) = delete;
+    TempDirectory& operator=(const TempDirectory&) = delete;
+
+    [[nodiscard]] const std::filesystem::path& path() const { return path_; }
+    [[nodiscard]] bool empty() const { return std::filesystem::is_empty(path_); }
+
+private:
+    static long process_id() {
+#if defined(_WIN32)
+        return static_cast<long>(::_getpid());
+#else
+        return static_cast<long>(::getpid());
+#endif
+    }
+
+    static unsigned next_sequence() {
+        static std::atomic<unsigned> sequence{0};
+        return sequence++;
+    }
+
+    std::filesystem::path path_;
+};
+
+#endif
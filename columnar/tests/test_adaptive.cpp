@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+#include "columnar/adaptive.h"
+
+#include <random>
+
+using namespace columnar;
+
+namespace {
+
+using TradeTable = Columnar<int64_t, double, std::string>;
+
+TradeTable make_trades(size_t rows) {
+    TradeTable table({"id", "price", "venue"});
+    std::mt19937_64 rng(5);
+    std::uniform_real_distribution<double> price(0.0, 100.0);
+    for (size_t i = 0; i < rows; ++i) {
+        table.append_row(static_cast<int64_t>(i), price(rng), i % 10 == 0 ? "XNAS" : "XNYS-ARCA-EXCHANGE");
+    }
+    return table;
+}
+
+}
+
+TEST(AdaptiveFilterTest, MatchesStaticEvaluation) {
+    const auto table = make_trades(50000);
+    const std::vector<std::vector<Comparison>> queries{
+        {},
+        {{"price", CompareOp::Less, 50.0}},
+        {{"venue", CompareOp::Equal, std::string("XNAS")}, {"price", CompareOp::GreaterEqual, 99.0}},
+        {{"price", CompareOp::Greater, 1.0}, {"id", CompareOp::Less, int64_t{300}}, {"id", CompareOp::NotEqual, int64_t{7}}},
+        {{"id", CompareOp::Greater, int64_t{100000}}, {"price", CompareOp::Less, 50.0}},
+    };
+    for (const auto& where : queries) {
+        auto adaptive = select_rows_adaptive(table, where, {1000, 2, 4, 0.05});
+        auto expected = select_rows(table, where);
+        ASSERT_TRUE(adaptive.has_value());
+        EXPECT_EQ(adaptive->to_indices(), expected->to_indices());
+    }
+}
+
+TEST(AdaptiveFilterTest, LearnsSelectiveCheapPredicateFirst) {
+    const auto table = make_trades(200000);
+    AdaptiveFilter filter({{"venue", CompareOp::NotEqual, std::string("XNAS")},
+                           {"price", CompareOp::Greater, 0.5},
+                           {"id", CompareOp::Less, int64_t{150000}},
+                           {"price", CompareOp::Less, 2.0}},
+                          {4096, 4, 8, 1.0 / 32.0});
+
+    auto selected = filter.select(table);
+    ASSERT_TRUE(selected.has_value());
+
+    const auto order = filter.current_order();
+    EXPECT_EQ(order[0].column, "price");
+    EXPECT_EQ(order[0].op, CompareOp::Less);
+    EXPECT_GT(filter.selection_vector_morsels(), 0u);
+
+    const auto& profile = filter.profile(3);
+    EXPECT_NEAR(profile.pass_rate(), 0.02, 0.01);
+    EXPECT_GT(profile.rows_in, 0u);
+}
+
+TEST(AdaptiveFilterTest, DenseSelectionsStayOnBitmaps) {
+    const auto table = make_trades(20000);
+    AdaptiveFilter filter({{"price", CompareOp::GreaterEqual, 10.0}, {"id", CompareOp::GreaterEqual, int64_t{0}}},
+                          {2048, 4, 8, 1.0 / 32.0});
+    ASSERT_TRUE(filter.select(table).has_value());
+    EXPECT_EQ(filter.selection_vector_morsels(), 0u);
+    EXPECT_EQ(filter.bitmap_morsels(), 10u);
+}
+
+TEST(AdaptiveFilterTest, ReportsInvalidPredicates) {
+    const auto table = make_trades(10);
+    EXPECT_EQ(select_rows_adaptive(table, std::vector<Comparison>{{"volume", CompareOp::Less, 1.0}}).error(),
+              CsvError::ColumnNotFound);
+    EXPECT_EQ(select_rows_adaptive(table, std::vector<Comparison>{{"venue", CompareOp::Less, 1.0}}).error(),
+              CsvError::ParseError);
+}
@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include "columnar/async.h"
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <thread>
+
+using namespace columnar;
+
+namespace {
+
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+class EventLoop {
+public:
+    void post(std::coroutine_handle<> handle) {
+        {
+            std::lock_guard lock(mutex_);
+            queue_.push_back(handle);
+        }
+        cv_.notify_one();
+    }
+
+    void run_until(const std::function<bool()>& finished) {
+        while (!finished()) {
+            std::coroutine_handle<> handle;
+            {
+                std::unique_lock lock(mutex_);
+                cv_.wait(lock, [this] { return !queue_.empty(); });
+                handle = queue_.front();
+                queue_.pop_front();
+            }
+            EXPECT_EQ(std::this_thread::get_id(), loop_thread_);
+            handle.resume();
+        }
+    }
+
+private:
+    std::thread::id loop_thread_ = std::this_thread::get_id();
+    std::deque<std::coroutine_handle<>> queue_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+};
+
+struct LoadSummary {
+    size_t rows = 0;
+    size_t batches = 0;
+    double energy_sum = 0.0;
+    std::optional<CsvError> error;
+};
+
+DetachedTask load_particles(std::string path, ThreadPool& pool, size_t batch_rows,
+                            CoroutineResumer resumer, std::promise<LoadSummary>& done) {
+    LoadSummary summary;
+    auto stream = AsyncCsvStream<int, double, double, double, double>::open(path, pool, batch_rows, resumer);
+
+    while (!stream.done()) {
+        auto batch = co_await stream.next();
+        if (!batch) {
+            summary.error = batch.error();
+            break;
+        }
+        if (batch->num_rows() == 0) continue;
+
+        ++summary.batches;
+        summary.rows += batch->num_rows();
+        for (double e : batch->get_column_view<4>()) {
+            summary.energy_sum += e;
+        }
+    }
+
+    done.set_value(summary);
+}
+
+}
+
+TEST(AsyncCsvStreamTest, StreamsAllBatches) {
+    ThreadPool pool(2);
+    std::promise<LoadSummary> done;
+    auto future = done.get_future();
+
+    load_particles("data/particles.csv", pool, 3, {}, done);
+    auto summary = future.get();
+
+    auto expected = Columnar<int, double, double, double, double>::try_read_from_csv("data/particles.csv");
+    ASSERT_TRUE(expected.has_value());
+
+    EXPECT_FALSE(summary.error.has_value());
+    EXPECT_EQ(summary.rows, expected->num_rows());
+    EXPECT_EQ(summary.batches, 4u);
+
+    double energy_sum = 0.0;
+    for (double e : expected->get_column_view<4>()) {
+        energy_sum += e;
+    }
+    EXPECT_DOUBLE_EQ(summary.energy_sum, energy_sum);
+}
+
+TEST(AsyncCsvStreamTest, MissingFileReportsError) {
+    ThreadPool pool(1);
+    std::promise<LoadSummary> done;
+    auto future = done.get_future();
+
+    load_particles("nonexistent.csv", pool, 4, {}, done);
+    auto summary = future.get();
+
+    ASSERT_TRUE(summary.error.has_value());
+    EXPECT_EQ(*summary.error, CsvError::FileNotFound);
+    EXPECT_EQ(summary.rows, 0u);
+}
+
+TEST(AsyncCsvStreamTest, ConcurrentLoadsOnSingleEventLoop) {
+    ThreadPool pool(2);
+    EventLoop loop;
+    auto resumer = [&loop](std::coroutine_handle<> handle) { loop.post(handle); };
+
+    constexpr size_t kLoads = 4;
+    std::vector<std::promise<LoadSummary>> promises(kLoads);
+    std::vector<std::future<LoadSummary>> futures;
+    for (auto& promise : promises) {
+        futures.push_back(promise.get_future());
+    }
+
+    for (size_t i = 0; i < kLoads; ++i) {
+        load_particles("data/particles.csv", pool, i + 1, resumer, promises[i]);
+    }
+
+    loop.run_until([&] {
+        return std::all_of(futures.begin(), futures.end(), [](const auto& f) {
+            return f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        });
+    });
+
+    for (auto& future : futures) {
+        auto summary = future.get();
+        EXPECT_FALSE(summary.error.has_value());
+        EXPECT_EQ(summary.rows, 10u);
+    }
+}
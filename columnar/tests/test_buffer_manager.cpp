@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include "columnar/buffer_manager.h"
+#include "temp_dir_util.h"
+
+using namespace columnar;
+
+namespace {
+
+using ReadingTable = Columnar<int64_t, double>;
+
+ReadingTable make_readings(size_t rows) {
+    ReadingTable table({"id", "value"});
+    for (size_t i = 0; i < rows; ++i) {
+        table.append_row(static_cast<int64_t>(i), 0.5 * static_cast<double>(i));
+    }
+    return table;
+}
+
+constexpr size_t kChunkRows = 1000;
+constexpr size_t kChunkBytes = kChunkRows * (sizeof(int64_t) + sizeof(double));
+
+}
+
+TEST(BufferManagerTest, SpillsChunksBeyondBudget) {
+    TempDirectory spill("columnar_buffers");
+    BufferManager manager(3 * kChunkBytes, spill.path());
+    auto table = ManagedTable<int64_t, double>::from_table(manager, make_readings(10 * kChunkRows), kChunkRows);
+
+    EXPECT_EQ(table.chunk_count(), 10u);
+    EXPECT_EQ(table.num_rows(), 10 * kChunkRows);
+    EXPECT_LE(manager.resident_bytes(), manager.memory_budget());
+    EXPECT_GE(manager.evictions(), 7u);
+
+    double sum = 0.0;
+    auto rows = table.scan([&](const ReadingTable& chunk, size_t first_row) {
+        EXPECT_EQ(chunk.get_column_view<0>()[0], static_cast<int64_t>(first_row));
+        for (double value : chunk.get_column_view<1>()) {
+            sum += value;
+        }
+    });
+    ASSERT_TRUE(rows.has_value());
+    EXPECT_EQ(*rows, 10 * kChunkRows);
+    EXPECT_DOUBLE_EQ(sum, 0.5 * (10.0 * kChunkRows) * (10.0 * kChunkRows - 1) / 2.0);
+    EXPECT_GT(manager.loads(), 0u);
+    EXPECT_LE(manager.resident_bytes(), manager.memory_budget());
+}
+
+TEST(BufferManagerTest, PinnedChunksStayResident) {
+    TempDirectory spill("columnar_buffers");
+    BufferManager manager(2 * kChunkBytes, spill.path());
+    auto table = ManagedTable<int64_t, double>::from_table(manager, make_readings(6 * kChunkRows), kChunkRows);
+
+    auto first = table.pin(0);
+    ASSERT_TRUE(first.has_value());
+    for (size_t chunk = 1; chunk < table.chunk_count(); ++chunk) {
+        auto pinned = table.pin(chunk);
+        ASSERT_TRUE(pinned.has_value());
+        EXPECT_TRUE(table.resident(0));
+    }
+    EXPECT_EQ((*first)->get_column_view<0>()[kChunkRows - 1], static_cast<int64_t>(kChunkRows - 1));
+
+    EXPECT_EQ(table.pin(table.chunk_count()).error(), CsvError::RowIndexOutOfBounds);
+}
+
+TEST(BufferManagerTest, SnapshotChunksAreDroppedNotSpilled) {
+    TempDirectory spill("columnar_buffers");
+    TempDirectory snapshots("columnar_buffers");
+    const auto readings = make_readings(4 * kChunkRows);
+    std::vector<std::filesystem::path> paths;
+    for (size_t chunk = 0; chunk < 4; ++chunk) {
+        paths.push_back(snapshots.path() / ("chunk" + std::to_string(chunk) + ".colsnap"));
+        ASSERT_TRUE(write_snapshot(readings.slice(chunk * kChunkRows, kChunkRows)->to_columnar(), paths.back()));
+    }
+
+    BufferManager manager(kChunkBytes, spill.path());
+    auto table = ManagedTable<int64_t, double>::try_from_snapshots(manager, paths);
+    ASSERT_TRUE(table.has_value());
+    EXPECT_EQ(table->num_rows(), 4 * kChunkRows);
+    EXPECT_EQ(manager.resident_bytes(), 0u);
+
+    int64_t max_id = -1;
+    for (int pass = 0; pass < 2; ++pass) {
+        ASSERT_TRUE(table->scan([&](const ReadingTable& chunk, size_t) {
+            for (int64_t id : chunk.get_column_view<0>()) {
+                max_id = std::max(max_id, id);
+            }
+        }).has_value());
+    }
+    EXPECT_EQ(max_id, static_cast<int64_t>(4 * kChunkRows - 1));
+    EXPECT_EQ(manager.loads(), 8u);
+    EXPECT_TRUE(std::filesystem::is_empty(spill.path()));
+
+    std::filesystem::remove(paths[2]);
+    auto missing = ManagedTable<int64_t, double>::try_from_snapshots(manager, paths);
+    EXPECT_FALSE(missing.has_value());
+}
+
+TEST(BufferManagerTest, SpillFilesRemovedWithTable) {
+    TempDirectory spill("columnar_buffers");
+    BufferManager manager(kChunkBytes, spill.path());
+    {
+        auto table = ManagedTable<int64_t, double>::from_table(manager, make_readings(5 * kChunkRows), kChunkRows);
+        EXPECT_FALSE(std::filesystem::is_empty(spill.path()));
+    }
+    EXPECT_TRUE(std::filesystem::is_empty(spill.path()));
+    EXPECT_EQ(manager.resident_bytes(), 0u);
+}
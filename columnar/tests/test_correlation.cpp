@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include "columnar/correlation.h"
+
+#include <random>
+
+using namespace columnar;
+
+namespace {
+
+using ParticleTable = Columnar<double, double, float, int64_t, std::string>;
+
+ParticleTable make_particles(size_t rows) {
+    ParticleTable table({"px", "py", "pz", "energy", "name"});
+    std::mt19937_64 rng(5);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    for (size_t i = 0; i < rows; ++i) {
+        const double px = noise(rng);
+        // A large offset that a sum-of-products formula would lose.
+        const double py = 1e8 + 0.5 * px + noise(rng);
+        table.append_row(px, py, static_cast<float>(-2.0 * px), static_cast<int64_t>(i % 100), "p");
+    }
+    return table;
+}
+
+// Two-pass covariance over `rows`.
+std::vector<double> reference_covariance(const std::vector<std::vector<double>>& columns,
+                                         const std::vector<size_t>& rows) {
+    const size_t k = columns.size();
+    std::vector<double> means(k, 0.0);
+    for (size_t c = 0; c < k; ++c) {
+        for (size_t row : rows) {
+            means[c] += columns[c][row];
+        }
+        means[c] /= static_cast<double>(rows.size());
+    }
+    std::vector<double> result(k * k, 0.0);
+    for (size_t i = 0; i < k; ++i) {
+        for (size_t j = 0; j < k; ++j) {
+            for (size_t row : rows) {
+                result[i * k + j] += (columns[i][row] - means[i]) * (columns[j][row] - means[j]);
+            }
+            result[i * k + j] /= static_cast<double>(rows.size() - 1);
+        }
+    }
+    return result;
+}
+
+}
+
+TEST(CorrelationTest, MatchesTwoPassReference) {
+    const auto table = make_particles(10007);
+    const std::vector<std::string> names{"px", "py", "pz", "energy"};
+    std::vector<std::vector<double>> columns(names.size());
+    for (size_t row = 0; row < table.num_rows(); ++row) {
+        columns[0].push_back(table.get_column_view<0>()[row]);
+        columns[1].push_back(table.get_column_view<1>()[row]);
+        columns[2].push_back(static_cast<double>(table.get_column_view<2>()[row]));
+        columns[3].push_back(static_cast<double>(table.get_column_view<3>()[row]));
+    }
+
+    SelectionBitmap selection(table.num_rows());
+    std::vector<size_t> all_rows;
+    std::vector<size_t> selected_rows;
+    for (size_t row = 0; row < table.num_rows(); ++row) {
+        all_rows.push_back(row);
+        if (row % 3 != 0) {
+            selection.set(row);
+            selected_rows.push_back(row);
+        }
+    }
+
+    ThreadPool pool(3);
+    for (const SelectionBitmap* filter : std::vector<const SelectionBitmap*>{nullptr, &selection}) {
+        const auto& rows = filter == nullptr ? all_rows : selected_rows;
+        const auto expected = reference_covariance(columns, rows);
+        for (ThreadPool* threads : {static_cast<ThreadPool*>(nullptr), &pool}) {
+            auto result = covariance_matrix(table, names, threads, filter);
+            ASSERT_TRUE(result.has_value());
+            EXPECT_EQ(result->count, rows.size());
+            EXPECT_NEAR(result->means[1], 1e8, 1.0);
+            for (size_t i = 0; i < expected.size(); ++i) {
+                EXPECT_NEAR(result->covariance[i], expected[i], 1e-7 * std::max(1.0, std::abs(expected[i]))) << i;
+            }
+            EXPECT_DOUBLE_EQ(result->correlation_at(2, 2), 1.0);
+            EXPECT_NEAR(result->correlation_at(0, 2), -1.0, 1e-6);
+            EXPECT_NEAR(result->correlation_at(0, 1), result->correlation_at(1, 0), 1e-15);
+            EXPECT_GT(result->correlation_at(0, 1), 0.3);
+        }
+    }
+}
+
+TEST(CorrelationTest, HandlesDegenerateInput) {
+    ParticleTable table({"px", "py", "pz", "energy", "name"});
+    const std::vector<std::string> names{"px", "energy"};
+
+    auto empty = covariance_matrix(table, names);
+    ASSERT_TRUE(empty.has_value());
+    EXPECT_EQ(empty->count, 0u);
+    EXPECT_TRUE(std::isnan(empty->covariance_at(0, 0)));
+
+    table.append_row(1.0, 2.0, 3.0f, 7, "a");
+    table.append_row(2.0, 2.0, 3.0f, 7, "b");
+    auto constant = covariance_matrix(table, names);
+    ASSERT_TRUE(constant.has_value());
+    EXPECT_DOUBLE_EQ(constant->covariance_at(0, 0), 0.5);
+    EXPECT_DOUBLE_EQ(constant->covariance_at(1, 1), 0.0);
+    EXPECT_TRUE(std::isnan(constant->correlation_at(0, 1)));
+
+    const std::vector<std::string> missing{"px", "mass"};
+    EXPECT_EQ(covariance_matrix(table, missing).error(), CsvError::ColumnNotFound);
+    const std::vector<std::string> strings{"px", "name"};
+    EXPECT_EQ(covariance_matrix(table, strings).error(), CsvError::ParseError);
+    SelectionBitmap wrong_size(5, true);
+    EXPECT_EQ(covariance_matrix(table, names, nullptr, &wrong_size).error(), CsvError::InvalidFormat);
+}
@@ -3,6 +3,9 @@
 
 using namespace columnar;
 
+// Every member of an explicitly instantiated schema has to compile.
+COLUMNAR_INSTANTIATE_SCHEMA(int64_t, double, float, std::string);
+
 class CsvReadingTest : public ::testing::Test {
 protected:
     void SetUp() override {
@@ -123,4 +126,43 @@ TEST(EmptyCsvNoHeaderTest, CompletelyEmptyFile) {
 
     ASSERT_FALSE(result.has_value());
     EXPECT_EQ(result.error(), CsvError::InvalidFormat);
-}
\ No newline at end of file
+}
+
+TEST(CsvRowParsingTest, AppendCsvRowIsAllOrNothing) {
+    Columnar<int, double> df({"id", "value"});
+
+    EXPECT_TRUE(df.try_append_csv_row("1,2.5"));
+    EXPECT_FALSE(df.try_append_csv_row("2,abc"));
+    EXPECT_FALSE(df.try_append_csv_row("3,4.5,6"));
+    EXPECT_FALSE(df.try_append_csv_row("4"));
+
+    ASSERT_EQ(df.num_rows(), 1u);
+    EXPECT_EQ(df.get_column_view<0>().size(), 1u);
+    EXPECT_EQ(df.get_column_view<1>().size(), 1u);
+}
+
+TEST(CsvRowParsingTest, ParseHeaderRejectsWrongColumnCount) {
+    EXPECT_TRUE((Columnar<int, int>::try_parse_csv_header("id,value").has_value()));
+    EXPECT_FALSE((Columnar<int, int>::try_parse_csv_header("id").has_value()));
+    EXPECT_FALSE((Columnar<int, int>::try_parse_csv_header("id,value,extra").has_value()));
+}
+
+TEST(CsvRowParsingTest, FieldKernelsAreSharedAcrossSchemas) {
+    std::vector<int> ints;
+    size_t pos = 0;
+    EXPECT_TRUE(detail::append_csv_field(ints, "12,x", pos, ','));
+    EXPECT_EQ(pos, 3u);
+    EXPECT_FALSE(detail::append_csv_field(ints, "12,x", pos, ','));
+    ASSERT_EQ(ints.size(), 1u);
+    EXPECT_EQ(ints[0], 12);
+
+    EXPECT_FALSE(detail::parse_field<float>("1.5e").has_value());
+    EXPECT_EQ(*detail::parse_field<std::string>("mu"), "mu");
+
+    Columnar<int64_t, double, float, std::string> df({"id", "px", "py", "label"});
+    EXPECT_TRUE(df.try_append_csv_row("1,2.5,3.5,muon  "));
+    EXPECT_FALSE(df.try_append_csv_row("2,2.5,3.5,muon,extra"));
+    ASSERT_EQ(df.num_rows(), 1u);
+    EXPECT_EQ(df.get_column_view<3>()[0], "muon  ");
+    EXPECT_EQ(df.get_column_view<3>().size(), 1u);
+}
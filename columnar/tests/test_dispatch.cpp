@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include "columnar/query.h"
+#include "simd_test_util.h"
+
+#include <random>
+
+using namespace columnar;
+
+TEST(SimdDispatchTest, ResolvesRequestedLevel) {
+    EXPECT_EQ(parse_simd_level("avx2"), SimdLevel::Avx2);
+    EXPECT_EQ(parse_simd_level("scalar"), SimdLevel::Scalar);
+    EXPECT_FALSE(parse_simd_level("sse9").has_value());
+    EXPECT_EQ(simd_level_name(SimdLevel::Avx512), "avx512");
+
+    EXPECT_EQ(detail::resolve_simd_level(SimdLevel::Avx512, nullptr), SimdLevel::Avx512);
+    EXPECT_EQ(detail::resolve_simd_level(SimdLevel::Avx512, "scalar"), SimdLevel::Scalar);
+    // Never above what the CPU supports, and unknown names are ignored.
+    EXPECT_EQ(detail::resolve_simd_level(SimdLevel::Avx2, "avx512"), SimdLevel::Avx2);
+    EXPECT_EQ(detail::resolve_simd_level(SimdLevel::Avx2, "fast"), SimdLevel::Avx2);
+
+    SimdLevelGuard guard;
+    EXPECT_EQ(set_simd_level(SimdLevel::Scalar), SimdLevel::Scalar);
+    EXPECT_EQ(simd_level(), SimdLevel::Scalar);
+    EXPECT_EQ(set_simd_level(SimdLevel::Avx512), supported_simd_level());
+}
+
+TEST(SimdDispatchTest, EveryLevelMatchesScalar) {
+    SimdLevelGuard guard;
+
+    std::mt19937_64 rng(17);
+    Columnar<double, int, int64_t, float> table({"px", "charge", "id", "eta"});
+    for (size_t i = 0; i < 1003; ++i) {
+        table.append_row(static_cast<double>(rng() % 1000) / 10.0, static_cast<int>(rng() % 3) - 1,
+                         static_cast<int64_t>(i), static_cast<float>(rng() % 100) / 20.0f);
+    }
+    std::vector<size_t> indices(517);
+    for (auto& index : indices) {
+        index = rng() % table.num_rows();
+    }
+    const std::vector<Comparison> where{{"px", CompareOp::Less, 60.0},
+                                        {"charge", CompareOp::NotEqual, int64_t{0}},
+                                        {"eta", CompareOp::GreaterEqual, 1.5}};
+    std::string haystack(300, 'x');
+    haystack.replace(211, 5, "mu+mu");
+
+    set_simd_level(SimdLevel::Scalar);
+    const auto expected_rows = select_rows(table, where)->to_indices();
+    const auto expected_px = gather(table.get_column_view<0>(), std::span<const size_t>(indices));
+    const auto expected_id = gather(table.get_column_view<2>(), std::span<const size_t>(indices));
+    const auto expected_charge = gather(table.get_column_view<1>(), std::span<const size_t>(indices));
+    ASSERT_FALSE(expected_rows.empty());
+
+    for (SimdLevel level : available_levels()) {
+        SCOPED_TRACE(std::string(simd_level_name(level)));
+        ASSERT_EQ(set_simd_level(level), level);
+        EXPECT_EQ(select_rows(table, where)->to_indices(), expected_rows);
+        EXPECT_EQ(gather(table.get_column_view<0>(), std::span<const size_t>(indices)), expected_px);
+        EXPECT_EQ(gather(table.get_column_view<2>(), std::span<const size_t>(indices)), expected_id);
+        EXPECT_EQ(gather(table.get_column_view<1>(), std::span<const size_t>(indices)), expected_charge);
+        for (size_t from : {0u, 100u, 211u, 212u}) {
+            EXPECT_EQ(detail::find_bytes(haystack, "mu+mu", from), haystack.find("mu+mu", from));
+        }
+        EXPECT_EQ(detail::find_bytes(haystack, "xmu+"), 210u);
+    }
+}
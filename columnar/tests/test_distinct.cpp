@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include "columnar/distinct.h"
+
+#include <cmath>
+#include <map>
+#include <random>
+
+using namespace columnar;
+
+namespace {
+
+using EventTable = Columnar<int64_t, std::string, double, int>;
+
+EventTable make_events(size_t rows) {
+    EventTable table({"id", "detector", "energy", "run"});
+    std::mt19937_64 rng(21);
+    for (size_t i = 0; i < rows; ++i) {
+        table.append_row(static_cast<int64_t>(rng() % 5000), "DET-" + std::to_string(rng() % 37),
+                         static_cast<double>(rng() % 200) / 4.0, static_cast<int>(i / 1000));
+    }
+    return table;
+}
+
+}
+
+TEST(DistinctTest, MatchesOrderedMap) {
+    const auto table = make_events(200000);
+    const auto ids = table.get_column_view<0>();
+    std::map<int64_t, uint64_t> expected;
+    std::vector<int64_t> first_seen;
+    for (int64_t id : ids) {
+        if (expected[id]++ == 0) {
+            first_seen.push_back(id);
+        }
+    }
+
+    ThreadPool pool(4);
+    for (ThreadPool* threads : {static_cast<ThreadPool*>(nullptr), &pool}) {
+        EXPECT_EQ(unique(ids, threads), first_seen);
+
+        const auto counted = value_counts(ids, threads);
+        ASSERT_EQ(counted.values.size(), expected.size());
+        for (size_t i = 0; i < counted.values.size(); ++i) {
+            EXPECT_EQ(counted.counts[i], expected[counted.values[i]]);
+            if (i > 0) {
+                EXPECT_GE(counted.counts[i - 1], counted.counts[i]);
+            }
+        }
+    }
+
+    // The run column is sorted and takes the run-length path.
+    const auto runs = unique(table.get_column_view<3>(), &pool);
+    ASSERT_EQ(runs.size(), 200u);
+    EXPECT_EQ(runs.front(), 0);
+    EXPECT_EQ(runs.back(), 199);
+    EXPECT_EQ(value_counts(table.get_column_view<3>()).counts, std::vector<uint64_t>(200, 1000));
+}
+
+TEST(DistinctTest, FoldsZerosAndNaNs) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const std::vector<double> values{1.0, nan, -0.0, 0.0, -nan, 1.0, 2.0};
+    const auto distinct = unique(std::span<const double>(values));
+    ASSERT_EQ(distinct.size(), 4u);
+    EXPECT_EQ(distinct[0], 1.0);
+    EXPECT_TRUE(std::isnan(distinct[1]));
+    EXPECT_EQ(distinct[2], 0.0);
+
+    const std::vector<double> sorted{-1.0, 0.0, 0.0, nan, nan};
+    const auto counted = value_counts(std::span<const double>(sorted));
+    EXPECT_EQ(counted.counts, (std::vector<uint64_t>{2, 2, 1}));
+    EXPECT_EQ(counted.values[0], 0.0);
+    EXPECT_TRUE(std::isnan(counted.values[1]));
+}
+
+TEST(DistinctTest, WorksOnNamedColumns) {
+    const auto table = make_events(5000);
+    ThreadPool pool(2);
+
+    auto detectors = unique(table, "detector", &pool);
+    ASSERT_TRUE(detectors.has_value());
+    EXPECT_EQ(detectors->name, "detector");
+    EXPECT_EQ(std::get<std::vector<std::string>>(detectors->values).size(), 37u);
+
+    auto counts = value_counts(table, "run");
+    ASSERT_TRUE(counts.has_value());
+    ASSERT_EQ(counts->size(), 2u);
+    EXPECT_EQ(std::get<std::vector<int64_t>>((*counts)[0].values), (std::vector<int64_t>{0, 1, 2, 3, 4}));
+    EXPECT_EQ((*counts)[1].name, "count");
+    EXPECT_EQ(std::get<std::vector<int64_t>>((*counts)[1].values), std::vector<int64_t>(5, 1000));
+
+    EXPECT_EQ(unique(table, "missing").error(), CsvError::ColumnNotFound);
+    EXPECT_EQ(value_counts(table, "missing").error(), CsvError::ColumnNotFound);
+}
+
+TEST(DropDuplicatesTest, KeepsFirstOrLastOfEachKey) {
+    // Every event id appears once per detector readout; some readouts repeat.
+    Columnar<int64_t, std::string, double> events({"event", "detector", "energy"});
+    std::map<std::pair<int64_t, std::string>, std::pair<size_t, size_t>> expected;
+    std::mt19937_64 rng(8);
+    for (size_t row = 0; row < 150000; ++row) {
+        const auto event = static_cast<int64_t>(rng() % 40000);
+        const std::string detector = rng() % 2 == 0 ? "ECAL" : "HCAL";
+        events.append_row(event, detector, static_cast<double>(row));
+        auto [it, inserted] = expected.try_emplace({event, detector}, row, row);
+        it->second.second = row;
+    }
+    const std::vector<std::string> keys{"event", "detector"};
+
+    ThreadPool pool(4);
+    for (ThreadPool* threads : {static_cast<ThreadPool*>(nullptr), &pool}) {
+        for (DuplicateKeep keep : {DuplicateKeep::First, DuplicateKeep::Last}) {
+            auto selection = select_unique_rows(events, keys, keep, threads);
+            ASSERT_TRUE(selection.has_value());
+            std::vector<size_t> kept;
+            for (const auto& [key, rows] : expected) {
+                kept.push_back(keep == DuplicateKeep::First ? rows.first : rows.second);
+            }
+            std::sort(kept.begin(), kept.end());
+            EXPECT_EQ(selection->to_indices(), kept);
+            if (threads == nullptr) {
+                continue;
+            }
+
+            auto compact = drop_duplicates(events, keys, keep, threads);
+            ASSERT_TRUE(compact.has_value());
+            ASSERT_EQ(compact->num_rows(), kept.size());
+            // Row order is preserved; the energy column holds the source row.
+            const auto energy = compact->get_column_view<2>();
+            for (size_t i = 0; i < kept.size(); i += 97) {
+                EXPECT_EQ(energy[i], static_cast<double>(kept[i]));
+            }
+        }
+    }
+}
+
+TEST(DropDuplicatesTest, DefaultsToAllColumns) {
+    Columnar<int, double, std::string> table({"a", "b", "c"});
+    table.append_row(1, 0.0, "x");
+    table.append_row(1, -0.0, "x");
+    table.append_row(1, 0.0, "y");
+    table.append_row(2, 0.0, "x");
+    table.append_row(2, 0.0, "x");
+
+    auto all = drop_duplicates(table, {});
+    ASSERT_TRUE(all.has_value());
+    EXPECT_EQ(all->num_rows(), 3u);
+
+    const std::vector<std::string> by_a{"a"};
+    auto last = select_unique_rows(table, by_a, DuplicateKeep::Last);
+    ASSERT_TRUE(last.has_value());
+    EXPECT_EQ(last->to_indices(), (std::vector<size_t>{2, 4}));
+
+    const std::vector<std::string> missing{"a", "z"};
+    EXPECT_EQ(drop_duplicates(table, missing).error(), CsvError::ColumnNotFound);
+}
@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include "columnar/distributed.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <thread>
+
+using namespace columnar;
+
+namespace {
+
+using ParticleTable = Columnar<int, double, double, double, double>;
+using LabelTable = Columnar<std::string, int>;
+
+// Worker servers on localhost sockets, each serving from its own thread.
+class LocalWorkers {
+public:
+    explicit LocalWorkers(size_t count) : servers_(count) {
+        for (size_t i = 0; i < count; ++i) {
+            servers_[i].accept_tables<int, double, double, double, double>();
+            servers_[i].accept_tables<std::string, int>();
+            paths_.push_back(std::filesystem::temp_directory_path() /
+                             ("columnar_worker_" + std::to_string(::getpid()) + "_" + std::to_string(i) + ".sock"));
+            EXPECT_TRUE(servers_[i].listen(paths_[i]).has_value());
+            threads_.emplace_back([this, i] { servers_[i].serve(); });
+        }
+    }
+
+    ~LocalWorkers() {
+        for (auto& server : servers_) {
+            server.stop();
+        }
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+    }
+
+    [[nodiscard]] std::span<const std::filesystem::path> paths() const { return paths_; }
+    [[nodiscard]] QueryServer& server(size_t i) { return servers_[i]; }
+
+private:
+    std::vector<QueryServer> servers_;
+    std::vector<std::filesystem::path> paths_;
+    std::vector<std::thread> threads_;
+};
+
+ParticleTable make_particles(int rows) {
+    ParticleTable table({"particle_id", "px", "py", "pz", "energy"});
+    for (int i = 0; i < rows; ++i) {
+        table.append_row(i, 0.5 * i, -0.25 * i, static_cast<double>(i % 7), 1.0 + i % 13);
+    }
+    return table;
+}
+
+}
+
+TEST(DistributedTest, RangePartitionedQueryMatchesLocal) {
+    LocalWorkers workers(3);
+    auto coordinator = Coordinator::try_connect(workers.paths());
+    ASSERT_TRUE(coordinator.has_value());
+
+    const auto table = make_particles(1000);
+    auto distributed = coordinator->distribute("particles", table);
+    ASSERT_TRUE(distributed.has_value());
+    EXPECT_EQ(*distributed, 1000u);
+
+    QueryRequest request{"particles",
+                         {{"energy", CompareOp::Greater, 6.0}, {"pz", CompareOp::LessEqual, int64_t{3}}},
+                         {"particle_id", "px"},
+                         {{AggregateOp::Count, ""},
+                          {AggregateOp::Sum, "px"},
+                          {AggregateOp::Min, "py"},
+                          {AggregateOp::Max, "energy"},
+                          {AggregateOp::Mean, "px"}}};
+    auto remote = coordinator->execute(request);
+    auto local = execute_query(table, request);
+    ASSERT_TRUE(remote.has_value());
+    ASSERT_TRUE(local.has_value());
+
+    EXPECT_EQ(remote->matched_rows, local->matched_rows);
+    EXPECT_EQ(std::get<std::vector<int64_t>>(remote->columns[0].values),
+              std::get<std::vector<int64_t>>(local->columns[0].values));
+    ASSERT_EQ(remote->aggregates.size(), local->aggregates.size());
+    for (size_t i = 0; i < local->aggregates.size(); ++i) {
+        EXPECT_DOUBLE_EQ(remote->aggregates[i], local->aggregates[i]) << "aggregate " << i;
+    }
+
+    request.limit = 10;
+    auto limited = coordinator->execute(request);
+    ASSERT_TRUE(limited.has_value());
+    EXPECT_EQ(std::get<std::vector<int64_t>>(limited->columns[0].values).size(), 10u);
+    EXPECT_EQ(limited->matched_rows, local->matched_rows);
+}
+
+TEST(DistributedTest, HashPartitioningCoLocatesKeys) {
+    LocalWorkers workers(4);
+    auto coordinator = Coordinator::try_connect(workers.paths());
+    ASSERT_TRUE(coordinator.has_value());
+
+    LabelTable table({"label", "value"});
+    const std::vector<std::string> labels{"electron", "muon", "photon", "pion", "kaon", "proton"};
+    for (int i = 0; i < 600; ++i) {
+        table.append_row(labels[i % labels.size()], i);
+    }
+    ASSERT_TRUE(coordinator->distribute("labels", table, Partitioning::Hash, "label").has_value());
+
+    // Every row of a label is on exactly one worker.
+    for (const auto& label : labels) {
+        QueryRequest request{"labels", {{"label", CompareOp::Equal, label}}, {}, {{AggregateOp::Count, ""}}};
+        size_t workers_with_rows = 0;
+        for (size_t w = 0; w < 4; ++w) {
+            auto partial = workers.server(w).execute(request);
+            ASSERT_TRUE(partial.has_value());
+            workers_with_rows += partial->matched_rows != 0;
+        }
+        EXPECT_EQ(workers_with_rows, 1u) << label;
+
+        auto merged = coordinator->execute(request);
+        ASSERT_TRUE(merged.has_value());
+        EXPECT_EQ(merged->matched_rows, 100u);
+    }
+
+    EXPECT_EQ(coordinator->distribute("labels", table, Partitioning::Hash, "missing").error(),
+              CsvError::ColumnNotFound);
+}
+
+TEST(DistributedTest, ErrorsPropagateFromWorkers) {
+    LocalWorkers workers(2);
+    auto coordinator = Coordinator::try_connect(workers.paths());
+    ASSERT_TRUE(coordinator.has_value());
+    ASSERT_TRUE(coordinator->distribute("particles", make_particles(10)).has_value());
+
+    auto unknown_column = coordinator->execute({"particles", {{"mass", CompareOp::Less, 1.0}}, {}, {}});
+    ASSERT_FALSE(unknown_column.has_value());
+    EXPECT_EQ(unknown_column.error(), CsvError::ColumnNotFound);
+
+    // The connections stay usable after an error.
+    auto count = coordinator->execute({"particles", {}, {}, {{AggregateOp::Count, ""}}});
+    ASSERT_TRUE(count.has_value());
+    EXPECT_DOUBLE_EQ(count->aggregates[0], 10.0);
+
+    // Schemas a worker does not accept are rejected.
+    Columnar<float> unsupported({"x"});
+    unsupported.append_row(1.0f);
+    EXPECT_EQ(coordinator->distribute("floats", unsupported).error(), CsvError::InvalidFormat);
+}
+
+#endif
@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+#include "columnar/external.h"
+#include "columnar/csv_reader.h"
+#include "temp_dir_util.h"
+
+#include <map>
+#include <random>
+
+using namespace columnar;
+
+namespace {
+
+using EventTable = Columnar<int64_t, double, std::string>;
+
+EventTable make_batch(std::mt19937_64& rng, size_t rows, int64_t first_id) {
+    EventTable batch({"id", "energy", "label"});
+    std::uniform_int_distribution<int> energy(0, 999);
+    std::uniform_int_distribution<int> label(0, 49);
+    for (size_t i = 0; i < rows; ++i) {
+        batch.append_row(first_id + static_cast<int64_t>(i), energy(rng) / 10.0, "label" + std::to_string(label(rng)));
+    }
+    return batch;
+}
+
+SpillOptions small_budget(const TempDirectory& dir) {
+    SpillOptions options;
+    options.memory_budget_bytes = 64 << 10;
+    options.spill_dir = dir.path();
+    options.block_rows = 500;
+    return options;
+}
+
+}
+
+TEST(ExternalSortTest, SpilledSortMatchesStableSort) {
+    TempDirectory dir("columnar_spill_test");
+    std::mt19937_64 rng(7);
+    ExternalSorter<int64_t, double, std::string> sorter("energy", SortOrder::Ascending, small_budget(dir));
+
+    EventTable all({"id", "energy", "label"});
+    for (int b = 0; b < 20; ++b) {
+        auto batch = make_batch(rng, 1000, b * 1000);
+        all.append(batch);
+        ASSERT_TRUE(sorter.add(batch).has_value());
+    }
+    EXPECT_GT(sorter.run_count(), 4u);
+
+    EventTable sorted({"id", "energy", "label"});
+    size_t max_batch = 0;
+    auto rows = sorter.finish([&](const EventTable& batch) {
+        max_batch = std::max(max_batch, batch.num_rows());
+        sorted.append(batch);
+    });
+    ASSERT_TRUE(rows.has_value());
+    EXPECT_EQ(*rows, 20000u);
+    EXPECT_LE(max_batch, 500u);
+
+    auto energy = all.get_column_view<1>();
+    std::vector<size_t> expected(all.num_rows());
+    std::iota(expected.begin(), expected.end(), size_t{0});
+    std::stable_sort(expected.begin(), expected.end(), [&](size_t a, size_t b) { return energy[a] < energy[b]; });
+
+    ASSERT_EQ(sorted.num_rows(), expected.size());
+    auto ids = sorted.get_column_view<0>();
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_EQ(ids[i], all.get_column_view<0>()[expected[i]]) << "row " << i;
+    }
+    EXPECT_TRUE(dir.empty());
+}
+
+TEST(ExternalSortTest, DescendingStringKeysInMemory) {
+    TempDirectory dir("columnar_spill_test");
+    ExternalSorter<std::string, int> sorter("name", SortOrder::Descending, SpillOptions{1 << 20, dir.path(), 2});
+
+    Columnar<std::string, int> batch({"name", "value"});
+    batch.append_row("b", 1);
+    batch.append_row("c", 2);
+    batch.append_row("a", 3);
+    batch.append_row("c", 4);
+    ASSERT_TRUE(sorter.add(batch).has_value());
+    EXPECT_EQ(sorter.run_count(), 0u);
+
+    std::vector<int> values;
+    ASSERT_TRUE(sorter.finish([&](const Columnar<std::string, int>& out) {
+        for (int v : out.get_column_view<1>()) values.push_back(v);
+    }).has_value());
+    EXPECT_EQ(values, (std::vector<int>{2, 4, 1, 3}));
+
+    EXPECT_EQ(sorter.add(Columnar<std::string, int>({"other", "value"})).error(), CsvError::ColumnNotFound);
+}
+
+TEST(ExternalGroupByTest, SpilledAggregationMatchesInMemory) {
+    TempDirectory dir("columnar_spill_test");
+    std::mt19937_64 rng(11);
+    auto options = small_budget(dir);
+    options.memory_budget_bytes = 16 << 10;
+    ExternalGroupBy<int64_t, double, std::string> group_by(
+        "id", {{AggregateOp::Count, ""}, {AggregateOp::Sum, "energy"}, {AggregateOp::Max, "energy"}}, options);
+
+    // Ids repeat across batches, so groups are spilled and merged back.
+    std::map<int64_t, std::pair<double, double>> expected;
+    for (int b = 0; b < 10; ++b) {
+        auto batch = make_batch(rng, 2000, 0);
+        for (size_t r = 0; r < batch.num_rows(); ++r) {
+            auto& [sum, max] = expected.try_emplace(batch.get_column_view<0>()[r], 0.0, -1.0).first->second;
+            sum += batch.get_column_view<1>()[r];
+            max = std::max(max, batch.get_column_view<1>()[r]);
+        }
+        ASSERT_TRUE(group_by.add(batch).has_value());
+    }
+    EXPECT_GT(group_by.spill_count(), 0u);
+
+    size_t seen = 0;
+    auto groups = group_by.finish([&](const std::vector<ResultColumn>& columns) {
+        ASSERT_EQ(columns.size(), 4u);
+        EXPECT_EQ(columns[2].name, "sum(energy)");
+        const auto& keys = std::get<std::vector<int64_t>>(columns[0].values);
+        const auto& counts = std::get<std::vector<double>>(columns[1].values);
+        const auto& sums = std::get<std::vector<double>>(columns[2].values);
+        const auto& maxes = std::get<std::vector<double>>(columns[3].values);
+        for (size_t g = 0; g < keys.size(); ++g) {
+            ASSERT_TRUE(expected.contains(keys[g]));
+            EXPECT_DOUBLE_EQ(counts[g], 10.0);
+            EXPECT_NEAR(sums[g], expected[keys[g]].first, 1e-9);
+            EXPECT_DOUBLE_EQ(maxes[g], expected[keys[g]].second);
+        }
+        seen += keys.size();
+    });
+    ASSERT_TRUE(groups.has_value());
+    EXPECT_EQ(*groups, expected.size());
+    EXPECT_EQ(seen, expected.size());
+    EXPECT_TRUE(dir.empty());
+}
+
+TEST(ExternalGroupByTest, GroupsCsvBatches) {
+    TempDirectory dir("columnar_spill_test");
+    auto reader = CsvBatchReader<int, double, float>::try_open("data/mixed_types.csv");
+    ASSERT_TRUE(reader.has_value());
+
+    ExternalGroupBy<int, double, float> group_by("int_col", {{AggregateOp::Mean, "double_col"}},
+                                                 SpillOptions{1 << 20, dir.path(), 16});
+    while (!reader->done()) {
+        auto batch = reader->next_batch(2);
+        ASSERT_TRUE(batch.has_value());
+        ASSERT_TRUE(group_by.add(*batch).has_value());
+    }
+
+    auto table = Columnar<int, double, float>::try_read_from_csv("data/mixed_types.csv");
+    ASSERT_TRUE(table.has_value());
+    std::map<int64_t, std::vector<double>> expected;
+    for (size_t r = 0; r < table->num_rows(); ++r) {
+        expected[table->get_column_view<0>()[r]].push_back(table->get_column_view<1>()[r]);
+    }
+
+    size_t groups = 0;
+    ASSERT_TRUE(group_by.finish([&](const std::vector<ResultColumn>& columns) {
+        const auto& keys = std::get<std::vector<int64_t>>(columns[0].values);
+        const auto& means = std::get<std::vector<double>>(columns[1].values);
+        for (size_t g = 0; g < keys.size(); ++g) {
+            const auto& values = expected[keys[g]];
+            EXPECT_DOUBLE_EQ(means[g], std::accumulate(values.begin(), values.end(), 0.0) / values.size());
+        }
+        groups += keys.size();
+    }).has_value());
+    EXPECT_EQ(groups, expected.size());
+}
+
+TEST(ExternalGroupByTest, RejectsStringAggregates) {
+    ExternalGroupBy<std::string, int> group_by("count", {{AggregateOp::Sum, "name"}});
+    Columnar<std::string, int> batch({"name", "count"});
+    EXPECT_EQ(group_by.add(batch).error(), CsvError::ParseError);
+
+    ExternalGroupBy<std::string, int> missing("name", {{AggregateOp::Sum, "weight"}});
+    EXPECT_EQ(missing.add(batch).error(), CsvError::ColumnNotFound);
+}
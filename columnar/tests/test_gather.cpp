@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+#include "columnar/columnar.h"
+
+#include <numeric>
+#include <random>
+
+using namespace columnar;
+
+namespace {
+
+std::vector<size_t> random_indices(size_t count, size_t bound, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<size_t> dist(0, bound - 1);
+    std::vector<size_t> indices(count);
+    for (auto& index : indices) {
+        index = dist(rng);
+    }
+    return indices;
+}
+
+template <typename T>
+void expect_gather_matches_scalar() {
+    std::vector<T> src(1000);
+    std::iota(src.begin(), src.end(), T{1});
+    auto indices = random_indices(777, src.size(), 42);
+
+    auto result = gather(std::span<const T>{src}, std::span<const size_t>{indices});
+    ASSERT_EQ(result.size(), indices.size());
+    for (size_t i = 0; i < indices.size(); ++i) {
+        EXPECT_EQ(result[i], src[indices[i]]) << "i = " << i;
+    }
+}
+
+}
+
+TEST(GatherTest, ArithmeticTypes) {
+    expect_gather_matches_scalar<int>();
+    expect_gather_matches_scalar<int64_t>();
+    expect_gather_matches_scalar<float>();
+    expect_gather_matches_scalar<double>();
+    expect_gather_matches_scalar<int16_t>();
+}
+
+TEST(GatherTest, Strings) {
+    std::vector<std::string> src{"alpha", "beta", "a string long enough to live on the heap", "delta"};
+    std::vector<size_t> indices{3, 2, 2, 0};
+
+    std::vector<std::string> dst{"stale"};
+    gather_into(std::span<const std::string>{src}, std::span<const size_t>{indices}, dst);
+
+    ASSERT_EQ(dst.size(), 4u);
+    EXPECT_EQ(dst[0], "delta");
+    EXPECT_EQ(dst[1], src[2]);
+    EXPECT_EQ(dst[3], "alpha");
+}
+
+TEST(GatherTest, ScatterInvertsGather) {
+    std::vector<double> src{1.5, 2.5, 3.5, 4.5, 5.5};
+    std::vector<size_t> permutation{4, 0, 3, 1, 2};
+
+    auto gathered = gather(std::span<const double>{src}, std::span<const size_t>{permutation});
+    std::vector<double> restored(src.size());
+    scatter(std::span<const double>{gathered}, std::span<const size_t>{permutation}, restored.data());
+
+    EXPECT_EQ(restored, src);
+}
+
+TEST(GatherTest, EmptyIndexList) {
+    std::vector<int> src{1, 2, 3};
+    std::vector<size_t> indices;
+    EXPECT_TRUE(gather(std::span<const int>{src}, std::span<const size_t>{indices}).empty());
+}
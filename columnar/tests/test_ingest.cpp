@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include "columnar/ingest.h"
+
+#include <numeric>
+#include <thread>
+
+using namespace columnar;
+
+TEST(IngestQueueTest, AppendRowAndAppend) {
+    Columnar<int, std::string> df({"id", "name"});
+    df.append_row(1, "a");
+    df.append_row(2, "b");
+
+    Columnar<int, std::string> other({"id", "name"});
+    other.append_row(3, "c");
+    df.append(other);
+
+    ASSERT_EQ(df.num_rows(), 3u);
+    EXPECT_EQ(df.get_column_view<0>()[2], 3);
+    EXPECT_EQ(df.get_column_view<1>()[2], "c");
+    EXPECT_EQ(df.column_names()[1], "name");
+
+    df.clear();
+    EXPECT_EQ(df.num_rows(), 0u);
+    EXPECT_TRUE(df.get_column_view<0>().empty());
+}
+
+TEST(IngestQueueTest, FlushPublishesPartialBatch) {
+    IngestQueue<int, double> queue(1, {.batch_rows = 4, .batches_per_producer = 2});
+    Columnar<int, double> target({"id", "energy"});
+
+    auto& producer = queue.producer(0);
+    ASSERT_TRUE(producer.try_push(1, 1.5));
+    ASSERT_TRUE(producer.try_push(2, 2.5));
+
+    EXPECT_EQ(queue.drain_into(target), 0u);
+
+    producer.flush();
+    EXPECT_EQ(queue.drain_into(target), 2u);
+    ASSERT_EQ(target.num_rows(), 2u);
+    EXPECT_DOUBLE_EQ(target.get_column_view<1>()[1], 2.5);
+}
+
+TEST(IngestQueueTest, BackpressureWhenRingIsFull) {
+    IngestQueue<int> queue(1, {.batch_rows = 2, .batches_per_producer = 1});
+    Columnar<int> target({"id"});
+
+    auto& producer = queue.producer(0);
+    EXPECT_TRUE(producer.try_push(1));
+    EXPECT_TRUE(producer.try_push(2));
+    EXPECT_FALSE(producer.try_push(3));
+    EXPECT_FALSE(producer.try_flush());
+
+    EXPECT_EQ(queue.drain_into(target), 2u);
+    EXPECT_TRUE(producer.try_push(3));
+    producer.flush();
+    EXPECT_EQ(queue.drain_into(target), 1u);
+
+    auto ids = target.get_column_view<0>();
+    ASSERT_EQ(ids.size(), 3u);
+    EXPECT_EQ(ids[2], 3);
+}
+
+TEST(IngestQueueTest, ConcurrentProducers) {
+    constexpr size_t kProducers = 4;
+    constexpr int kRowsPerProducer = 20000;
+
+    IngestQueue<int, int64_t> queue(kProducers, {.batch_rows = 256, .batches_per_producer = 4});
+    Columnar<int, int64_t> target({"producer", "value"});
+
+    std::atomic<size_t> finished{0};
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < kProducers; ++p) {
+        threads.emplace_back([&, p] {
+            auto& producer = queue.producer(p);
+            for (int i = 0; i < kRowsPerProducer; ++i) {
+                producer.push(static_cast<int>(p), i);
+            }
+            producer.flush();
+            finished.fetch_add(1);
+        });
+    }
+
+    while (finished.load() < kProducers) {
+        queue.drain_into(target);
+        std::this_thread::yield();
+    }
+    queue.drain_into(target);
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(target.num_rows(), kProducers * kRowsPerProducer);
+
+    auto values = target.get_column_view<1>();
+    int64_t expected = kProducers * (int64_t{kRowsPerProducer} * (kRowsPerProducer - 1) / 2);
+    EXPECT_EQ(std::accumulate(values.begin(), values.end(), int64_t{0}), expected);
+}
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include "columnar/external.h"
+#include "columnar/interning.h"
+#include "temp_dir_util.h"
+
+#include <map>
+#include <random>
+
+using namespace columnar;
+
+namespace {
+
+using OrderTable = Columnar<int64_t, std::string, double>;
+
+std::string symbol_name(size_t i) {
+    return "INSTRUMENT-" + std::to_string(i % 97) + (i % 2 == 0 ? "-LONG-SUFFIX-PAST-SSO" : "");
+}
+
+}
+
+TEST(HashTest, BytesHashCoversEveryLength) {
+    std::string text;
+    std::vector<uint64_t> seen;
+    for (size_t length = 0; length < 40; ++length) {
+        seen.push_back(hash_bytes(text));
+        EXPECT_EQ(hash_value(text), seen.back());
+        EXPECT_NE(hash_value(text, 1), seen.back());
+        text += 'x';
+    }
+    std::sort(seen.begin(), seen.end());
+    EXPECT_EQ(std::unique(seen.begin(), seen.end()), seen.end());
+    // A zero byte is not the same as a shorter string.
+    EXPECT_NE(hash_bytes(std::string_view("ab\0", 3)), hash_bytes("ab"));
+
+    const std::vector<std::string> column{"", "a", "abcdefghijk", "a"};
+    const auto hashes = hash_strings(column, 7);
+    for (size_t row = 0; row < column.size(); ++row) {
+        EXPECT_EQ(hashes[row], hash_value(column[row], 7));
+    }
+}
+
+TEST(StringInternerTest, AssignsDenseIdsAcrossTables) {
+    StringInterner interner;
+    EXPECT_FALSE(interner.find("missing").has_value());
+
+    OrderTable orders({"id", "symbol", "qty"});
+    OrderTable fills({"id", "symbol", "px"});
+    for (size_t i = 0; i < 5000; ++i) {
+        orders.append_row(static_cast<int64_t>(i), symbol_name(i), 1.0);
+        fills.append_row(static_cast<int64_t>(i), symbol_name(i * 3 + 1), 2.0);
+    }
+
+    auto order_ids = intern_column(orders, "symbol", interner);
+    auto fill_ids = intern_column(fills, "symbol", interner);
+    ASSERT_TRUE(order_ids.has_value());
+    ASSERT_TRUE(fill_ids.has_value());
+    EXPECT_EQ(interner.size(), 97u * 2);
+
+    const auto symbols = orders.get_column_view<1>();
+    const auto fill_symbols = fills.get_column_view<1>();
+    for (size_t i = 0; i < 5000; i += 7) {
+        EXPECT_EQ(interner.value((*order_ids)[i]), symbols[i]);
+        // Equal ids across both tables exactly when the strings are equal.
+        EXPECT_EQ((*order_ids)[i] == (*fill_ids)[i], symbols[i] == fill_symbols[i]);
+        EXPECT_EQ(interner.find(symbols[i]), (*order_ids)[i]);
+    }
+    EXPECT_EQ((*order_ids)[0], 0u);
+    EXPECT_LT(*std::max_element(fill_ids->begin(), fill_ids->end()), interner.size());
+
+    EXPECT_EQ(intern_column(orders, "qty", interner).error(), CsvError::ParseError);
+    EXPECT_EQ(intern_column(orders, "venue", interner).error(), CsvError::ColumnNotFound);
+}
+
+TEST(StringInternerTest, GroupsStringKeysThroughIds) {
+    TempDirectory dir("columnar_interning");
+    {
+        ExternalGroupBy<int64_t, std::string, double> group_by(
+            "symbol", {{AggregateOp::Count, ""}, {AggregateOp::Sum, "qty"}}, SpillOptions{8 << 10, dir.path(), 256});
+
+        std::map<std::string, std::pair<double, double>> expected;
+        std::mt19937_64 rng(3);
+        std::uniform_real_distribution<double> qty(0.0, 10.0);
+        for (int b = 0; b < 8; ++b) {
+            OrderTable batch({"id", "symbol", "qty"});
+            for (size_t i = 0; i < 1000; ++i) {
+                const auto name = symbol_name(i * 13 + static_cast<size_t>(b));
+                const double q = qty(rng);
+                batch.append_row(static_cast<int64_t>(i), name, q);
+                auto& [count, sum] = expected[name];
+                count += 1.0;
+                sum += q;
+            }
+            ASSERT_TRUE(group_by.add(batch).has_value());
+        }
+
+        size_t seen = 0;
+        ASSERT_TRUE(group_by.finish([&](const std::vector<ResultColumn>& columns) {
+            const auto& keys = std::get<std::vector<std::string>>(columns[0].values);
+            const auto& counts = std::get<std::vector<double>>(columns[1].values);
+            const auto& sums = std::get<std::vector<double>>(columns[2].values);
+            for (size_t g = 0; g < keys.size(); ++g) {
+                ASSERT_TRUE(expected.contains(keys[g]));
+                EXPECT_DOUBLE_EQ(counts[g], expected[keys[g]].first);
+                EXPECT_NEAR(sums[g], expected[keys[g]].second, 1e-9);
+            }
+            seen += keys.size();
+        }).has_value());
+        EXPECT_EQ(seen, expected.size());
+    }
+}
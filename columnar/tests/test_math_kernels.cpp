@@ -0,0 +1,184 @@
+#include <gtest/gtest.h>
+#include "columnar/columnar.h"
+#include "columnar/math_kernels.h"
+#include "simd_test_util.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+
+using namespace columnar;
+
+namespace {
+
+// Distance from `expected` in units of its last place; NaN must match NaN
+// and infinities must match exactly.
+double ulp_error(double actual, double expected) {
+    if (std::isnan(expected) || std::isnan(actual)) {
+        return std::isnan(expected) && std::isnan(actual) ? 0.0 : std::numeric_limits<double>::infinity();
+    }
+    if (actual == expected) {
+        return 0.0;
+    }
+    if (std::isinf(expected) || std::isinf(actual)) {
+        return std::numeric_limits<double>::infinity();
+    }
+    const double magnitude = std::fabs(expected);
+    return std::fabs(actual - expected) / (std::nextafter(magnitude, std::numeric_limits<double>::infinity()) - magnitude);
+}
+
+std::vector<double> uniform(size_t count, double low, double high, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> dist(low, high);
+    std::vector<double> values(count);
+    for (auto& value : values) {
+        value = dist(rng);
+    }
+    return values;
+}
+
+// Inputs outside every kernel's fast range, placed so that they share
+// vector groups with ordinary values.
+const std::vector<double> kSpecials{0.0,       -0.0,    1e-310,  -1e-310, 1e300,  -1e300, 750.0, -750.0,
+                                    std::numeric_limits<double>::infinity(),
+                                    -std::numeric_limits<double>::infinity(),
+                                    std::numeric_limits<double>::quiet_NaN(), -1.0, 1.0, 2.0};
+
+std::vector<double> with_specials(std::vector<double> values) {
+    for (size_t i = 0; i < kSpecials.size(); ++i) {
+        values[i * 3] = kSpecials[i];
+    }
+    return values;
+}
+
+constexpr size_t kCount = 20001;
+
+}
+
+TEST(MathKernelsTest, UnaryKernelsStayWithinUlpBound) {
+    SimdLevelGuard guard;
+    struct Case {
+        const char* name;
+        void (*kernel)(std::span<const double>, std::span<double>);
+        double (*reference)(double);
+        std::vector<double> input;
+        double bound;
+    };
+    const std::vector<Case> cases{
+        {"exp", vector_exp, [](double x) { return std::exp(x); }, with_specials(uniform(kCount, -745.0, 710.0, 1)), 1.0},
+        {"exp near 0", vector_exp, [](double x) { return std::exp(x); }, uniform(kCount, -1.0, 1.0, 2), 1.0},
+        {"log", vector_log, [](double x) { return std::log(x); },
+         with_specials([] {
+             auto exponents = uniform(kCount, -300.0, 300.0, 3);
+             for (auto& x : exponents) {
+                 x = std::pow(10.0, x);
+             }
+             return exponents;
+         }()),
+         1.0},
+        {"log near 1", vector_log, [](double x) { return std::log(x); }, uniform(kCount, 0.5, 2.0, 4), 1.0},
+        {"sqrt", vector_sqrt, [](double x) { return std::sqrt(x); }, with_specials(uniform(kCount, 0.0, 1e6, 5)), 0.0},
+    };
+
+    for (SimdLevel level : available_levels()) {
+        ASSERT_EQ(set_simd_level(level), level);
+        for (const auto& c : cases) {
+            std::vector<double> out(c.input.size());
+            c.kernel(c.input, out);
+            double worst = 0.0;
+            for (size_t i = 0; i < out.size(); ++i) {
+                worst = std::max(worst, ulp_error(out[i], c.reference(c.input[i])));
+            }
+            EXPECT_LE(worst, c.bound) << c.name << " at " << simd_level_name(level);
+        }
+    }
+}
+
+TEST(MathKernelsTest, BinaryKernelsStayWithinUlpBound) {
+    SimdLevelGuard guard;
+    const auto x = with_specials(uniform(kCount, -100.0, 100.0, 6));
+    auto y = uniform(kCount, -100.0, 100.0, 7);
+    // Every pairing of specials with each other and with ordinary values.
+    for (size_t i = 0; i < kSpecials.size(); ++i) {
+        y[i * 3] = kSpecials[(i * 5) % kSpecials.size()];
+        y[i * 3 + 1] = kSpecials[i];
+    }
+
+    for (SimdLevel level : available_levels()) {
+        ASSERT_EQ(set_simd_level(level), level);
+        std::vector<double> angles(kCount);
+        std::vector<double> lengths(kCount);
+        vector_atan2(y, x, angles);
+        vector_hypot(x, y, lengths);
+        double worst_angle = 0.0;
+        double worst_length = 0.0;
+        for (size_t i = 0; i < kCount; ++i) {
+            worst_angle = std::max(worst_angle, ulp_error(angles[i], std::atan2(y[i], x[i])));
+            worst_length = std::max(worst_length, ulp_error(lengths[i], std::hypot(x[i], y[i])));
+        }
+        EXPECT_LE(worst_angle, 2.0) << simd_level_name(level);
+        EXPECT_LE(worst_length, 1.0) << simd_level_name(level);
+        // Signed zeros pick the half-plane.
+        EXPECT_EQ(std::signbit(angles[1]), std::signbit(std::atan2(y[1], x[1])));
+    }
+}
+
+TEST(MathKernelsTest, OutputMayAliasInput) {
+    SimdLevelGuard guard;
+    const auto x = with_specials(uniform(1001, -50.0, 50.0, 8));
+    const auto y = uniform(1001, -50.0, 50.0, 9);
+    for (SimdLevel level : available_levels()) {
+        ASSERT_EQ(set_simd_level(level), level);
+        std::vector<double> expected(x.size());
+        vector_exp(x, expected);
+        auto in_place = x;
+        vector_exp(in_place, in_place);
+        EXPECT_EQ(std::memcmp(in_place.data(), expected.data(), x.size() * sizeof(double)), 0);
+
+        vector_hypot(x, y, expected);
+        in_place = x;
+        vector_hypot(in_place, y, in_place);
+        EXPECT_EQ(std::memcmp(in_place.data(), expected.data(), x.size() * sizeof(double)), 0);
+    }
+}
+
+TEST(MathKernelsTest, KinematicsMatchDefinitions) {
+    using Particles = Columnar<int, double, double, double, double>;
+    auto df = Particles::try_read_from_csv("data/particles.csv");
+    ASSERT_TRUE(df);
+    const auto px = df->get_column_view<1>();
+    const auto py = df->get_column_view<2>();
+    const auto pz = df->get_column_view<3>();
+    const auto energy = df->get_column_view<4>();
+
+    const auto pt = transverse_momentum(px, py);
+    const auto p = total_momentum(px, py, pz);
+    const auto phi = azimuth(px, py);
+    const auto eta = pseudorapidity(px, py, pz);
+    const auto mass = invariant_mass(energy, px, py, pz);
+    ASSERT_EQ(pt.size(), df->num_rows());
+    for (size_t i = 0; i < df->num_rows(); ++i) {
+        const double momentum = std::sqrt(px[i] * px[i] + py[i] * py[i] + pz[i] * pz[i]);
+        EXPECT_NEAR(pt[i], std::hypot(px[i], py[i]), 1e-12 * pt[i]);
+        EXPECT_NEAR(p[i], momentum, 1e-12 * momentum);
+        EXPECT_NEAR(phi[i], std::atan2(py[i], px[i]), 1e-12);
+        EXPECT_NEAR(eta[i], std::asinh(pz[i] / pt[i]), 1e-12 * std::max(1.0, std::fabs(eta[i])));
+        const double m2 = energy[i] * energy[i] - momentum * momentum;
+        if (m2 > 0.0) {
+            EXPECT_NEAR(mass[i], std::sqrt(m2), 1e-9 * energy[i]);
+        } else {
+            EXPECT_TRUE(std::isnan(mass[i]) || mass[i] == 0.0);
+        }
+    }
+
+    // Along the beam axis and at rest.
+    const std::vector<double> zero{0.0, 0.0};
+    const std::vector<double> beam{3.0, -3.0};
+    const auto axis = pseudorapidity(zero, zero, beam);
+    EXPECT_EQ(axis[0], std::numeric_limits<double>::infinity());
+    EXPECT_EQ(axis[1], -std::numeric_limits<double>::infinity());
+    EXPECT_TRUE(std::isnan(pseudorapidity(zero, zero, zero)[0]));
+    const std::vector<double> rest_energy{0.938, 0.938};
+    EXPECT_DOUBLE_EQ(invariant_mass(rest_energy, zero, zero, zero)[0], 0.938);
+}
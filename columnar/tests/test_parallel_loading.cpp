@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include "columnar/numa.h"
+
+#include <mutex>
+#include <numeric>
+
+using namespace columnar;
+
+namespace {
+
+using ParticleTable = Columnar<int, double, double, double, double>;
+
+ParticleTable read_particles() {
+    auto result = ParticleTable::try_read_from_csv("data/particles.csv");
+    EXPECT_TRUE(result.has_value());
+    return std::move(*result);
+}
+
+}
+
+TEST(ParallelLoadingTest, MatchesSequentialRead) {
+    auto expected = read_particles();
+    ThreadPool pool(3);
+
+    for (size_t parts : {1u, 2u, 3u, 7u, 64u}) {
+        auto result = try_read_from_csv_parallel<int, double, double, double, double>("data/particles.csv", pool, parts);
+        ASSERT_TRUE(result.has_value()) << "parts = " << parts;
+        ASSERT_EQ(result->num_rows(), expected.num_rows()) << "parts = " << parts;
+
+        auto ids = result->get_column_view<0>();
+        auto expected_ids = expected.get_column_view<0>();
+        EXPECT_TRUE(std::equal(ids.begin(), ids.end(), expected_ids.begin())) << "parts = " << parts;
+        EXPECT_EQ(result->column_names()[4], "energy");
+    }
+}
+
+TEST(ParallelLoadingTest, ReportsErrors) {
+    ThreadPool pool(2);
+
+    auto missing = try_read_from_csv_parallel<int, int>("nonexistent.csv", pool);
+    ASSERT_FALSE(missing.has_value());
+    EXPECT_EQ(missing.error(), CsvError::FileNotFound);
+
+    auto wrong_types = try_read_from_csv_parallel<int, int>("data/mixed_types.csv", pool);
+    ASSERT_FALSE(wrong_types.has_value());
+}
+
+TEST(NumaTest, SystemTopologyHasAtLeastOneNode) {
+    const auto& topology = NumaTopology::system();
+    ASSERT_GE(topology.node_count(), 1u);
+    EXPECT_FALSE(topology.cpus(0).empty());
+}
+
+TEST(NumaTest, PartitionsFollowNodes) {
+    auto topology = NumaTopology::from_nodes({{0}, {0}});
+    auto result = try_read_from_csv_numa<int, double, double, double, double>("data/particles.csv", 2, topology);
+    ASSERT_TRUE(result.has_value());
+
+    auto expected = read_particles();
+    ASSERT_EQ(result->table.num_rows(), expected.num_rows());
+
+    size_t covered = 0;
+    for (const auto& partition : result->partitions) {
+        EXPECT_LT(partition.node, 2u);
+        EXPECT_EQ(partition.begin_row, covered);
+        covered = partition.end_row;
+    }
+    EXPECT_EQ(covered, expected.num_rows());
+
+    const auto ids = result->table.get_column_view<0>();
+    const auto energies = result->table.get_column_view<4>();
+    EXPECT_TRUE(std::ranges::equal(ids, expected.get_column_view<0>()));
+    EXPECT_TRUE(std::ranges::equal(energies, expected.get_column_view<4>()));
+    EXPECT_EQ(result->table.column_names()[4], expected.column_names()[4]);
+}
+
+TEST(NumaTest, ParallelForVisitsEveryRowOnce) {
+    auto topology = NumaTopology::from_nodes({{0}, {0}});
+    std::vector<NumaPartition> partitions{{0, 0, 500}, {1, 500, 1003}};
+
+    std::vector<int> visits(1003, 0);
+    std::mutex mutex;
+    numa_parallel_for(partitions, 64, [&](size_t begin, size_t end) {
+        std::lock_guard lock(mutex);
+        for (size_t i = begin; i < end; ++i) {
+            ++visits[i];
+        }
+    }, 2, topology);
+
+    EXPECT_TRUE(std::all_of(visits.begin(), visits.end(), [](int v) { return v == 1; }));
+}
@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include "columnar/query_cache.h"
+
+#include <cmath>
+
+using namespace columnar;
+
+class QueryTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        auto result = Columnar<int, double, double, double, double>::try_read_from_csv("data/particles.csv");
+        ASSERT_TRUE(result.has_value());
+        df = std::move(*result);
+    }
+
+    Columnar<int, double, double, double, double> df;
+};
+
+TEST_F(QueryTest, SelectMatchesFilter) {
+    std::vector<Comparison> where{{"energy", CompareOp::Greater, 15.0}, {"particle_id", CompareOp::LessEqual, int64_t{8}}};
+    auto selection = select_rows(df, where);
+    ASSERT_TRUE(selection.has_value());
+
+    auto expected = df.filter<double>("energy", [](double e) { return e > 15.0; });
+    ASSERT_TRUE(expected.has_value());
+    auto expected2 = expected->filter<int>("particle_id", [](int id) { return id <= 8; });
+    ASSERT_TRUE(expected2.has_value());
+
+    EXPECT_EQ(selection->count(), expected2->num_rows());
+
+    auto taken = df.take(selection->to_indices());
+    ASSERT_TRUE(taken.has_value());
+    auto ids = taken->get_column_view<0>();
+    auto expected_ids = expected2->get_column_view<0>();
+    EXPECT_TRUE(std::equal(ids.begin(), ids.end(), expected_ids.begin(), expected_ids.end()));
+}
+
+TEST_F(QueryTest, SelectReportsErrors) {
+    std::vector<Comparison> missing{{"mass", CompareOp::Greater, 1.0}};
+    auto missing_result = select_rows(df, missing);
+    ASSERT_FALSE(missing_result.has_value());
+    EXPECT_EQ(missing_result.error(), CsvError::ColumnNotFound);
+
+    std::vector<Comparison> wrong_type{{"energy", CompareOp::Equal, std::string("high")}};
+    auto wrong_type_result = select_rows(df, wrong_type);
+    ASSERT_FALSE(wrong_type_result.has_value());
+    EXPECT_EQ(wrong_type_result.error(), CsvError::ParseError);
+}
+
+TEST_F(QueryTest, Aggregates) {
+    auto energies = df.get_column_view<4>();
+    double sum = 0.0;
+    for (double e : energies) {
+        sum += e;
+    }
+
+    auto total = aggregate(df, {AggregateOp::Sum, "energy"});
+    ASSERT_TRUE(total.has_value());
+    EXPECT_DOUBLE_EQ(*total, sum);
+
+    auto mean = aggregate(df, {AggregateOp::Mean, "energy"});
+    ASSERT_TRUE(mean.has_value());
+    EXPECT_DOUBLE_EQ(*mean, sum / energies.size());
+
+    auto max = aggregate(df, {AggregateOp::Max, "energy"});
+    ASSERT_TRUE(max.has_value());
+    EXPECT_DOUBLE_EQ(*max, *std::max_element(energies.begin(), energies.end()));
+
+    SelectionBitmap none(df.num_rows());
+    auto empty_min = aggregate(df, {AggregateOp::Min, "energy"}, &none);
+    ASSERT_TRUE(empty_min.has_value());
+    EXPECT_TRUE(std::isnan(*empty_min));
+}
+
+TEST(QueryCanonicalizationTest, OrderAndEquivalentConstantsShareKey) {
+    std::vector<Comparison> a{{"x", CompareOp::Greater, int64_t{5}}, {"y", CompareOp::Less, 2.5}};
+    std::vector<Comparison> b{{"y", CompareOp::Less, 2.5}, {"x", CompareOp::Greater, 5.0}, {"y", CompareOp::Less, 2.5}};
+    std::vector<Comparison> c{{"x", CompareOp::GreaterEqual, int64_t{5}}, {"y", CompareOp::Less, 2.5}};
+
+    EXPECT_EQ(canonicalize(a), canonicalize(b));
+    EXPECT_EQ(fingerprint(canonicalize(a)), fingerprint(canonicalize(b)));
+    EXPECT_NE(canonicalize(a), canonicalize(c));
+}
+
+TEST(QueryCanonicalizationTest, LargeIntegralDoublesKeepTheirOwnKey) {
+    // From 2^53 on, the row big + 1 rounds to big when compared as a double.
+    for (const int64_t big : {int64_t{1} << 53, int64_t{1} << 60}) {
+        Columnar<int64_t> df({"id"});
+        df.append_row(big);
+        df.append_row(big + 1);
+
+        std::vector<Comparison> as_integer{{"id", CompareOp::Equal, big}};
+        std::vector<Comparison> as_double{{"id", CompareOp::Equal, static_cast<double>(big)}};
+        EXPECT_NE(canonicalize(as_integer), canonicalize(as_double)) << big;
+
+        QueryCache cache(1 << 20);
+        for (const auto& where : {as_integer, as_double}) {
+            auto cached = cache.select_rows(df, where);
+            auto direct = select_rows(df, where);
+            ASSERT_TRUE(cached.has_value());
+            ASSERT_TRUE(direct.has_value());
+            EXPECT_EQ((*cached)->count(), direct->count()) << big;
+        }
+        EXPECT_EQ(cache.misses(), 2u) << big;
+    }
+}
+
+TEST_F(QueryTest, CacheHitsAndInvalidatesOnMutation) {
+    QueryCache cache(1 << 20);
+    std::vector<Comparison> where{{"energy", CompareOp::Greater, 12.0}};
+    Aggregate mean{AggregateOp::Mean, "px"};
+
+    auto first = cache.aggregate(df, where, mean);
+    ASSERT_TRUE(first.has_value());
+    const size_t misses = cache.misses();
+
+    auto second = cache.aggregate(df, where, mean);
+    ASSERT_TRUE(second.has_value());
+    EXPECT_DOUBLE_EQ(*first, *second);
+    EXPECT_EQ(cache.misses(), misses);
+    EXPECT_GE(cache.hits(), 1u);
+
+    df.append_row(99, 1000.0, 0.0, 0.0, 1000.0);
+    auto third = cache.aggregate(df, where, mean);
+    ASSERT_TRUE(third.has_value());
+    EXPECT_GT(cache.misses(), misses);
+    EXPECT_NE(*third, *first);
+}
+
+TEST_F(QueryTest, CacheRespectsMemoryBudget) {
+    QueryCache cache(600);
+    for (int threshold = 0; threshold < 20; ++threshold) {
+        std::vector<Comparison> where{{"energy", CompareOp::Greater, int64_t{threshold}}};
+        auto selection = cache.select_rows(df, where);
+        ASSERT_TRUE(selection.has_value());
+        EXPECT_LE(cache.memory_usage(), 600u);
+    }
+    EXPECT_LT(cache.size(), 20u);
+    EXPECT_GT(cache.size(), 0u);
+
+    cache.invalidate(df);
+    EXPECT_EQ(cache.size(), 0u);
+    EXPECT_EQ(cache.memory_usage(), 0u);
+}
+
+TEST(TableGenerationTest, CopiesShareAndMutationsRenew) {
+    Columnar<int> a({"x"});
+    a.append_row(1);
+    const uint64_t before = a.generation();
+
+    auto b = a;
+    EXPECT_EQ(b.generation(), before);
+
+    b.append_row(2);
+    EXPECT_NE(b.generation(), before);
+    EXPECT_EQ(a.generation(), before);
+
+    auto c = std::move(a);
+    EXPECT_EQ(c.generation(), before);
+    EXPECT_NE(a.generation(), before);
+}
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include "columnar/query.h"
+#include "columnar/regression.h"
+
+#include <random>
+
+using namespace columnar;
+
+namespace {
+
+using CalibrationTable = Columnar<int64_t, double, float, double, std::string>;
+
+// response = 3 + 2 * adc - 0.5 * temperature + noise, on a timestamp scale.
+CalibrationTable make_calibration(size_t rows, double noise_sigma) {
+    CalibrationTable table({"time", "adc", "temperature", "energy", "detector"});
+    std::mt19937_64 rng(11);
+    std::uniform_real_distribution<double> adc(0.0, 100.0);
+    std::normal_distribution<double> noise(0.0, noise_sigma);
+    for (size_t i = 0; i < rows; ++i) {
+        const double a = adc(rng);
+        const auto temperature = static_cast<float>(20 + i % 13);
+        const bool broken = i % 4 == 0;
+        const double energy = broken ? -1.0 : 3.0 + 2.0 * a - 0.5 * temperature + noise(rng);
+        table.append_row(static_cast<int64_t>(1'700'000'000 + i), a, temperature, energy, broken ? "bad" : "ok");
+    }
+    return table;
+}
+
+}
+
+TEST(RegressionTest, RecoversCoefficients) {
+    const auto table = make_calibration(20000, 0.0);
+    const std::vector<std::string> predictors{"adc", "temperature"};
+    const std::vector<Comparison> good{{"detector", CompareOp::Equal, std::string("ok")}};
+    auto selection = select_rows(table, good);
+    ASSERT_TRUE(selection.has_value());
+
+    ThreadPool pool(3);
+    for (ThreadPool* threads : {static_cast<ThreadPool*>(nullptr), &pool}) {
+        auto fit = fit_linear(table, predictors, "energy", threads, &*selection);
+        ASSERT_TRUE(fit.has_value());
+        EXPECT_EQ(fit->count, 15000u);
+        EXPECT_NEAR(fit->intercept, 3.0, 1e-8);
+        EXPECT_NEAR(fit->coefficients[0], 2.0, 1e-10);
+        EXPECT_NEAR(fit->coefficients[1], -0.5, 1e-10);
+        EXPECT_NEAR(fit->r_squared, 1.0, 1e-12);
+        const std::vector<double> x{10.0, 25.0};
+        EXPECT_NEAR(fit->predict(x), 3.0 + 20.0 - 12.5, 1e-8);
+    }
+
+    // Without the selection the broken rows pull the fit away.
+    auto unfiltered = fit_linear(table, predictors, "energy");
+    ASSERT_TRUE(unfiltered.has_value());
+    EXPECT_LT(unfiltered->r_squared, 0.9);
+
+    // A large-offset predictor alone: adc does not drift with time.
+    const std::vector<std::string> time{"time"};
+    auto drift = fit_linear(table, time, "adc", nullptr, &*selection);
+    ASSERT_TRUE(drift.has_value());
+    EXPECT_NEAR(drift->coefficients[0], 0.0, 1e-3);
+}
+
+TEST(RegressionTest, MatchesNoisyReference) {
+    const auto table = make_calibration(5000, 1.5);
+    const std::vector<std::string> predictors{"adc"};
+    const auto adc = table.get_column_view<1>();
+    const auto energy = table.get_column_view<3>();
+
+    // Simple regression closed form over all rows.
+    double mean_x = 0.0;
+    double mean_y = 0.0;
+    for (size_t i = 0; i < adc.size(); ++i) {
+        mean_x += adc[i];
+        mean_y += energy[i];
+    }
+    mean_x /= static_cast<double>(adc.size());
+    mean_y /= static_cast<double>(adc.size());
+    double sxy = 0.0;
+    double sxx = 0.0;
+    for (size_t i = 0; i < adc.size(); ++i) {
+        sxy += (adc[i] - mean_x) * (energy[i] - mean_y);
+        sxx += (adc[i] - mean_x) * (adc[i] - mean_x);
+    }
+
+    auto fit = fit_linear(table, predictors, "energy");
+    ASSERT_TRUE(fit.has_value());
+    EXPECT_NEAR(fit->coefficients[0], sxy / sxx, 1e-9);
+    EXPECT_NEAR(fit->intercept, mean_y - sxy / sxx * mean_x, 1e-7);
+    EXPECT_GT(fit->residual_sum_of_squares, 0.0);
+}
+
+TEST(RegressionTest, ReportsErrors) {
+    auto table = make_calibration(100, 0.0);
+    const std::vector<std::string> collinear{"adc", "adc"};
+    EXPECT_EQ(fit_linear(table, collinear, "energy").error(), CsvError::InvalidFormat);
+    const std::vector<std::string> missing{"pressure"};
+    EXPECT_EQ(fit_linear(table, missing, "energy").error(), CsvError::ColumnNotFound);
+    const std::vector<std::string> adc{"adc"};
+    EXPECT_EQ(fit_linear(table, adc, "detector").error(), CsvError::ParseError);
+
+    SelectionBitmap one_row(table.num_rows());
+    one_row.set(1);
+    EXPECT_EQ(fit_linear(table, adc, "energy", nullptr, &one_row).error(), CsvError::InvalidFormat);
+}
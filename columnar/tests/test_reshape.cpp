@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include "columnar/reshape.h"
+
+#include <cmath>
+
+using namespace columnar;
+
+namespace {
+
+using ReadingTable = Columnar<int64_t, std::string, double, int>;
+
+// Per-channel readings in long format: (event, channel, adc, gain).
+ReadingTable make_readings() {
+    ReadingTable table({"event", "channel", "adc", "gain"});
+    const std::vector<std::string> channels{"ch0", "ch1", "ch2"};
+    for (int64_t event = 0; event < 4; ++event) {
+        for (size_t c = 0; c < channels.size(); ++c) {
+            if (event == 3 && c == 1) continue;  // one missing reading
+            table.append_row(event, channels[c], static_cast<double>(event * 10 + static_cast<int64_t>(c)),
+                             static_cast<int>(c) + 1);
+        }
+    }
+    return table;
+}
+
+template <typename T>
+const std::vector<T>& values_of(const ResultColumn& column) {
+    return std::get<std::vector<T>>(column.values);
+}
+
+}
+
+TEST(ReshapeTest, PivotSpreadsValuesIntoColumns) {
+    const auto table = make_readings();
+    auto wide = pivot(table, "event", "channel", "adc");
+    ASSERT_TRUE(wide.has_value());
+    ASSERT_EQ(wide->size(), 4u);
+    EXPECT_EQ((*wide)[0].name, "event");
+    EXPECT_EQ(values_of<int64_t>((*wide)[0]), (std::vector<int64_t>{0, 1, 2, 3}));
+    EXPECT_EQ((*wide)[2].name, "ch1");
+    const auto& ch1 = values_of<double>((*wide)[2]);
+    EXPECT_EQ(ch1[2], 21.0);
+    EXPECT_TRUE(std::isnan(ch1[3]));
+    EXPECT_EQ(values_of<double>((*wide)[3])[3], 32.0);
+
+    // Numeric column values become column names; missing strings are empty.
+    auto by_gain = pivot(table, "event", "gain", "channel");
+    ASSERT_TRUE(by_gain.has_value());
+    EXPECT_EQ((*by_gain)[1].name, "1");
+    EXPECT_EQ(values_of<std::string>((*by_gain)[2]), (std::vector<std::string>{"ch1", "ch1", "ch1", ""}));
+
+    // The same (event, channel) twice cannot be spread.
+    auto duplicated = table;
+    duplicated.append_row(0, "ch0", 1.0, 1);
+    EXPECT_EQ(pivot(duplicated, "event", "channel", "adc").error(), CsvError::InvalidFormat);
+    EXPECT_EQ(pivot(table, "event", "channel", "pedestal").error(), CsvError::ColumnNotFound);
+}
+
+TEST(ReshapeTest, MeltRoundTripsPivot) {
+    const auto table = make_readings();
+    auto wide = pivot(table, "event", "channel", "adc");
+    ASSERT_TRUE(wide.has_value());
+    auto wide_table = Columnar<int64_t, double, double, double>::from_columns(
+        {"event", "ch0", "ch1", "ch2"}, values_of<int64_t>((*wide)[0]), values_of<double>((*wide)[1]),
+        values_of<double>((*wide)[2]), values_of<double>((*wide)[3]));
+    ASSERT_TRUE(wide_table.has_value());
+
+    const std::vector<std::string> ids{"event"};
+    auto long_form = melt(*wide_table, ids, {}, "channel", "adc");
+    ASSERT_TRUE(long_form.has_value());
+    ASSERT_EQ(long_form->size(), 3u);
+    EXPECT_EQ(values_of<int64_t>((*long_form)[0]), (std::vector<int64_t>{0, 1, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3}));
+    const auto& channels = values_of<std::string>((*long_form)[1]);
+    EXPECT_EQ(channels[0], "ch0");
+    EXPECT_EQ(channels[4], "ch1");
+    EXPECT_EQ(channels[11], "ch2");
+    const auto& adc = values_of<double>((*long_form)[2]);
+    EXPECT_EQ(adc[6], 21.0);
+    EXPECT_TRUE(std::isnan(adc[7]));
+
+    // Integer and floating-point value columns widen to double.
+    const std::vector<std::string> mixed{"adc", "gain"};
+    auto widened = melt(table, ids, mixed);
+    ASSERT_TRUE(widened.has_value());
+    EXPECT_EQ(values_of<double>((*widened)[2]).size(), 2 * table.num_rows());
+    EXPECT_EQ(values_of<double>((*widened)[2])[table.num_rows()], 1.0);
+
+    const std::vector<std::string> strings_and_numbers{"channel", "adc"};
+    EXPECT_EQ(melt(table, ids, strings_and_numbers).error(), CsvError::ParseError);
+    const std::vector<std::string> missing{"pedestal"};
+    EXPECT_EQ(melt(table, ids, missing).error(), CsvError::ColumnNotFound);
+    EXPECT_EQ(melt(table, missing, mixed).error(), CsvError::ColumnNotFound);
+}
@@ -0,0 +1,211 @@
+#include <gtest/gtest.h>
+#include "columnar/server.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+
+#include <thread>
+
+using namespace columnar;
+
+namespace {
+
+using ParticleTable = Columnar<int, double, double, double, double>;
+
+std::filesystem::path socket_path(const std::string& name) {
+    return std::filesystem::temp_directory_path() / ("columnar_" + name + "_" + std::to_string(::getpid()) + ".sock");
+}
+
+}
+
+TEST(WireTest, RequestRoundTrip) {
+    QueryRequest request{"particles",
+                         {{"energy", CompareOp::Greater, 10.0}, {"label", CompareOp::Equal, std::string("mu")}},
+                         {"particle_id", "px"},
+                         {{AggregateOp::Mean, "energy"}},
+                         25};
+    std::string frame;
+    encode(request, frame);
+
+    auto decoded = try_decode_request(frame);
+    ASSERT_TRUE(decoded.has_value());
+    EXPECT_EQ(decoded->table, "particles");
+    ASSERT_EQ(decoded->where.size(), 2u);
+    EXPECT_EQ(decoded->where[0].op, CompareOp::Greater);
+    EXPECT_EQ(std::get<std::string>(decoded->where[1].value), "mu");
+    EXPECT_EQ(decoded->columns[1], "px");
+    EXPECT_EQ(decoded->aggregates[0].op, AggregateOp::Mean);
+    EXPECT_EQ(decoded->limit, 25u);
+
+    EXPECT_FALSE(try_decode_request(std::span<const char>(frame).first(frame.size() - 3)).has_value());
+}
+
+TEST(WireTest, ErrorResultRoundTrip) {
+    std::string frame;
+    encode(Expected<QueryResult, CsvError>(CsvError::ColumnNotFound), frame);
+    auto decoded = try_decode_result(frame);
+    ASSERT_FALSE(decoded.has_value());
+    EXPECT_EQ(decoded.error(), CsvError::ColumnNotFound);
+}
+
+TEST(QueryServerTest, ServesFilterProjectionAndAggregates) {
+    auto loaded = ParticleTable::try_read_from_csv("data/particles.csv");
+    ASSERT_TRUE(loaded.has_value());
+    auto table = std::make_shared<const ParticleTable>(std::move(*loaded));
+
+    QueryServer server;
+    server.add_table("particles", table);
+    const auto path = socket_path("server");
+    ASSERT_TRUE(server.listen(path).has_value());
+    std::thread serving([&] { server.serve(); });
+
+    auto client = QueryClient::try_connect(path);
+    ASSERT_TRUE(client.has_value());
+
+    QueryRequest request{"particles", {{"energy", CompareOp::Greater, 15.0}}, {"particle_id", "energy"},
+                         {{AggregateOp::Count, ""}, {AggregateOp::Max, "energy"}}};
+    auto result = client->execute(request);
+    ASSERT_TRUE(result.has_value());
+
+    auto expected = execute_query(*table, request);
+    ASSERT_TRUE(expected.has_value());
+    EXPECT_EQ(result->matched_rows, expected->matched_rows);
+    ASSERT_EQ(result->columns.size(), 2u);
+    EXPECT_EQ(std::get<std::vector<int64_t>>(result->columns[0].values),
+              std::get<std::vector<int64_t>>(expected->columns[0].values));
+    EXPECT_EQ(std::get<std::vector<double>>(result->columns[1].values),
+              std::get<std::vector<double>>(expected->columns[1].values));
+    ASSERT_EQ(result->aggregates.size(), 2u);
+    EXPECT_DOUBLE_EQ(result->aggregates[0], static_cast<double>(expected->matched_rows));
+    EXPECT_DOUBLE_EQ(result->aggregates[1], expected->aggregates[1]);
+
+    auto unknown = client->execute({"missing", {}, {}, {}});
+    ASSERT_FALSE(unknown.has_value());
+    EXPECT_EQ(unknown.error(), CsvError::FileNotFound);
+
+    auto bad_column = client->execute({"particles", {}, {"mass"}, {}});
+    ASSERT_FALSE(bad_column.has_value());
+    EXPECT_EQ(bad_column.error(), CsvError::ColumnNotFound);
+
+    server.stop();
+    serving.join();
+    EXPECT_FALSE(std::filesystem::exists(path));
+}
+
+TEST(QueryServerTest, ConcurrentClients) {
+    auto table = std::make_shared<const Columnar<std::string, int>>([] {
+        Columnar<std::string, int> t({"name", "count"});
+        for (int i = 0; i < 1000; ++i) {
+            t.append_row("row" + std::to_string(i), i);
+        }
+        return t;
+    }());
+
+    QueryServer server;
+    server.add_table("rows", table);
+    const auto path = socket_path("concurrent");
+    ASSERT_TRUE(server.listen(path).has_value());
+    std::thread serving([&] { server.serve(); });
+
+    std::vector<std::thread> clients;
+    std::atomic<int> successes{0};
+    for (int c = 0; c < 4; ++c) {
+        clients.emplace_back([&, c] {
+            auto client = QueryClient::try_connect(path);
+            if (!client) return;
+            for (int q = 0; q < 10; ++q) {
+                auto result = client->execute({"rows", {{"count", CompareOp::Less, int64_t{c * 100 + q}}}, {"name"}, {}, 5});
+                if (result && result->matched_rows == static_cast<uint64_t>(c * 100 + q) &&
+                    std::get<std::vector<std::string>>(result->columns[0].values).size() ==
+                        std::min<size_t>(5, c * 100 + q)) {
+                    ++successes;
+                }
+            }
+        });
+    }
+    for (auto& client : clients) {
+        client.join();
+    }
+    EXPECT_EQ(successes.load(), 40);
+
+    server.stop();
+    serving.join();
+}
+
+TEST(QueryServerTest, OversizedResultBecomesError) {
+    auto table = std::make_shared<const Columnar<int>>([] {
+        Columnar<int> t({"x"});
+        for (int i = 0; i < 1000; ++i) {
+            t.append_row(i);
+        }
+        return t;
+    }());
+
+    QueryServer server;
+    server.add_table("t", table);
+    server.set_max_response_size(1024);
+    const auto path = socket_path("oversized");
+    ASSERT_TRUE(server.listen(path).has_value());
+    std::thread serving([&] { server.serve(); });
+
+    auto client = QueryClient::try_connect(path);
+    ASSERT_TRUE(client.has_value());
+    auto oversized = client->execute({"t", {}, {"x"}, {}});
+    ASSERT_FALSE(oversized.has_value());
+    EXPECT_EQ(oversized.error(), CsvError::IoError);
+
+    // The connection stays in step: a limited request still succeeds.
+    auto limited = client->execute({"t", {}, {"x"}, {}, 10});
+    ASSERT_TRUE(limited.has_value());
+    EXPECT_EQ(std::get<std::vector<int64_t>>(limited->columns[0].values).size(), 10u);
+
+    server.stop();
+    serving.join();
+}
+
+TEST(QueryServerTest, ReapsThreadsOfClosedConnections) {
+    auto table = std::make_shared<const Columnar<int>>([] {
+        Columnar<int> t({"x"});
+        t.append_row(1);
+        return t;
+    }());
+
+    QueryServer server;
+    server.add_table("t", table);
+    const auto path = socket_path("reap");
+    ASSERT_TRUE(server.listen(path).has_value());
+    std::thread serving([&] { server.serve(); });
+
+    for (int i = 0; i < 50; ++i) {
+        auto client = QueryClient::try_connect(path);
+        ASSERT_TRUE(client.has_value());
+        ASSERT_TRUE(client->execute({"t", {}, {}, {}}).has_value());
+    }
+    // Each accept joins the connections closed before it, so only the last
+    // few short-lived clients can still hold a thread.
+    auto client = QueryClient::try_connect(path);
+    ASSERT_TRUE(client.has_value());
+    ASSERT_TRUE(client->execute({"t", {}, {}, {}}).has_value());
+    EXPECT_LE(server.connection_count(), 10u);
+
+    server.stop();
+    serving.join();
+    EXPECT_EQ(server.connection_count(), 0u);
+}
+
+TEST(QueryServerTest, StopWhileServingFromAnotherThread) {
+    for (int round = 0; round < 20; ++round) {
+        QueryServer server;
+        const auto path = socket_path("stop");
+        ASSERT_TRUE(server.listen(path).has_value());
+        std::thread serving([&] { server.serve(); });
+        if (round % 2 == 0) {
+            auto client = QueryClient::try_connect(path);
+            ASSERT_TRUE(client.has_value());
+        }
+        server.stop();
+        serving.join();
+        EXPECT_FALSE(std::filesystem::exists(path));
+    }
+}
+
+#endif
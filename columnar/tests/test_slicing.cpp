@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include "columnar/columnar.h"
+
+using namespace columnar;
+
+class SlicingTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        auto result = Columnar<int, int>::try_read_from_csv("data/simple.csv");
+        ASSERT_TRUE(result.has_value());
+        df = std::move(*result);
+    }
+
+    Columnar<int, int> df;
+};
+
+TEST_F(SlicingTest, SliceSharesBuffers) {
+    auto slice_result = df.slice(1, 3);
+    ASSERT_TRUE(slice_result.has_value());
+    const auto& slice = *slice_result;
+
+    EXPECT_EQ(slice.num_rows(), 3u);
+    EXPECT_EQ(slice.num_cols(), 2u);
+    EXPECT_EQ(slice.column_names()[1], "value");
+
+    auto values = slice.get_column_view<1>();
+    EXPECT_EQ(values.data(), df.get_column_view<1>().data() + 1);
+    EXPECT_EQ(values[0], 20);
+    EXPECT_EQ(values[2], 40);
+}
+
+TEST_F(SlicingTest, SliceIsClampedToTable) {
+    auto tail = df.slice(3, 100);
+    ASSERT_TRUE(tail.has_value());
+    EXPECT_EQ(tail->num_rows(), 2u);
+
+    auto empty = df.slice(5, 1);
+    ASSERT_TRUE(empty.has_value());
+    EXPECT_EQ(empty->num_rows(), 0u);
+
+    auto out_of_range = df.slice(6, 1);
+    ASSERT_FALSE(out_of_range.has_value());
+    EXPECT_EQ(out_of_range.error(), CsvError::RowIndexOutOfBounds);
+}
+
+TEST_F(SlicingTest, NestedSliceAndRowAccess) {
+    auto outer = df.slice(1, 4);
+    ASSERT_TRUE(outer.has_value());
+    auto inner = outer->slice(2, 2);
+    ASSERT_TRUE(inner.has_value());
+
+    auto row = inner->get_row(0);
+    ASSERT_TRUE(row.has_value());
+    EXPECT_EQ(std::get<0>(*row), 4);
+    EXPECT_FALSE(inner->get_row(2).has_value());
+
+    auto by_name = inner->get_column_view<int>("id");
+    ASSERT_TRUE(by_name.has_value());
+    EXPECT_EQ((*by_name)[1], 5);
+}
+
+TEST_F(SlicingTest, SliceToColumnarCopies) {
+    auto slice = df.slice(2, 2);
+    ASSERT_TRUE(slice.has_value());
+
+    auto copy = slice->to_columnar();
+    EXPECT_EQ(copy.num_rows(), 2u);
+    EXPECT_EQ(copy.get_column_view<0>()[0], 3);
+    EXPECT_NE(copy.get_column_view<0>().data(), df.get_column_view<0>().data() + 2);
+}
+
+TEST_F(SlicingTest, TakeGathersRows) {
+    std::vector<size_t> indices{4, 0, 2, 2};
+    auto taken = df.take(indices);
+    ASSERT_TRUE(taken.has_value());
+
+    ASSERT_EQ(taken->num_rows(), 4u);
+    auto values = taken->get_column_view<1>();
+    EXPECT_EQ(values[0], 50);
+    EXPECT_EQ(values[1], 10);
+    EXPECT_EQ(values[3], 30);
+    EXPECT_EQ(taken->column_names()[0], "id");
+}
+
+TEST_F(SlicingTest, TakeRejectsOutOfRangeIndex) {
+    std::vector<size_t> indices{0, 5};
+    auto taken = df.take(indices);
+    ASSERT_FALSE(taken.has_value());
+    EXPECT_EQ(taken.error(), CsvError::RowIndexOutOfBounds);
+}
@@ -0,0 +1,185 @@
+#include <gtest/gtest.h>
+#include "columnar/snapshot.h"
+#include "temp_dir_util.h"
+
+#include <thread>
+
+using namespace columnar;
+
+namespace {
+
+Columnar<int, std::string, double> make_table() {
+    Columnar<int, std::string, double> table({"id", "label", "energy"});
+    table.append_row(1, "muon", 10.5);
+    table.append_row(2, "", 0.25);
+    table.append_row(3, "a label long enough to need a heap allocation", -3.0);
+    return table;
+}
+
+}
+
+TEST(SnapshotTest, RoundTripPreservesValuesAndNames) {
+    auto table = make_table();
+    std::string buffer;
+    serialize(table, buffer, "tag");
+
+    std::string tag;
+    auto restored = try_deserialize<int, std::string, double>(buffer, &tag);
+    ASSERT_TRUE(restored.has_value());
+    EXPECT_EQ(tag, "tag");
+    ASSERT_EQ(restored->num_rows(), 3u);
+    EXPECT_EQ(restored->column_names()[1], "label");
+    EXPECT_EQ(restored->get_column_view<1>()[2], table.get_column_view<1>()[2]);
+    EXPECT_EQ(restored->get_column_view<1>()[1], "");
+    EXPECT_DOUBLE_EQ(restored->get_column_view<2>()[2], -3.0);
+}
+
+TEST(SnapshotTest, RejectsWrongSchemaAndCorruption) {
+    std::string buffer;
+    serialize(make_table(), buffer);
+
+    auto wrong_schema = try_deserialize<int, std::string, float>(buffer);
+    ASSERT_FALSE(wrong_schema.has_value());
+    EXPECT_EQ(wrong_schema.error(), CsvError::InvalidFormat);
+
+    auto truncated = try_deserialize<int, std::string, double>(std::span<const char>(buffer).first(buffer.size() - 5));
+    ASSERT_FALSE(truncated.has_value());
+    EXPECT_EQ(truncated.error(), CsvError::InvalidFormat);
+}
+
+TEST(SnapshotTest, RejectsRowCountsThatWrapThePayloadSize) {
+    Columnar<int, std::string> table({"id", "label"});
+    table.append_row(1, "a");
+    table.append_row(2, "b");
+    table.append_row(3, "c");
+    std::string buffer;
+    serialize(table, buffer);
+
+    // 2^62 + 3 ints take 12 bytes modulo 2^64, the size of the real column;
+    // 2^61 - 1 strings need 2^64 bytes of offsets, which wraps to 0.
+    constexpr size_t kRowsOffset = sizeof(detail::kSnapshotMagic) + 2 * sizeof(uint32_t);
+    for (const uint64_t rows : {(uint64_t{1} << 62) + 3, (uint64_t{1} << 61) - 1}) {
+        std::memcpy(buffer.data() + kRowsOffset, &rows, sizeof(rows));
+        auto restored = try_deserialize<int, std::string>(buffer);
+        ASSERT_FALSE(restored.has_value()) << rows;
+        EXPECT_EQ(restored.error(), CsvError::InvalidFormat);
+
+        TempDirectory dir("columnar_snapshot_rows");
+        const auto path = dir.path() / "table.colsnap";
+        std::ofstream(path, std::ios::binary).write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        auto info = try_read_snapshot_info<int, std::string>(path);
+        ASSERT_FALSE(info.has_value()) << rows;
+        EXPECT_EQ(info.error(), CsvError::InvalidFormat);
+    }
+}
+
+TEST(SnapshotTest, WriteAndMapFile) {
+    TempDirectory dir("columnar_snapshot");
+    const auto path = dir.path() / "table.colsnap";
+
+    auto written = write_snapshot(make_table(), path);
+    ASSERT_TRUE(written.has_value());
+    EXPECT_EQ(*written, std::filesystem::file_size(path));
+
+    auto restored = try_read_snapshot<int, std::string, double>(path);
+    ASSERT_TRUE(restored.has_value());
+    EXPECT_EQ(restored->num_rows(), 3u);
+
+    auto missing = try_read_snapshot<int, std::string, double>(dir.path() / "missing.colsnap");
+    ASSERT_FALSE(missing.has_value());
+    EXPECT_EQ(missing.error(), CsvError::FileNotFound);
+}
+
+TEST(SnapshotTest, InfoReadsHeaderAndSectionSizes) {
+    TempDirectory dir("columnar_snapshot_info");
+    const auto path = dir.path() / "table.colsnap";
+    const auto table = make_table();
+    ASSERT_TRUE(write_snapshot(table, path, "tag").has_value());
+
+    auto info = try_read_snapshot_info<int, std::string, double>(path);
+    ASSERT_TRUE(info.has_value());
+    EXPECT_EQ(info->rows, 3u);
+    EXPECT_EQ(info->tag, "tag");
+    EXPECT_EQ(info->column_names, (std::vector<std::string>{"id", "label", "energy"}));
+    ASSERT_EQ(info->payload_bytes.size(), 3u);
+    EXPECT_EQ(info->payload_bytes[0], 3 * sizeof(int));
+    size_t characters = 0;
+    for (const auto& label : table.get_column_view<1>()) {
+        characters += label.size();
+    }
+    EXPECT_EQ(info->memory_bytes, 3 * sizeof(int) + 3 * sizeof(std::string) + characters + 3 * sizeof(double));
+
+    auto wrong_schema = try_read_snapshot_info<int, std::string, float>(path);
+    ASSERT_FALSE(wrong_schema.has_value());
+    EXPECT_EQ(wrong_schema.error(), CsvError::InvalidFormat);
+
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 5);
+    auto truncated = try_read_snapshot_info<int, std::string, double>(path);
+    ASSERT_FALSE(truncated.has_value());
+    EXPECT_EQ(truncated.error(), CsvError::InvalidFormat);
+
+    auto missing = try_read_snapshot_info<int, std::string, double>(dir.path() / "missing.colsnap");
+    ASSERT_FALSE(missing.has_value());
+    EXPECT_EQ(missing.error(), CsvError::FileNotFound);
+}
+
+TEST(SnapshotTest, ConcurrentWritersUseSeparateTemporaryFiles) {
+    // Repeated writes from one thread (or process) must not share a name.
+    EXPECT_NE(detail::unique_temporary_suffix(), detail::unique_temporary_suffix());
+
+    TempDirectory dir("columnar_snapshot_writers");
+    const auto path = dir.path() / "table.colsnap";
+    std::vector<std::thread> writers;
+    for (int i = 0; i < 4; ++i) {
+        writers.emplace_back([&] {
+            for (int j = 0; j < 20; ++j) {
+                EXPECT_TRUE(write_snapshot(make_table(), path).has_value());
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+
+    auto restored = try_read_snapshot<int, std::string, double>(path);
+    ASSERT_TRUE(restored.has_value());
+    EXPECT_EQ(restored->num_rows(), 3u);
+    EXPECT_EQ(std::distance(std::filesystem::directory_iterator(dir.path()), std::filesystem::directory_iterator()), 1);
+}
+
+TEST(SnapshotTest, CachedCsvLoadUsesSnapshot) {
+    TempDirectory dir("columnar_csv_cache");
+    const auto cache_dir = dir.path() / "cache";
+
+    auto first = try_read_from_csv_cached<int, double, double, double, double>("data/particles.csv", cache_dir);
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(first->num_rows(), 10u);
+
+    std::vector<std::filesystem::path> snapshots;
+    for (const auto& entry : std::filesystem::directory_iterator(cache_dir)) {
+        snapshots.push_back(entry.path());
+    }
+    ASSERT_EQ(snapshots.size(), 1u);
+
+    // Replace the snapshot contents while keeping its key: a cache hit must
+    // return the replacement instead of reparsing the CSV.
+    auto key = csv_cache_key<int, double, double, double, double>("data/particles.csv");
+    ASSERT_TRUE(key.has_value());
+    auto replacement = first->slice(0, 4)->to_columnar();
+    ASSERT_TRUE(write_snapshot(replacement, snapshots[0], *key).has_value());
+
+    auto second = try_read_from_csv_cached<int, double, double, double, double>("data/particles.csv", cache_dir);
+    ASSERT_TRUE(second.has_value());
+    EXPECT_EQ(second->num_rows(), 4u);
+
+    auto other_schema = try_read_from_csv_cached<int, double, double, double, float>("data/particles.csv", cache_dir);
+    ASSERT_TRUE(other_schema.has_value());
+    EXPECT_EQ(other_schema->num_rows(), 10u);
+}
+
+TEST(SnapshotTest, CachedLoadOfMissingCsv) {
+    TempDirectory dir("columnar_csv_cache_missing");
+    auto result = try_read_from_csv_cached<int, int>("nonexistent.csv", dir.path());
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error(), CsvError::FileNotFound);
+}
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include "columnar/statistics.h"
+
+#include <cmath>
+#include <limits>
+#include <random>
+
+using namespace columnar;
+
+namespace {
+
+using SensorTable = Columnar<int64_t, double, std::string>;
+
+SensorTable make_sensors(size_t rows) {
+    SensorTable table({"id", "reading", "site"});
+    std::mt19937_64 rng(3);
+    std::normal_distribution<double> reading(50.0, 10.0);
+    for (size_t i = 0; i < rows; ++i) {
+        table.append_row(static_cast<int64_t>(i), reading(rng), "site" + std::to_string(i % 20));
+    }
+    return table;
+}
+
+double actual_selectivity(const SensorTable& table, const Comparison& comparison) {
+    auto selected = select_rows(table, std::span<const Comparison>(&comparison, 1));
+    return static_cast<double>(selected->count()) / static_cast<double>(table.num_rows());
+}
+
+}
+
+TEST(HyperLogLogTest, EstimatesDistinctCounts) {
+    for (size_t distinct : {10u, 1000u, 100000u}) {
+        HyperLogLog counter;
+        for (size_t repeat = 0; repeat < 3; ++repeat) {
+            for (size_t i = 0; i < distinct; ++i) {
+                counter.add(static_cast<int64_t>(i));
+            }
+        }
+        EXPECT_NEAR(counter.estimate(), static_cast<double>(distinct), 0.05 * static_cast<double>(distinct) + 1.0);
+    }
+
+    HyperLogLog left;
+    HyperLogLog right;
+    for (int64_t i = 0; i < 5000; ++i) {
+        (i % 2 == 0 ? left : right).add(i);
+    }
+    left.merge(right);
+    EXPECT_NEAR(left.estimate(), 5000.0, 250.0);
+}
+
+TEST(StatisticsTest, CollectsColumnStatistics) {
+    SensorTable table({"id", "reading", "site"});
+    table.append_row(1, 2.5, "a");
+    table.append_row(2, std::numeric_limits<double>::quiet_NaN(), "b");
+    table.append_row(3, -1.0, "a");
+    table.append_row(3, 7.0, "c");
+
+    auto stats = compute_statistics(table, 2);
+    EXPECT_EQ(stats.rows, 4u);
+
+    const auto* id = stats.find("id");
+    ASSERT_NE(id, nullptr);
+    EXPECT_EQ(*id->min, 1.0);
+    EXPECT_EQ(*id->max, 3.0);
+    EXPECT_DOUBLE_EQ(id->distinct, 3.0);
+    ASSERT_EQ(id->histogram.size(), 2u);
+    EXPECT_EQ(id->histogram[1].count, 2u);  // both 3s land in one bucket
+
+    const auto* reading = stats.find("reading");
+    EXPECT_EQ(reading->null_count, 1u);
+    EXPECT_EQ(*reading->min, -1.0);
+
+    const auto* site = stats.find("site");
+    EXPECT_TRUE(site->is_string);
+    EXPECT_NEAR(site->distinct, 3.0, 0.5);
+    EXPECT_EQ(stats.find("missing"), nullptr);
+}
+
+TEST(StatisticsTest, EstimatesSelectivity) {
+    const auto table = make_sensors(20000);
+    const auto stats = compute_statistics(table);
+
+    const std::vector<Comparison> predicates{
+        {"reading", CompareOp::Less, 40.0},
+        {"reading", CompareOp::GreaterEqual, 65.0},
+        {"id", CompareOp::LessEqual, int64_t{999}},
+        {"id", CompareOp::Equal, int64_t{42}},
+        {"id", CompareOp::Greater, int64_t{50000}},
+        {"site", CompareOp::Equal, std::string("site7")},
+        {"site", CompareOp::NotEqual, std::string("site7")},
+    };
+    for (const auto& predicate : predicates) {
+        EXPECT_NEAR(estimate_selectivity(stats, predicate), actual_selectivity(table, predicate), 0.02)
+            << predicate.column << " op " << static_cast<int>(predicate.op);
+    }
+    EXPECT_DOUBLE_EQ(estimate_selectivity(stats, {"missing", CompareOp::Equal, 1.0}), 1.0);
+}
+
+TEST(StatisticsTest, OrdersMostSelectivePredicateFirst) {
+    const auto table = make_sensors(20000);
+    const auto stats = compute_statistics(table);
+
+    const std::vector<Comparison> where{
+        {"reading", CompareOp::Greater, 0.0},               // keeps nearly everything
+        {"site", CompareOp::NotEqual, std::string("site3")}, // keeps 95%, expensive
+        {"id", CompareOp::Less, int64_t{100}},               // keeps 0.5%
+        {"reading", CompareOp::Less, 45.0},                 // keeps ~30%
+    };
+    auto ordered = order_predicates(stats, where);
+    ASSERT_EQ(ordered.size(), 4u);
+    EXPECT_EQ(ordered[0].column, "id");
+    EXPECT_EQ(ordered[1].column, "reading");
+    EXPECT_EQ(ordered[1].op, CompareOp::Less);
+    EXPECT_EQ(ordered[3].op, CompareOp::Greater);
+
+    auto planned = select_rows(table, where, stats);
+    auto unplanned = select_rows(table, where);
+    ASSERT_TRUE(planned.has_value());
+    EXPECT_EQ(planned->to_indices(), unplanned->to_indices());
+}
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include "columnar/streaming.h"
+
+#include <cmath>
+
+using namespace columnar;
+
+namespace {
+
+using ParticleTable = Columnar<int, double, double, double, double>;
+
+// Sum of transverse momentum and the rows that produced it.
+struct TransverseMomentum {
+    double sum = 0.0;
+    std::vector<int> ids;
+
+    void add(const int& id, const double& px, const double& py, const double&, const double&) {
+        sum += std::hypot(px, py);
+        ids.push_back(id);
+    }
+
+    void merge(const TransverseMomentum& other) {
+        sum += other.sum;
+        ids.insert(ids.end(), other.ids.begin(), other.ids.end());
+    }
+};
+
+static_assert(RowAggregator<TransverseMomentum, int, double, double, double, double>);
+static_assert(!RowAggregator<TransverseMomentum, int, double>);
+
+}
+
+TEST(StreamingAggregateTest, MatchesMaterializedTable) {
+    auto table = ParticleTable::try_read_from_csv("data/particles.csv");
+    ASSERT_TRUE(table.has_value());
+    const auto energy = table->get_column_view<4>();
+    PartialAggregate expected;
+    for (double value : energy) {
+        expected.add(value);
+    }
+    ThreadPool pool(3);
+
+    for (size_t parts : {1u, 2u, 7u, 64u}) {
+        auto stats = try_aggregate_csv_column<int, double, double, double, double>("data/particles.csv", pool,
+                                                                                    "energy", parts);
+        ASSERT_TRUE(stats.has_value()) << "parts = " << parts;
+        EXPECT_EQ(stats->count, expected.count);
+        EXPECT_NEAR(stats->sum, expected.sum, 1e-9);
+        EXPECT_EQ(stats->min, expected.min);
+        EXPECT_EQ(stats->max, expected.max);
+
+        auto pt = try_aggregate_csv<int, double, double, double, double>("data/particles.csv", pool,
+                                                                         TransverseMomentum{}, parts);
+        ASSERT_TRUE(pt.has_value());
+        // Merged in file order.
+        const auto ids = table->get_column_view<0>();
+        EXPECT_TRUE(std::equal(pt->ids.begin(), pt->ids.end(), ids.begin(), ids.end()));
+    }
+}
+
+TEST(StreamingAggregateTest, ReportsErrors) {
+    ThreadPool pool(2);
+
+    auto missing = try_aggregate_csv_column<int, int>("nonexistent.csv", pool, "a");
+    EXPECT_EQ(missing.error(), CsvError::FileNotFound);
+
+    auto no_column = try_aggregate_csv_column<int, double, double, double, double>("data/particles.csv", pool, "mass");
+    EXPECT_EQ(no_column.error(), CsvError::ColumnNotFound);
+
+    auto wrong_types = try_aggregate_csv_column<int, int, int>("data/mixed_types.csv", pool, "int_col");
+    EXPECT_EQ(wrong_types.error(), CsvError::ParseError);
+
+    auto strings = try_aggregate_csv_column<int, double, std::string>("data/mixed_types.csv", pool, "float_col");
+    EXPECT_EQ(strings.error(), CsvError::ParseError);
+}
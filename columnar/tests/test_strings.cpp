@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include "columnar/adaptive.h"
+#include "columnar/wire.h"
+
+#include <random>
+
+using namespace columnar;
+
+namespace {
+
+using SymbolTable = Columnar<int64_t, std::string>;
+
+SymbolTable make_symbols(size_t rows) {
+    static const char* const kVenues[] = {"XNAS", "XNYS", "ARCX", "BATS", "IEXG"};
+    SymbolTable table({"id", "symbol"});
+    std::mt19937_64 rng(11);
+    std::uniform_int_distribution<int> letter('A', 'Z');
+    std::uniform_int_distribution<size_t> length(0, 70);
+    for (size_t i = 0; i < rows; ++i) {
+        std::string symbol;
+        for (size_t n = length(rng); n > 0; --n) {
+            symbol += static_cast<char>(letter(rng));
+        }
+        symbol += kVenues[i % 5];
+        table.append_row(static_cast<int64_t>(i), std::move(symbol));
+    }
+    return table;
+}
+
+}
+
+TEST(StringKernelTest, FindBytesAcrossBlockBoundaries) {
+    std::string haystack(200, 'a');
+    for (size_t position : {0u, 1u, 15u, 16u, 31u, 32u, 33u, 63u, 100u, 190u, 196u}) {
+        for (std::string needle : {"b", "bc", "bcd", "bcdefghijklmnopqrstuvwxyz"}) {
+            if (position + needle.size() > haystack.size()) {
+                continue;
+            }
+            std::string text = haystack;
+            text.replace(position, needle.size(), needle);
+            EXPECT_EQ(detail::find_bytes(text, needle), text.find(needle)) << position << " " << needle;
+            EXPECT_EQ(detail::find_bytes(text, needle, position + 1), text.find(needle, position + 1));
+        }
+    }
+    // First and last bytes match everywhere, only the middle differs.
+    EXPECT_FALSE(detail::contains_bytes(std::string(100, 'a'), "aba"));
+    EXPECT_TRUE(detail::contains_bytes(std::string(100, 'a') + "aba", "aba"));
+    EXPECT_TRUE(detail::contains_bytes("anything", ""));
+    EXPECT_FALSE(detail::contains_bytes("ab", "abc"));
+}
+
+TEST(StringKernelTest, LikePatterns) {
+    EXPECT_TRUE(LikePattern("%").matches(""));
+    EXPECT_TRUE(LikePattern("").matches(""));
+    EXPECT_FALSE(LikePattern("").matches("a"));
+    EXPECT_TRUE(LikePattern("abc").matches("abc"));
+    EXPECT_FALSE(LikePattern("abc").matches("abcd"));
+    EXPECT_TRUE(LikePattern("ab%").matches("abxyz"));
+    EXPECT_TRUE(LikePattern("%yz").matches("abxyz"));
+    EXPECT_FALSE(LikePattern("%yz").matches("abxy"));
+    EXPECT_TRUE(LikePattern("a%b%c").matches("a__b__c"));
+    EXPECT_TRUE(LikePattern("a%b%c").matches("abc"));
+    EXPECT_FALSE(LikePattern("a%b%c").matches("acb"));
+    EXPECT_FALSE(LikePattern("a%a").matches("a"));
+    EXPECT_TRUE(LikePattern("a_c").matches("abc"));
+    EXPECT_FALSE(LikePattern("a_c").matches("ac"));
+    EXPECT_TRUE(LikePattern("%b_d%").matches("xxbcdxx"));
+    EXPECT_TRUE(LikePattern("%b_d%").matches("bxbcd"));
+    EXPECT_TRUE(LikePattern("%x%x%").matches("axbxc"));
+    EXPECT_FALSE(LikePattern("%x%x%").matches("axbc"));
+    EXPECT_TRUE(LikePattern("100\\%").matches("100%"));
+    EXPECT_FALSE(LikePattern("100\\%").matches("1000"));
+    EXPECT_TRUE(LikePattern("a\\_b").matches("a_b"));
+    EXPECT_FALSE(LikePattern("a\\_b").matches("axb"));
+}
+
+TEST(StringPredicateTest, MatchesBruteForce) {
+    const auto table = make_symbols(5000);
+    const auto symbols = table.get_column_view<1>();
+
+    struct Case {
+        Comparison comparison;
+        bool (*expected)(const std::string&);
+    };
+    const std::vector<Case> cases{
+        {{"symbol", CompareOp::StartsWith, std::string("Q")}, [](const std::string& s) { return s.starts_with("Q"); }},
+        {{"symbol", CompareOp::EndsWith, std::string("XNAS")},
+         [](const std::string& s) { return s.ends_with("XNAS"); }},
+        {{"symbol", CompareOp::Contains, std::string("AB")},
+         [](const std::string& s) { return s.find("AB") != std::string::npos; }},
+        {{"symbol", CompareOp::Like, std::string("%A_B%XNYS")},
+         [](const std::string& s) {
+             if (!s.ends_with("XNYS")) {
+                 return false;
+             }
+             for (size_t i = 0; i + 3 <= s.size() - 4; ++i) {
+                 if (s[i] == 'A' && s[i + 2] == 'B') {
+                     return true;
+                 }
+             }
+             return false;
+         }},
+    };
+
+    for (const auto& [comparison, expected] : cases) {
+        std::vector<size_t> brute;
+        for (size_t i = 0; i < symbols.size(); ++i) {
+            if (expected(symbols[i])) {
+                brute.push_back(i);
+            }
+        }
+        ASSERT_FALSE(brute.empty());
+
+        const std::vector<Comparison> where{comparison};
+        auto selected = select_rows(table, where);
+        ASSERT_TRUE(selected.has_value());
+        EXPECT_EQ(selected->to_indices(), brute);
+
+        auto adaptive = select_rows_adaptive(table, where, {256, 2, 4, 0.5});
+        ASSERT_TRUE(adaptive.has_value());
+        EXPECT_EQ(adaptive->to_indices(), brute);
+    }
+}
+
+TEST(StringPredicateTest, RejectsNumericColumnsAndRoundTrips) {
+    const auto table = make_symbols(10);
+    const std::vector<Comparison> numeric{{"id", CompareOp::Contains, std::string("1")}};
+    auto rejected = select_rows(table, numeric);
+    ASSERT_FALSE(rejected.has_value());
+    EXPECT_EQ(rejected.error(), CsvError::ParseError);
+
+    const std::vector<Comparison> wrong_value{{"symbol", CompareOp::Like, int64_t{1}}};
+    EXPECT_FALSE(select_rows(table, wrong_value).has_value());
+
+    QueryRequest request{"symbols", {{"symbol", CompareOp::Like, std::string("A%")}}, {"id"}, {}, 0};
+    std::string frame;
+    encode(request, frame);
+    auto decoded = try_decode_request(frame);
+    ASSERT_TRUE(decoded.has_value());
+    EXPECT_EQ(decoded->where[0].op, CompareOp::Like);
+}